@@ -6,6 +6,7 @@ INCLUDE(${CMAKE_ROOT}/Modules/CheckFunctionExists.cmake)
 INCLUDE(${CMAKE_ROOT}/Modules/CheckCXXSourceCompiles.cmake)
 INCLUDE(${CMAKE_ROOT}/Modules/TestBigEndian.cmake)
 INCLUDE(${CMAKE_ROOT}/Modules/CheckSymbolExists.cmake)
+INCLUDE(${CMAKE_ROOT}/Modules/CheckLibraryExists.cmake)
 
 # check the size of primitive types
 CHECK_TYPE_SIZE("long" SIZEOF_LONG)
@@ -28,3 +29,6 @@ CHECK_INCLUDE_FILE("asm/atomic.h" HAVE_ASM_ATOMIC_H)
 
 # CHECK_INCLUDE_FILE("sys/prctl.h" HAVE_SYS_PRCTL_H)
 # CHECK_FUNCTION_EXISTS("prctl" HAVE_PRCTL)
+
+# check for libraries: shm_open in librt before glibc 2.34
+CHECK_LIBRARY_EXISTS(rt shm_open "" HAVE_LIBRT)
@@ -0,0 +1,66 @@
+#include <xlog/xlog.h>
+#include <xlog/xlog_helper.h>
+
+static xlog_printer_t *g_printer = NULL;
+static xlog_module_t *g_mod = NULL;
+#undef XLOG_PRINTER
+#define XLOG_PRINTER	g_printer
+#define XLOG_MODULE		g_mod
+
+static double elapsed_ns( const struct timespec *st, const struct timespec *et )
+{
+	return ( double )( et->tv_sec - st->tv_sec ) * 1e9 + ( double )( et->tv_nsec - st->tv_nsec );
+}
+
+int main( int argc, char **argv )
+{
+	( void )argc;
+	( void )argv;
+	
+	g_mod = xlog_module_open( "/bench/deferred", XLOG_LEVEL_VERBOSE, NULL );
+	
+	unsigned int count_limit = 100000;
+	
+	unsigned int index = 0;
+	struct {
+		const char *brief;
+		int options;
+		const char *file;
+		double ns_per_line;
+	} bench_result[] = {
+		{ "FILES_BASIC+RINGBUF", XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF, "./logs/bench-ringbuf.txt", 0 },
+		{ "FILES_BASIC+DEFERRED", XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_DEFERRED, "./logs/bench-deferred.txt", 0 },
+	};
+	
+	// time spent by the producer only, burst fits in ring-buffer, consumer formats/writes on its own thread
+	for( index = 0; index < XLOG_ARRAY_SIZE( bench_result ); index ++ ) {
+		g_printer = xlog_printer_create( bench_result[index].options, bench_result[index].file, ( size_t )( 1024 * 1024 * 64 ) );
+		if( g_printer == NULL ) {
+			fprintf( stderr, "Failed to create printer %s.\n", bench_result[index].brief );
+			return EXIT_FAILURE;
+		}
+		
+		struct timespec st, et;
+		clock_gettime( CLOCK_MONOTONIC, &st );
+		for( unsigned int i = 0; i < count_limit; i ++ ) {
+			log_i( "request %u: status=%d latency=%.3fms bytes=%zu ratio=%5.2f%%", i, ( int )( i % 7 ), i * 0.001, ( size_t )i * 64, ( i % 100 ) * 1.0 );
+		}
+		clock_gettime( CLOCK_MONOTONIC, &et );
+		bench_result[index].ns_per_line = elapsed_ns( &st, &et ) / count_limit;
+		
+		xlog_printer_destory( g_printer );
+		g_printer = NULL;
+		fprintf( stderr, "End of %s\n", bench_result[index].brief );
+	}
+	
+	for( int i = 0; i < index; i ++ ) {
+		fprintf(
+			stderr, "%24s: %8.2f ns/line(%.3f)\n",
+			bench_result[i].brief, bench_result[i].ns_per_line,
+			bench_result[i].ns_per_line / bench_result[0].ns_per_line
+		);
+	}
+	xlog_module_close( g_mod );
+	
+	return 0;
+}
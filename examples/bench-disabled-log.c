@@ -0,0 +1,103 @@
+#include <xlog/xlog.h>
+#include <xlog/xlog_helper.h>
+
+static xlog_module_t *g_mod = NULL;
+#define XLOG_MODULE g_mod
+
+static unsigned int evaluated = 0;
+
+static const char *expensive_argument( void )
+{
+	evaluated ++;
+	return "expensive";
+}
+
+static double elapsed_ns( const struct timespec *st, const struct timespec *et )
+{
+	return ( double )( et->tv_sec - st->tv_sec ) * 1e9 + ( double )( et->tv_nsec - st->tv_nsec );
+}
+
+int main( int argc, char **argv )
+{
+	( void )argc;
+	( void )argv;
+	
+	g_mod = xlog_module_open( "/bench/disabled", XLOG_LEVEL_ERROR, NULL );
+	
+	unsigned int count_limit = 10000000;
+	
+	unsigned int index = 0;
+	struct {
+		const char *brief;
+		double ns_per_line;
+		unsigned int evaluated;
+	} bench_result[4];
+	
+	// BASE: call into library, drop after resolving context/stats/level
+	{
+		evaluated = 0;
+		struct timespec st, et;
+		clock_gettime( CLOCK_MONOTONIC, &st );
+		for( unsigned int i = 0; i < count_limit; i ++ ) {
+			xlog_output_fmtlog( NULL, g_mod, XLOG_LEVEL_DEBUG, __FILE__, __func__, __LINE__, "%s %u", expensive_argument(), i );
+		}
+		clock_gettime( CLOCK_MONOTONIC, &et );
+		
+		bench_result[index].brief = "BASE";
+		bench_result[index].ns_per_line = elapsed_ns( &st, &et ) / count_limit;
+		bench_result[index].evaluated = evaluated;
+		index ++;
+	}
+	fprintf( stderr, "End of BASE\n" );
+	
+	// MACRO: log_d, dropped before evaluating arguments if XLOG_FEATURE_ENABLE_FAST_FILTER
+	{
+		evaluated = 0;
+		struct timespec st, et;
+		clock_gettime( CLOCK_MONOTONIC, &st );
+		for( unsigned int i = 0; i < count_limit; i ++ ) {
+			log_d( "%s %u", expensive_argument(), i );
+		}
+		clock_gettime( CLOCK_MONOTONIC, &et );
+		
+		bench_result[index].brief = "MACRO";
+		bench_result[index].ns_per_line = elapsed_ns( &st, &et ) / count_limit;
+		bench_result[index].evaluated = evaluated;
+		index ++;
+	}
+	fprintf( stderr, "End of MACRO\n" );
+	
+	// MACRO-CHANGED: level of parent changed once before each batch, refresh cached limit
+	{
+		xlog_module_t *parent = xlog_module_lookup( NULL, "/bench" );
+		evaluated = 0;
+		struct timespec st, et;
+		clock_gettime( CLOCK_MONOTONIC, &st );
+		for( unsigned int i = 0; i < count_limit; i ++ ) {
+			if( i % 1000 == 0 ) {
+				xlog_module_set_level( parent, ( i / 1000 ) % 2 ? XLOG_LEVEL_WARN : XLOG_LEVEL_INFO, 0 );
+			}
+			log_d( "%s %u", expensive_argument(), i );
+		}
+		clock_gettime( CLOCK_MONOTONIC, &et );
+		
+		bench_result[index].brief = "MACRO-CHANGED";
+		bench_result[index].ns_per_line = elapsed_ns( &st, &et ) / count_limit;
+		bench_result[index].evaluated = evaluated;
+		index ++;
+	}
+	fprintf( stderr, "End of MACRO-CHANGED\n" );
+	
+	for( int i = 0; i < index; i ++ ) {
+		fprintf(
+			stderr, "%24s: %8.2f ns/line(%.3f), arguments evaluated %u times\n",
+			bench_result[i].brief, bench_result[i].ns_per_line,
+			bench_result[i].ns_per_line / bench_result[0].ns_per_line,
+			bench_result[i].evaluated
+		);
+	}
+	
+	xlog_module_close( g_mod );
+	
+	return 0;
+}
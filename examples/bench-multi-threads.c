@@ -268,6 +268,38 @@ int main( int argc, char **argv )
 			g_printer = NULL;
 		}
 		fprintf(stderr, "End of RINGBUF-FILE-DAILY\n" );
+		
+		{
+			g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | XLOG_PRINTER_OPERTHREAD, "./logs/ringbuf-file-perthread.txt", 1024 * 1024 );
+			XLOG_ASSERT( g_printer );
+			bench_param_t param = {
+				.brief = "RINGBUF-FILE-PERTHREAD",
+				.printer = g_printer,
+				.time_limit = time_limit,
+				.count_limit = count_limit,
+				.fp = fp,
+			};
+			xlog_test_multi_thread( nthread, &param );
+			xlog_printer_destory( g_printer );
+			g_printer = NULL;
+		}
+		fprintf(stderr, "End of RINGBUF-FILE-PERTHREAD\n" );
+		
+		{
+			g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | XLOG_PRINTER_OORDERED, "./logs/ringbuf-file-ordered.txt", 1024 * 1024 );
+			XLOG_ASSERT( g_printer );
+			bench_param_t param = {
+				.brief = "RINGBUF-FILE-ORDERED",
+				.printer = g_printer,
+				.time_limit = time_limit,
+				.count_limit = count_limit,
+				.fp = fp,
+			};
+			xlog_test_multi_thread( nthread, &param );
+			xlog_printer_destory( g_printer );
+			g_printer = NULL;
+		}
+		fprintf(stderr, "End of RINGBUF-FILE-ORDERED\n" );
 	}
 	
 	// NOTE: no-copying buffering printers
@@ -45,7 +45,7 @@ int main( int argc, char **argv )
 	struct {
 		const char *brief;
 		unsigned int count;
-	} bench_result[20];
+	} bench_result[32];
 	
 	char buffer[BENCH_BUFFER_SIZE];
 	for( int i = 0; i < sizeof( buffer ); ++ i ) {
@@ -176,6 +176,57 @@ int main( int argc, char **argv )
 			index ++;
 		}
 		fprintf(stderr, "End of FILE-DAILY\n" );
+		
+		{
+			g_printer = xlog_printer_create( XLOG_PRINTER_FILES_MAPPED, "./logs/mapped-file.bin", ( size_t )( 1024 * 1024 * 8 ) );
+			time_t st = time( NULL );
+			unsigned int i = 0;
+			while( time( NULL ) - st < time_limit && i < count_limit ) {
+				log_w( "%s", buffer );
+				i ++;
+			}
+			xlog_printer_destory( g_printer );
+			g_printer = NULL;
+			
+			bench_result[index].brief = "FILE-MAPPED";
+			bench_result[index].count = i / time_limit;
+			index ++;
+		}
+		fprintf(stderr, "End of FILE-MAPPED\n" );
+		
+		{
+			g_printer = xlog_printer_create( XLOG_PRINTER_FILES_ROTATING | XLOG_PRINTER_OCOALESCE, "./logs/file-rotating-coalesce.txt", 1024 * 8, 16, ( size_t )( 64 * 1024 ), 100 );
+			time_t st = time( NULL );
+			unsigned int i = 0;
+			while( time( NULL ) - st < time_limit && i < count_limit ) {
+				log_w( "%s", buffer );
+				i ++;
+			}
+			xlog_printer_destory( g_printer );
+			g_printer = NULL;
+			
+			bench_result[index].brief = "FILE-ROTATE-COALESCE";
+			bench_result[index].count = i / time_limit;
+			index ++;
+		}
+		fprintf(stderr, "End of FILE-ROTATE-COALESCE\n" );
+		
+		{
+			g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_OCOALESCE, "./logs/basic-file-coalesce.txt", ( size_t )( 64 * 1024 ), 100 );
+			time_t st = time( NULL );
+			unsigned int i = 0;
+			while( time( NULL ) - st < time_limit && i < count_limit ) {
+				log_w( "%s", buffer );
+				i ++;
+			}
+			xlog_printer_destory( g_printer );
+			g_printer = NULL;
+			
+			bench_result[index].brief = "FILE-BASIC-COALESCE";
+			bench_result[index].count = i / time_limit;
+			index ++;
+		}
+		fprintf(stderr, "End of FILE-BASIC-COALESCE\n" );
 	}
 	
 	// NOTE: printers with ring-buffer
@@ -0,0 +1,185 @@
+#include <xlog/xlog.h>
+#include <xlog/xlog_helper.h>
+#include <xlog/plugins/ringbuf.h>
+
+#define BENCH_RECORD_SIZE	128
+#define BENCH_RING_SIZE		( 64 * 1024 * 1024 )	/* burst fits in ring-buffer, producers are measured */
+
+typedef struct {
+	ringbuf_t *rbuff;
+	xlog_printer_t *printer;
+	unsigned int count_limit;
+	bool done;
+	uint64_t consumed;
+} bench_param_t;
+
+static double elapsed_ns( const struct timespec *st, const struct timespec *et )
+{
+	return ( double )( et->tv_sec - st->tv_sec ) * 1e9 + ( double )( et->tv_nsec - st->tv_nsec );
+}
+
+static void *bench_producer( void *arg )
+{
+	bench_param_t *param = ( bench_param_t * )arg;
+	char record[BENCH_RECORD_SIZE];
+	memset( record, 'x', sizeof( record ) );
+	record[BENCH_RECORD_SIZE - 1] = '\n';
+	for( unsigned int i = 0; i < param->count_limit; i ++ ) {
+		ringbuf_copy_into( param->rbuff, record, sizeof( record ) );
+	}
+
+	return NULL;
+}
+
+static void *bench_consumer( void *arg )
+{
+	bench_param_t *param = ( bench_param_t * )arg;
+	static char buffer[64 * 1024];
+	while( true ) {
+		bool done = __atomic_load_n( &param->done, __ATOMIC_ACQUIRE );
+		int length = ringbuf_copy_from( param->rbuff, buffer, sizeof( buffer ), true );
+		if( length > 0 ) {
+			param->consumed += length;
+		} else if( done ) {
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static void *bench_logger( void *arg )
+{
+	bench_param_t *param = ( bench_param_t * )arg;
+	for( unsigned int i = 0; i < param->count_limit; i ++ ) {
+		xlog_output_fmtlog( param->printer, NULL, XLOG_LEVEL_INFO, __FILE__, __func__, __LINE__, "index = %u, lorem ipsum dolor sit amet.", i );
+	}
+
+	return NULL;
+}
+
+/** producers append fixed-size records concurrently, one consumer drains the ring-buffer */
+static double bench_ring( int options, unsigned int nthread, unsigned int count_limit )
+{
+	bench_param_t param = {
+		.rbuff = ringbuf_create_ex( BENCH_RING_SIZE, options ),
+		.count_limit = count_limit,
+		.done = false,
+		.consumed = 0,
+	};
+	XLOG_ASSERT( param.rbuff );
+	pthread_t consumer, *producers = ( pthread_t * )alloca( sizeof( pthread_t ) * nthread );
+
+	struct timespec st, et;
+	clock_gettime( CLOCK_MONOTONIC, &st );
+	pthread_create( &consumer, NULL, bench_consumer, &param );
+	for( unsigned int i = 0; i < nthread; i ++ ) {
+		pthread_create( producers + i, NULL, bench_producer, &param );
+	}
+	for( unsigned int i = 0; i < nthread; i ++ ) {
+		pthread_join( producers[i], NULL );
+	}
+	clock_gettime( CLOCK_MONOTONIC, &et );
+	__atomic_store_n( &param.done, true, __ATOMIC_RELEASE );
+	pthread_join( consumer, NULL );
+
+	ringbuf_destory( param.rbuff );
+	if( param.consumed != ( uint64_t )BENCH_RECORD_SIZE * count_limit * nthread ) {
+		fprintf( stderr, "Records lost: %llu/%llu bytes.\n",
+			( unsigned long long )param.consumed, ( unsigned long long )BENCH_RECORD_SIZE * count_limit * nthread
+		);
+		return -1;
+	}
+
+	return ( double )count_limit * nthread * 1e3 / elapsed_ns( &st, &et );
+}
+
+/** threads log via buffering printer, measured until logging returned */
+static double bench_printer( int options, unsigned int nthread, unsigned int count_limit )
+{
+	bench_param_t param = {
+		.printer = xlog_printer_create( options, "./logs/bench-ringbuf-threads.txt", BENCH_RING_SIZE ),
+		.count_limit = count_limit,
+	};
+	XLOG_ASSERT( param.printer );
+	pthread_t *producers = ( pthread_t * )alloca( sizeof( pthread_t ) * nthread );
+
+	struct timespec st, et;
+	clock_gettime( CLOCK_MONOTONIC, &st );
+	for( unsigned int i = 0; i < nthread; i ++ ) {
+		pthread_create( producers + i, NULL, bench_logger, &param );
+	}
+	for( unsigned int i = 0; i < nthread; i ++ ) {
+		pthread_join( producers[i], NULL );
+	}
+	clock_gettime( CLOCK_MONOTONIC, &et );
+	xlog_printer_destory( param.printer );
+
+	return ( double )count_limit * nthread * 1e3 / elapsed_ns( &st, &et );
+}
+
+/** CPU usage of process while consumer of printer is idle */
+static double bench_idle( int options, unsigned int idle_ms )
+{
+	xlog_printer_t *printer = xlog_printer_create( options, "./logs/bench-ringbuf-threads.txt", BENCH_RING_SIZE );
+	XLOG_ASSERT( printer );
+	xlog_output_fmtlog( printer, NULL, XLOG_LEVEL_INFO, __FILE__, __func__, __LINE__, "wake up consumer." );
+	usleep( 10 * 1000 );
+
+	struct timespec st, et, cst, cet;
+	clock_gettime( CLOCK_MONOTONIC, &st );
+	clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &cst );
+	usleep( idle_ms * 1000 );
+	clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &cet );
+	clock_gettime( CLOCK_MONOTONIC, &et );
+	xlog_printer_destory( printer );
+
+	return elapsed_ns( &cst, &cet ) * 100 / elapsed_ns( &st, &et );
+}
+
+int main( int argc, char **argv )
+{
+	( void )argc;
+	( void )argv;
+
+	static const unsigned int threads[] = { 1, 2, 4, 8, 16 };
+	unsigned int count_limit = 200000;
+	int status = EXIT_SUCCESS;
+
+	fprintf( stderr, "%-24s %8s %16s %16s %8s\n", "ring-buffer", "threads", "MUTEX(Mrec/s)", "LOCKFREE(Mrec/s)", "ratio" );
+	for( size_t i = 0; i < sizeof( threads ) / sizeof( threads[0] ); i ++ ) {
+		double mutex = bench_ring( 0, threads[i], count_limit / threads[i] );
+		double lockfree = bench_ring( RINGBUF_OLOCKFREE, threads[i], count_limit / threads[i] );
+		if( mutex < 0 || lockfree < 0 ) {
+			status = EXIT_FAILURE;
+		}
+		fprintf( stderr, "%-24s %8u %16.2f %16.2f %8.2f\n", "copy-into", threads[i], mutex, lockfree, lockfree / mutex );
+	}
+
+	count_limit = 50000;
+	for( size_t i = 0; i < sizeof( threads ) / sizeof( threads[0] ); i ++ ) {
+		double mutex = bench_printer( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF, threads[i], count_limit / threads[i] );
+		double lockfree = bench_printer( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | XLOG_PRINTER_OLOCKFREE, threads[i], count_limit / threads[i] );
+		fprintf( stderr, "%-24s %8u %16.2f %16.2f %8.2f\n", "FILES_BASIC+RINGBUF", threads[i], mutex, lockfree, lockfree / mutex );
+	}
+
+	fprintf( stderr, "%-24s %8s %16s %16s %8s\n", "per-thread", "threads", "LOCKFREE(Mrec/s)", "PERTHREAD(Mrec/s)", "ratio" );
+	for( size_t i = 0; i < sizeof( threads ) / sizeof( threads[0] ); i ++ ) {
+		double lockfree = bench_printer( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | XLOG_PRINTER_OLOCKFREE, threads[i], count_limit / threads[i] );
+		double perthread = bench_printer( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | XLOG_PRINTER_OPERTHREAD, threads[i], count_limit / threads[i] );
+		double ordered = bench_printer( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | XLOG_PRINTER_OORDERED, threads[i], count_limit / threads[i] );
+		fprintf( stderr, "%-24s %8u %16.2f %16.2f %8.2f\n", "FILES_BASIC+PERTHREAD", threads[i], lockfree, perthread, perthread / lockfree );
+		fprintf( stderr, "%-24s %8u %16.2f %16.2f %8.2f\n", "FILES_BASIC+ORDERED", threads[i], lockfree, ordered, ordered / lockfree );
+	}
+	
+	fprintf( stderr, "%-24s %8s %16.2f %16.2f   CPU%% while idle\n", "FILES_BASIC+RINGBUF", "-",
+		bench_idle( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF, 500 ),
+		bench_idle( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | XLOG_PRINTER_OLOCKFREE, 500 )
+	);
+	fprintf( stderr, "%-24s %8s %16.2f %16.2f   CPU%% while idle\n", "FILES_BASIC+PERTHREAD", "-",
+		bench_idle( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | XLOG_PRINTER_OPERTHREAD, 500 ),
+		bench_idle( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | XLOG_PRINTER_OORDERED, 500 )
+	);
+
+	return status;
+}
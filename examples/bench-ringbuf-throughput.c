@@ -0,0 +1,158 @@
+#include <xlog/xlog.h>
+#include <xlog/xlog_helper.h>
+#include <xlog/plugins/ringbuf.h>
+
+#define BENCH_RING_SIZE		( 4 * 1024 * 1024 )
+#define BENCH_TOTAL_BYTES	( 256ULL * 1024 * 1024 )
+#define BENCH_BURST_RING	( 64 * 1024 * 1024 )
+#define BENCH_BURST_RECORD	256
+
+typedef struct {
+	ringbuf_t *rbuff;
+	unsigned int record_size;
+	uint64_t count_limit;
+	bool done;
+	uint64_t consumed;
+} bench_param_t;
+
+static double elapsed_ns( const struct timespec *st, const struct timespec *et )
+{
+	return ( double )( et->tv_sec - st->tv_sec ) * 1e9 + ( double )( et->tv_nsec - st->tv_nsec );
+}
+
+static void *bench_producer( void *arg )
+{
+	bench_param_t *param = ( bench_param_t * )arg;
+	char *record = ( char * )alloca( param->record_size );
+	memset( record, 'x', param->record_size );
+	for( uint64_t i = 0; i < param->count_limit; i ++ ) {
+		ringbuf_copy_into( param->rbuff, record, param->record_size );
+	}
+	__atomic_store_n( &param->done, true, __ATOMIC_RELEASE );
+
+	return NULL;
+}
+
+static void *bench_consumer( void *arg )
+{
+	bench_param_t *param = ( bench_param_t * )arg;
+	static char buffer[64 * 1024];
+	while( true ) {
+		bool done = __atomic_load_n( &param->done, __ATOMIC_ACQUIRE );
+		int length = ringbuf_copy_from( param->rbuff, buffer, sizeof( buffer ), true );
+		if( length > 0 ) {
+			param->consumed += length;
+		} else if( done ) {
+			break;
+		} else {
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+/** single producer copies records, single consumer drains, measured until all consumed */
+static double bench_ring( int options, unsigned int record_size )
+{
+	bench_param_t param = {
+		/* NOTE: same size of ring for both, one byte kept empty if NOT RINGBUF_OPOW2 */
+		.rbuff = ringbuf_create_ex( BENCH_RING_SIZE - 1, options ),
+		.record_size = record_size,
+		.count_limit = BENCH_TOTAL_BYTES / record_size,
+		.done = false,
+		.consumed = 0,
+	};
+	XLOG_ASSERT( param.rbuff );
+	pthread_t producer, consumer;
+
+	struct timespec st, et;
+	clock_gettime( CLOCK_MONOTONIC, &st );
+	pthread_create( &consumer, NULL, bench_consumer, &param );
+	pthread_create( &producer, NULL, bench_producer, &param );
+	pthread_join( producer, NULL );
+	pthread_join( consumer, NULL );
+	clock_gettime( CLOCK_MONOTONIC, &et );
+
+	ringbuf_destory( param.rbuff );
+	if( param.consumed != param.count_limit * record_size ) {
+		fprintf( stderr, "Bytes lost: %llu/%llu.\n",
+			( unsigned long long )param.consumed, ( unsigned long long )( param.count_limit * record_size )
+		);
+		return -1;
+	}
+
+	return ( double )param.consumed / elapsed_ns( &st, &et );
+}
+
+/** first burst into a ring-buffer just created, no consumer, latency of the slowest record */
+static double bench_burst( int options, double *max_us )
+{
+	ringbuf_t *rbuff = ringbuf_create_ex( BENCH_BURST_RING, options );
+	XLOG_ASSERT( rbuff );
+	char record[BENCH_BURST_RECORD];
+	memset( record, 'x', sizeof( record ) );
+
+	double slowest = 0;
+	struct timespec st, et, rst, ret;
+	clock_gettime( CLOCK_MONOTONIC, &st );
+	for( unsigned int i = 0; i < BENCH_BURST_RING / 2 / BENCH_BURST_RECORD; i ++ ) {
+		clock_gettime( CLOCK_MONOTONIC, &rst );
+		ringbuf_copy_into( rbuff, record, sizeof( record ) );
+		clock_gettime( CLOCK_MONOTONIC, &ret );
+		double ns = elapsed_ns( &rst, &ret );
+		slowest = ns > slowest ? ns : slowest;
+	}
+	clock_gettime( CLOCK_MONOTONIC, &et );
+	ringbuf_destory( rbuff );
+	*max_us = slowest / 1e3;
+
+	return elapsed_ns( &st, &et ) / 1e6;
+}
+
+int main( int argc, char **argv )
+{
+	( void )argc;
+	( void )argv;
+
+	static const unsigned int record_sizes[] = { 64, 256, 1024, 4096 };
+	static const struct {
+		const char *brief;
+		int options;
+	} rings[] = {
+		{ "MUTEX", 0 },
+		{ "MUTEX+POW2", RINGBUF_OPOW2 },
+		{ "LOCKFREE", RINGBUF_OLOCKFREE },
+		{ "LOCKFREE+POW2", RINGBUF_OLOCKFREE | RINGBUF_OPOW2 },
+	};
+	int status = EXIT_SUCCESS;
+
+	fprintf( stderr, "%-24s %12s %12s\n", "ring-buffer", "record", "GB/s" );
+	for( size_t i = 0; i < sizeof( rings ) / sizeof( rings[0] ); i ++ ) {
+		for( size_t j = 0; j < sizeof( record_sizes ) / sizeof( record_sizes[0] ); j ++ ) {
+			double throughput = bench_ring( rings[i].options, record_sizes[j] );
+			if( throughput < 0 ) {
+				status = EXIT_FAILURE;
+			}
+			fprintf( stderr, "%-24s %12u %12.2f\n", rings[i].brief, record_sizes[j], throughput );
+		}
+	}
+
+	static const struct {
+		const char *brief;
+		int options;
+	} backings[] = {
+		{ "LOCKFREE", RINGBUF_OLOCKFREE },
+		{ "LOCKFREE+HUGEPAGE", RINGBUF_OLOCKFREE | RINGBUF_OHUGEPAGE },
+		{ "LOCKFREE+MLOCK", RINGBUF_OLOCKFREE | RINGBUF_OMLOCK },
+		{ "LOCKFREE+HUGEPAGE+MLOCK", RINGBUF_OLOCKFREE | RINGBUF_OHUGEPAGE | RINGBUF_OMLOCK },
+	};
+	fprintf( stderr, "%-24s %12s %12s\n", "first-burst", "total(ms)", "max(us)" );
+	for( size_t i = 0; i < sizeof( backings ) / sizeof( backings[0] ); i ++ ) {
+		double max_us = 0;
+		double total_ms = bench_burst( backings[i].options, &max_us );
+		fprintf( stderr, "%-24s %12.2f %12.2f\n", backings[i].brief, total_ms, max_us );
+	}
+
+	return status;
+}
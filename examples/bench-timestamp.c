@@ -0,0 +1,106 @@
+#include <xlog/xlog.h>
+#include <xlog/xlog_helper.h>
+
+#define BENCH_TIME_PREFIX	XLOG_PREFIX_LOG_TIME
+#define BENCH_TIME_SUFFIX	XLOG_SUFFIX_LOG_TIME
+
+static double elapsed_ns( const struct timespec *st, const struct timespec *et )
+{
+	return ( double )( et->tv_sec - st->tv_sec ) * 1e9 + ( double )( et->tv_nsec - st->tv_nsec );
+}
+
+int main( int argc, char **argv )
+{
+	( void )argc;
+	( void )argv;
+
+	unsigned int count_limit = 2000000;
+	volatile size_t sink = 0;
+
+	unsigned int index = 0;
+	struct {
+		const char *brief;
+		double ns_per_line;
+	} bench_result[4];
+
+	// BASE: gettimeofday-localtime_r-snprintf, as done per record before caching
+	{
+		struct timespec st, et;
+		clock_gettime( CLOCK_MONOTONIC, &st );
+		for( unsigned int i = 0; i < count_limit; i ++ ) {
+			char buffer[48];
+			struct timeval tv;
+			gettimeofday( &tv, NULL );
+			struct tm tm;
+			localtime_r( &tv.tv_sec, &tm );
+			int len = snprintf(
+				buffer, sizeof( buffer ),
+				"%s%02d/%02d %02d:%02d:%02d.%03d%s"
+				, BENCH_TIME_PREFIX
+				, tm.tm_mon + 1, tm.tm_mday
+				, tm.tm_hour, tm.tm_min, tm.tm_sec, ( int )( ( ( tv.tv_usec + 500 ) / 1000 ) % 1000 )
+				, BENCH_TIME_SUFFIX
+			);
+			sink += len;
+		}
+		clock_gettime( CLOCK_MONOTONIC, &et );
+
+		bench_result[index].brief = "BASE";
+		bench_result[index].ns_per_line = elapsed_ns( &st, &et ) / count_limit;
+		index ++;
+	}
+	fprintf( stderr, "End of BASE\n" );
+
+	// CACHED: per-thread cached "MM/DD HH:MM:SS", patch milliseconds only
+	{
+		struct timespec st, et;
+		clock_gettime( CLOCK_MONOTONIC, &st );
+		for( unsigned int i = 0; i < count_limit; i ++ ) {
+			char buffer[48], *ptr = buffer;
+			size_t len = strlen( BENCH_TIME_PREFIX );
+			memcpy( ptr, BENCH_TIME_PREFIX, len );
+			ptr += len;
+			ptr += xlog_format_time( ptr, sizeof( buffer ) - ( ptr - buffer ), NULL );
+			len = strlen( BENCH_TIME_SUFFIX );
+			memcpy( ptr, BENCH_TIME_SUFFIX, len + 1 );
+			ptr += len;
+			sink += ptr - buffer;
+		}
+		clock_gettime( CLOCK_MONOTONIC, &et );
+
+		bench_result[index].brief = "CACHED";
+		bench_result[index].ns_per_line = elapsed_ns( &st, &et ) / count_limit;
+		index ++;
+	}
+	fprintf( stderr, "End of CACHED\n" );
+
+	// CACHED-PRESET: format a given time, without reading the clock
+	{
+		struct timespec now;
+		clock_gettime( XLOG_CLOCK_LOG_TIME, &now );
+
+		struct timespec st, et;
+		clock_gettime( CLOCK_MONOTONIC, &st );
+		for( unsigned int i = 0; i < count_limit; i ++ ) {
+			char buffer[48];
+			sink += xlog_format_time( buffer, sizeof( buffer ), &now );
+		}
+		clock_gettime( CLOCK_MONOTONIC, &et );
+
+		bench_result[index].brief = "CACHED-PRESET";
+		bench_result[index].ns_per_line = elapsed_ns( &st, &et ) / count_limit;
+		index ++;
+	}
+	fprintf( stderr, "End of CACHED-PRESET\n" );
+
+	for( int i = 0; i < index; i ++ ) {
+		fprintf(
+			stderr, "%24s: %8.2f ns/line(%.3f)\n",
+			bench_result[i].brief, bench_result[i].ns_per_line,
+			bench_result[i].ns_per_line / bench_result[0].ns_per_line
+		);
+	}
+	( void )sink;
+
+	return 0;
+}
@@ -0,0 +1,119 @@
+#include <xlog/xlog.h>
+#include <xlog/xlog_helper.h>
+
+static xlog_printer_t *g_printer = NULL;
+static xlog_module_t *g_mod = NULL;
+#undef XLOG_PRINTER
+#define XLOG_PRINTER	g_printer
+#define XLOG_MODULE		g_mod
+
+#if (defined __GLIBC__)
+/* NOTE: count heap allocations by interposing allocators of glibc */
+extern void *__libc_malloc( size_t size );
+extern void *__libc_calloc( size_t nmemb, size_t size );
+extern void *__libc_realloc( void *ptr, size_t size );
+
+static volatile bool counting = false;
+static unsigned int allocations = 0;
+
+void *malloc( size_t size )
+{
+	if( counting ) {
+		__atomic_add_fetch( &allocations, 1, __ATOMIC_RELAXED );
+	}
+	return __libc_malloc( size );
+}
+
+void *calloc( size_t nmemb, size_t size )
+{
+	if( counting ) {
+		__atomic_add_fetch( &allocations, 1, __ATOMIC_RELAXED );
+	}
+	return __libc_calloc( nmemb, size );
+}
+
+void *realloc( void *ptr, size_t size )
+{
+	if( counting ) {
+		__atomic_add_fetch( &allocations, 1, __ATOMIC_RELAXED );
+	}
+	return __libc_realloc( ptr, size );
+}
+
+static unsigned int count_allocations( unsigned int lines )
+{
+	char body[3000];
+	memset( body, 'x', sizeof( body ) );
+	body[sizeof( body ) - 1] = '\0';
+	
+	/* warm up: stdio buffers, timezone, scratch autobuf grows to the largest record, formats parsed */
+	for( unsigned int i = 0; i < 64; i ++ ) {
+		log_i( "line %u: %s", i, body + ( i % 2 ? 0 : sizeof( body ) / 2 ) );
+		log_v( "line %u", i );
+	}
+	usleep( 100 * 1000 );	/* let consumer of buffering printer catch up */
+	
+	__atomic_store_n( &allocations, 0, __ATOMIC_RELAXED );
+	counting = true;
+	for( unsigned int i = 0; i < lines; i ++ ) {
+		log_i( "line %u: %s", i, body + ( i % 2 ? 0 : sizeof( body ) / 2 ) );
+		log_v( "line %u", i );
+		log_r( "raw line %u\n", i );
+	}
+	counting = false;
+	
+	return __atomic_load_n( &allocations, __ATOMIC_RELAXED );
+}
+#endif
+
+int main( int argc, char **argv )
+{
+	( void )argc;
+	( void )argv;
+	
+	#if (defined __GLIBC__)
+	XLOG_SET_THREAD_NAME( "cov-malloc" );
+	g_mod = xlog_module_open( "/cov/malloc", XLOG_LEVEL_VERBOSE, NULL );
+	
+	int errors = 0;
+	struct {
+		const char *brief;
+		int options;
+		const char *file;
+	} cases[] = {
+		{ "STDOUT", XLOG_PRINTER_STDOUT, NULL },
+		{ "FILE-BASIC", XLOG_PRINTER_FILES_BASIC, "./logs/cov-malloc.txt" },
+		{ "STDOUT+RINGBUF", XLOG_PRINTER_STDOUT | XLOG_PRINTER_BUFF_RINGBUF, NULL },
+		{ "STDOUT+DEFERRED", XLOG_PRINTER_STDOUT | XLOG_PRINTER_BUFF_DEFERRED, NULL },
+	};
+	for( int i = 0; i < XLOG_ARRAY_SIZE( cases ); i ++ ) {
+		if( cases[i].file ) {
+			g_printer = xlog_printer_create( cases[i].options, cases[i].file );
+		} else if( XLOG_PRINTER_BUFF_GET( cases[i].options ) ) {
+			g_printer = xlog_printer_create( cases[i].options, ( size_t )( 1024 * 1024 ) );
+		} else {
+			g_printer = xlog_printer_create( cases[i].options );
+		}
+		if( g_printer == NULL ) {
+			fprintf( stderr, "Failed to create printer %s.\n", cases[i].brief );
+			errors ++;
+			continue;
+		}
+		
+		unsigned int n = count_allocations( 1000 );
+		fprintf( stderr, "%24s: %u allocation(s) in steady state\n", cases[i].brief, n );
+		if( n != 0 ) {
+			errors ++;
+		}
+		
+		xlog_printer_destory( g_printer );
+		g_printer = NULL;
+	}
+	xlog_module_close( g_mod );
+	
+	return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+	#else
+	fprintf( stderr, "Skipped: allocators can't be interposed on this system.\n" );
+	return EXIT_SUCCESS;
+	#endif
+}
@@ -257,7 +257,7 @@ static int xlog_test_set_level( void )
 			char cmdline[] = "debug -r -l=w /net";
 			shell_make_args( cmdline, &targc, targv, 10 );
 			xlog_shell_main( XLOG_CONTEXT, targc, targv );
-
+			
 			#undef XLOG_MODULE
 			#define XLOG_MODULE g_net_http
 			log_d( "Never Print" );
@@ -279,6 +279,19 @@ int main( int argc, char **argv )
 	xlog_test_init();
 	xlog_test_set_level();
 	
+	/* NOTE: plans replaced by changing attributes are released once logging returned */
+	{
+		#undef XLOG_MODULE
+		#define XLOG_MODULE g_net
+		xlog_level_attr_t attributes = g_master->attributes[XLOG_LEVEL_INFO];
+		for( int i = 0; i < 100; i ++ ) {
+			attributes.format = ( i % 2 ) ? XLOG_FORMAT_OALL : XLOG_FORMAT_OLEVEL;
+			xlog_set_level_attributes( g_master, XLOG_LEVEL_INFO, &attributes );
+			log_i( "attributes changed %d times.", i + 1 );
+			assert( g_master->retired_plans == NULL && g_master->plan_readers == 0 );
+		}
+	}
+	
 	xlog_close( g_master, XLOG_CLOSE_CLEAR );
 	
 	return 0;
@@ -5,6 +5,8 @@
 #include <xlog/plugins/ringbuf.h>
 #include <xlog/plugins/family_tree.h>
 
+#include <sys/wait.h>
+
 static int random_integer( void )
 {
 	static bool initialized = false;
@@ -27,6 +29,33 @@ static int random_integer( void )
 	return rand();
 }
 
+/** copy records into full lock-free ring-buffer, cpu time(ms) spent while blocked returned */
+static void *ringbuf_blocked_producer( void *arg )
+{
+	ringbuf_t *rb = ( ringbuf_t * )arg;
+	char data[256];
+	memset( data, 'x', sizeof( data ) );
+	struct timespec begin, end;
+	clock_gettime( CLOCK_THREAD_CPUTIME_ID, &begin );
+	for( int i = 0; i < 64; i ++ ) {
+		int error = ringbuf_copy_into( rb, data, sizeof( data ) );
+		assert( error == 0 );
+	}
+	clock_gettime( CLOCK_THREAD_CPUTIME_ID, &end );
+	
+	return ( void * )( intptr_t )( ( end.tv_sec - begin.tv_sec ) * 1000 + ( end.tv_nsec - begin.tv_nsec ) / 1000000 );
+}
+
+/** copy a record into lock-free ring-buffer after consumer blocked for a while */
+static void *ringbuf_delayed_producer( void *arg )
+{
+	usleep( 300 * 1000 );
+	int error = ringbuf_copy_into( ( ringbuf_t * )arg, "late", 4 );
+	assert( error == 0 );
+	
+	return NULL;
+}
+
 static int shell_make_args( char *cmdline, int *argc_p, char **argv_p, int max_args )
 {
 	assert( cmdline );
@@ -108,5 +137,382 @@ int main( int argc, char **argv )
 		hexdump_shell_main( _argc, _argv );
 	}
 	
+	// ringbuf reserve/commit, records wrapped are padded
+	{
+		static const int options[] = { RINGBUF_OLOCKFREE, RINGBUF_OFRAMED, RINGBUF_OLOCKFREE | RINGBUF_OFRAMED, RINGBUF_OLOCKFREE | RINGBUF_OPOW2 };
+		for( int k = 0; k < sizeof( options ) / sizeof( *options ); k ++ ) {
+			ringbuf_t *rb = ringbuf_create_ex( 1024, options[k] );
+			assert( rb );
+			for( int i = 0; i < 256; i ++ ) {
+				unsigned int reserved = 1 + random_integer() % 300;
+				unsigned int length = random_integer() % ( reserved + 1 );
+				void *vptr = NULL;
+				int error = ringbuf_reserve( rb, reserved, &vptr );
+				assert( error == 0 && vptr );
+				memset( vptr, 'a' + i % 26, length );
+				ringbuf_commit( rb, vptr, length );
+				
+				char buff[512];
+				int copied = ringbuf_copy_from( rb, buff, sizeof( buff ), true );
+				assert( copied == length );
+				for( int j = 0; j < copied; j ++ ) {
+					assert( buff[j] == 'a' + i % 26 );
+				}
+			}
+			ringbuf_destory( rb );
+		}
+		
+		void *vptr = NULL;
+		ringbuf_t *rb = ringbuf_create( 1024 );
+		int error = ringbuf_reserve( rb, 64, &vptr );
+		assert( error == ENOTSUP && vptr == NULL );
+		ringbuf_destory( rb );
+	}
+	
+	// ringbuf reservation canceled, written or NOT, leaves no record behind
+	{
+		static const int options[] = { RINGBUF_OLOCKFREE, RINGBUF_OFRAMED, RINGBUF_OLOCKFREE | RINGBUF_OFRAMED, RINGBUF_OLOCKFREE | RINGBUF_OPOW2 };
+		for( int k = 0; k < sizeof( options ) / sizeof( *options ); k ++ ) {
+			ringbuf_t *rb = ringbuf_create_ex( 4096, options[k] );
+			assert( rb );
+			ringbuf_record_t header;
+			char buff[64];
+			for( int i = 0; i < 64; i ++ ) {
+				/* the last reservation, given back */
+				void *vptr = NULL;
+				int error = ringbuf_reserve( rb, 1024, &vptr );
+				assert( error == 0 && vptr );
+				memset( vptr, 'e', 1024 );
+				ringbuf_commit( rb, vptr, 0 );
+				error = ringbuf_copy_into_record( rb, "hi", 2, 1 );
+				assert( error == 0 );
+				error = ringbuf_peek_record( rb, &header );
+				assert( error == 0 && header.length == 2 && header.level == 1 );
+				error = ringbuf_read_record( rb, &header, buff, sizeof( buff ) );
+				assert( error == 0 && header.length == 2 && memcmp( buff, "hi", 2 ) == 0 );
+				error = ringbuf_peek_record( rb, &header );
+				assert( error == EAGAIN );
+			}
+			if( options[k] & RINGBUF_OLOCKFREE ) {
+				/* NOT the last reservation, skipped */
+				void *first = NULL, *second = NULL;
+				int error = ringbuf_reserve( rb, 256, &first );
+				assert( error == 0 && first );
+				error = ringbuf_reserve( rb, 256, &second );
+				assert( error == 0 && second );
+				memset( first, 'e', 256 );
+				ringbuf_commit( rb, first, 0 );
+				memcpy( second, "ok", 2 );
+				ringbuf_commit( rb, second, 2 );
+				error = ringbuf_read_record( rb, &header, buff, sizeof( buff ) );
+				assert( error == 0 && header.length == 2 && memcmp( buff, "ok", 2 ) == 0 );
+				error = ringbuf_peek_record( rb, &header );
+				assert( error == EAGAIN );
+			}
+			ringbuf_destory( rb );
+		}
+	}
+	
+	// ringbuf framed records, read as a whole with level and timestamp
+	{
+		static const int options[] = { RINGBUF_OLOCKFREE, RINGBUF_OFRAMED, RINGBUF_OLOCKFREE | RINGBUF_OFRAMED, RINGBUF_OLOCKFREE | RINGBUF_OPOW2 };
+		for( int k = 0; k < sizeof( options ) / sizeof( *options ); k ++ ) {
+			ringbuf_t *rb = ringbuf_create_ex( 1024, options[k] );
+			assert( rb );
+			for( int i = 0; i < 256; i ++ ) {
+				unsigned int length = 1 + random_integer() % 200;
+				char data[256];
+				memset( data, 'a' + i % 26, length );
+				int error = 0;
+				if( i % 2 ) {
+					error = ringbuf_copy_into_record( rb, data, length, i % 7 );
+					assert( error == 0 );
+				} else {
+					void *vptr = NULL;
+					error = ringbuf_reserve( rb, length + 16, &vptr );
+					assert( error == 0 && vptr );
+					memcpy( vptr, data, length );
+					ringbuf_commit_record( rb, vptr, length, i % 7 );
+				}
+				error = ringbuf_copy_into_record( rb, data, 8, 0 );
+				assert( error == 0 );
+				
+				ringbuf_record_t header;
+				error = ringbuf_peek_record( rb, &header );
+				assert( error == 0 );
+				assert( header.length == length );
+				assert( header.level == i % 7 );
+				assert( ( header.timestamp != 0 ) == ( ( options[k] & RINGBUF_OFRAMED ) != 0 ) );
+				char buff[256];
+				memset( buff, 0, sizeof( buff ) );
+				error = ringbuf_read_record( rb, &header, buff, length / 2 );
+				assert( error == 0 );
+				assert( header.length == length && buff[length / 2] == '\0' );
+				for( int j = 0; j < length / 2; j ++ ) {
+					assert( buff[j] == 'a' + i % 26 );
+				}
+				/* the rest of record skipped, next record is intact */
+				error = ringbuf_read_record( rb, &header, buff, sizeof( buff ) );
+				assert( error == 0 && header.length == 8 && header.level == 0 );
+				error = ringbuf_read_record( rb, &header, buff, sizeof( buff ) );
+				assert( error == EAGAIN );
+			}
+			ringbuf_destory( rb );
+		}
+		
+		ringbuf_t *rb = ringbuf_create( 1024 );
+		ringbuf_record_t header;
+		int error = ringbuf_peek_record( rb, &header );
+		assert( error == ENOTSUP );
+		ringbuf_destory( rb );
+		
+		/* record peeked is evicted before read, header of the one read is returned */
+		rb = ringbuf_create_ex( 2047, RINGBUF_OFRAMED | RINGBUF_ODROP_OLD );
+		assert( rb );
+		char data[1000];
+		memset( data, 'a', sizeof( data ) );
+		error = ringbuf_copy_into( rb, data, sizeof( data ) );
+		assert( error == 0 );
+		error = ringbuf_peek_record( rb, &header );
+		assert( error == 0 && header.length == sizeof( data ) );
+		error = ringbuf_copy_into( rb, "bbbbb", 5 );
+		assert( error == 0 );
+		error = ringbuf_copy_into( rb, data, sizeof( data ) );
+		assert( error == 0 );
+		uint64_t records = 0, bytes = 0;
+		ringbuf_dropped( rb, &records, &bytes );
+		assert( records == 1 && bytes == sizeof( data ) );
+		char buff[sizeof( data )];
+		error = ringbuf_read_record( rb, &header, buff, sizeof( buff ) );
+		assert( error == 0 && header.length == 5 && memcmp( buff, "bbbbb", 5 ) == 0 );
+		ringbuf_destory( rb );
+	}
+	
+	// ringbuf lock-free and blocked, producers sleep instead of spinning until consumer releases space
+	{
+		ringbuf_t *rb = ringbuf_create_ex( 4096, RINGBUF_OLOCKFREE | RINGBUF_OBLOCK );
+		assert( rb );
+		pthread_t threads[2];
+		for( int i = 0; i < 2; i ++ ) {
+			pthread_create( threads + i, NULL, ringbuf_blocked_producer, rb );
+		}
+		usleep( 300 * 1000 );
+		char data[256];
+		for( int count = 0; count < 2 * 64; ) {
+			ringbuf_record_t header;
+			if( ringbuf_read_record( rb, &header, data, sizeof( data ) ) == 0 ) {
+				assert( header.length == sizeof( data ) );
+				count ++;
+			} else {
+				ringbuf_wait( rb, 100 );
+			}
+		}
+		for( int i = 0; i < 2; i ++ ) {
+			void *cpu_ms = NULL;
+			pthread_join( threads[i], &cpu_ms );
+			assert( ( intptr_t )cpu_ms < 100 );
+		}
+		ringbuf_destory( rb );
+	}
+	
+	// ringbuf lock-free and empty, blocking consumer sleeps instead of spinning until producer commits
+	{
+		ringbuf_t *rb = ringbuf_create_ex( 4096, RINGBUF_OLOCKFREE );
+		assert( rb );
+		pthread_t thread;
+		pthread_create( &thread, NULL, ringbuf_delayed_producer, rb );
+		char data[16];
+		struct timespec begin, end;
+		clock_gettime( CLOCK_THREAD_CPUTIME_ID, &begin );
+		int length = ringbuf_copy_from( rb, data, sizeof( data ), false );
+		clock_gettime( CLOCK_THREAD_CPUTIME_ID, &end );
+		assert( length == 4 && memcmp( data, "late", 4 ) == 0 );
+		assert( ( end.tv_sec - begin.tv_sec ) * 1000 + ( end.tv_nsec - begin.tv_nsec ) / 1000000 < 100 );
+		pthread_join( thread, NULL );
+		ringbuf_destory( rb );
+	}
+	
+	// ringbuf power-of-two, offsets masked, state of producers and consumer on separate cache lines
+	{
+		ringbuf_t *rb = ringbuf_create_ex( 1000, RINGBUF_OPOW2 );
+		assert( rb && rb->capacity == 1023 && rb->mask == 1023 );
+		ringbuf_destory( rb );
+		rb = ringbuf_create_ex( 1024, RINGBUF_OPOW2 );
+		assert( rb && rb->capacity == 2047 && rb->mask == 2047 );
+		assert( ( uintptr_t )rb % RINGBUF_CACHELINE_SIZE == 0 );
+		assert( offsetof( ringbuf_t, rd_offset ) - offsetof( ringbuf_t, wr_offset ) >= RINGBUF_CACHELINE_SIZE );
+		ringbuf_destory( rb );
+		
+		static const int options[] = { 0, RINGBUF_OPOW2, RINGBUF_OLOCKFREE | RINGBUF_OPOW2 };
+		for( int k = 0; k < sizeof( options ) / sizeof( *options ); k ++ ) {
+			rb = ringbuf_create_ex( 1000, options[k] );
+			assert( rb );
+			unsigned char written = 0, read = 0;
+			for( int i = 0; i < 256; i ++ ) {
+				unsigned char data[300];
+				unsigned int length = 1 + random_integer() % sizeof( data );
+				for( int j = 0; j < length; j ++ ) {
+					data[j] = written ++;
+				}
+				int error = ringbuf_copy_into( rb, data, length );
+				assert( error == 0 );
+				unsigned int copied = 0;
+				while( copied < length ) {
+					int n = ringbuf_copy_from( rb, data, random_integer() % sizeof( data ) + 1, true );
+					assert( n > 0 );
+					for( int j = 0; j < n; j ++ ) {
+						assert( data[j] == read ++ );
+					}
+					copied += n;
+				}
+			}
+			ringbuf_destory( rb );
+		}
+	}
+	
+	// ringbuf backed by huge pages or locked, pre-faulted
+	{
+		static const int options[] = {
+			RINGBUF_OHUGEPAGE, RINGBUF_OMLOCK, RINGBUF_OHUGEPAGE | RINGBUF_OMLOCK,
+			RINGBUF_OLOCKFREE | RINGBUF_OPOW2 | RINGBUF_OHUGEPAGE | RINGBUF_OMLOCK
+		};
+		for( int k = 0; k < sizeof( options ) / sizeof( *options ); k ++ ) {
+			ringbuf_t *rb = ringbuf_create_ex( 3 * 1024 * 1024, options[k] );
+			assert( rb );
+			if( options[k] & RINGBUF_OHUGEPAGE ) {
+				assert( rb->mapped == 4 * 1024 * 1024 );
+			} else {
+				assert( rb->mapped == 0 );
+			}
+			unsigned char data[4096];
+			for( int i = 0; i < 4096; i ++ ) {
+				for( int j = 0; j < sizeof( data ); j ++ ) {
+					data[j] = ( unsigned char )( i + j );
+				}
+				int error = ringbuf_copy_into( rb, data, sizeof( data ) );
+				assert( error == 0 );
+				int copied = ringbuf_copy_from( rb, data, sizeof( data ), true );
+				assert( copied == sizeof( data ) );
+				for( int j = 0; j < sizeof( data ); j ++ ) {
+					assert( data[j] == ( unsigned char )( i + j ) );
+				}
+			}
+			ringbuf_destory( rb );
+		}
+	}
+	
+	// ringbuf in shared memory, attached twice in this process and by producers forked
+	{
+		const char *name = "/xlog-cov-plugins";
+		ringbuf_unlink_shared( name );
+		ringbuf_t *writer = ringbuf_open_shared( name, 64 * 1024, RINGBUF_OLOCKFREE );
+		assert( writer && writer->shared && writer->data == NULL );
+		ringbuf_t *reader = ringbuf_open_shared( name, 0, 0 );
+		assert( reader && reader != writer );
+		assert( reader->capacity == writer->capacity && ( reader->options & RINGBUF_OLOCKFREE ) );
+		
+		ringbuf_record_t record;
+		char data[64];
+		int error = ringbuf_copy_into_record( writer, "hello", 5, 3 );
+		assert( error == 0 );
+		error = ringbuf_read_record( reader, &record, data, sizeof( data ) );
+		assert( error == 0 );
+		assert( record.length == 5 && record.level == 3 && memcmp( data, "hello", 5 ) == 0 );
+		ringbuf_destory( writer );
+		
+		pid_t pids[4];
+		for( int k = 0; k < 4; k ++ ) {
+			pids[k] = fork();
+			assert( pids[k] >= 0 );
+			if( pids[k] == 0 ) {
+				ringbuf_t *rb = ringbuf_open_shared( name, 0, 0 );
+				for( int i = 0; rb && i < 1000; i ++ ) {
+					int length = snprintf( data, sizeof( data ), "%d:%d", k, i );
+					ringbuf_copy_into( rb, data, length );
+				}
+				ringbuf_destory( rb );
+				_exit( rb ? 0 : 1 );
+			}
+		}
+		/* records of each producer in order */
+		int next[4] = { 0 }, count = 0;
+		while( count < 4 * 1000 ) {
+			if( ringbuf_read_record( reader, &record, data, sizeof( data ) - 1 ) == 0 ) {
+				int k = -1, i = -1;
+				data[record.length] = '\0';
+				int parsed = sscanf( data, "%d:%d", &k, &i );
+				assert( parsed == 2 && k >= 0 && k < 4 && next[k] == i );
+				next[k] ++;
+				count ++;
+			} else {
+				ringbuf_wait( reader, 100 );
+			}
+		}
+		for( int k = 0; k < 4; k ++ ) {
+			int status = -1;
+			pid_t pid = waitpid( pids[k], &status, 0 );
+			assert( pid == pids[k] && WIFEXITED( status ) && WEXITSTATUS( status ) == 0 );
+		}
+		
+		/* record of producer exited without committing is skipped and dropped */
+		pid_t orphan = fork();
+		assert( orphan >= 0 );
+		if( orphan == 0 ) {
+			ringbuf_t *rb = ringbuf_open_shared( name, 0, 0 );
+			void *space = NULL;
+			int reserved = rb ? ringbuf_reserve( rb, 16, &space ) : EINVAL;
+			_exit( reserved == 0 ? 0 : 1 );
+		}
+		int status = -1;
+		pid_t reaped = waitpid( orphan, &status, 0 );
+		assert( reaped == orphan && WIFEXITED( status ) && WEXITSTATUS( status ) == 0 );
+		error = ringbuf_copy_into( reader, "after", 5 );
+		assert( error == 0 );
+		uint64_t dropped = 0, dropped_after = 0;
+		ringbuf_dropped( reader, &dropped, NULL );
+		while( ringbuf_read_record( reader, &record, data, sizeof( data ) ) != 0 ) {
+			ringbuf_wait( reader, 0 );
+		}
+		assert( record.length == 5 && memcmp( data, "after", 5 ) == 0 );
+		ringbuf_dropped( reader, &dropped_after, NULL );
+		assert( dropped_after == dropped + 1 );
+		ringbuf_destory( reader );
+		error = ringbuf_unlink_shared( name );
+		assert( error == 0 );
+	}
+	
+	// ringbuf backed by file, read back after unmapped, others rejected
+	{
+		const char *path = "./logs/cov-plugins-ringbuf.bin";
+		ringbuf_t *rb = ringbuf_open_file( path, 4096, RINGBUF_ODROP_OLD );
+		assert( rb && rb->shared && ( rb->options & RINGBUF_OFRAMED ) );
+		char data[64];
+		for( int i = 0; i < 1000; i ++ ) {
+			int length = snprintf( data, sizeof( data ), "%d", i );
+			int error = ringbuf_copy_into( rb, data, length );
+			assert( error == 0 );
+		}
+		ringbuf_destory( rb );
+		rb = ringbuf_recover_file( path );
+		assert( rb );
+		ringbuf_record_t record;
+		int last = -1;
+		while( ringbuf_read_record( rb, &record, data, sizeof( data ) - 1 ) == 0 ) {
+			data[record.length] = '\0';
+			assert( last < 0 || atoi( data ) == last + 1 );
+			last = atoi( data );
+		}
+		assert( last == 999 );
+		ringbuf_destory( rb );
+		rb = ringbuf_recover_file( "./logs/cov-plugins-missing.bin" );
+		assert( rb == NULL && errno == ENOENT );
+		int fd = open( path, O_WRONLY | O_TRUNC );
+		ssize_t written = fd >= 0 ? write( fd, data, sizeof( data ) ) : -1;
+		assert( written == sizeof( data ) );
+		close( fd );
+		rb = ringbuf_recover_file( path );
+		assert( rb == NULL && errno == EPROTO );
+	}
+	
 	return 0;
 }
\ No newline at end of file
@@ -3,6 +3,12 @@
 
 #include <xlog/xlog.h>
 #include <xlog/xlog_helper.h>
+#include <xlog/plugins/ringbuf.h>
+
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <signal.h>
 
 static xlog_printer_t *g_printer = NULL;
 static xlog_module_t *g_mod = NULL;
@@ -30,6 +36,81 @@ static unsigned long random_integer( void )
 	return rand();
 }
 
+/** log from producer thread, its ring is reclaimed after exiting */
+static void *cov_producer_thread( void *arg )
+{
+	const char *text = ( const char * )arg;
+	for( int i = 0; i < 80; i ++ ) {
+		log_w( "%d: %s", i, text );
+	}
+	
+	return NULL;
+}
+
+/** append fixed-size lines to rotating printer concurrently */
+static void *cov_rotating_thread( void *arg )
+{
+	char line[64];
+	memset( line, '0' + ( int )( intptr_t )arg, sizeof( line ) - 1 );
+	line[sizeof( line ) - 1] = '\n';
+	for( int i = 0; i < 2000; i ++ ) {
+		xlog_printer_append( g_printer, line, sizeof( line ), XLOG_LEVEL_INFO, NULL );
+	}
+	
+	return NULL;
+}
+
+/** append lines larger than deferred record concurrently */
+static void *cov_large_line_thread( void *arg )
+{
+	char line[3000];
+	memset( line, 'a' + ( int )( intptr_t )arg, sizeof( line ) - 1 );
+	line[sizeof( line ) - 1] = '\n';
+	for( int i = 0; i < 200; i ++ ) {
+		xlog_printer_append( g_printer, line, sizeof( line ), XLOG_LEVEL_INFO, NULL );
+	}
+	
+	return NULL;
+}
+
+/** printer defined by user, NOT created by xlog_printer_create, fields unknown to it zeroed */
+static char cov_user_text[1024];
+
+static int cov_user_append( xlog_printer_t *printer, void *data )
+{
+	( void )printer;
+	strncat( cov_user_text, ( const char * )data, sizeof( cov_user_text ) - strlen( cov_user_text ) - 1 );
+	
+	return strlen( ( const char * )data );
+}
+
+static int cov_user_optctl( xlog_printer_t *printer, int option, void *vptr, size_t size )
+{
+	( void )printer;
+	if( option == XLOG_PRINTER_CTRL_GABICLR && size == sizeof( int ) && vptr ) {
+		*( int * )vptr = 1;
+		return 0;
+	}
+	
+	return -1;
+}
+
+/** count lines in file */
+static unsigned int cov_count_lines( const char *file )
+{
+	unsigned int lines = 0;
+	FILE *fp = fopen( file, "r" );
+	if( fp ) {
+		int c;
+		while( ( c = fgetc( fp ) ) != EOF ) {
+			lines += c == '\n';
+		}
+		fclose( fp );
+	}
+	
+	return lines;
+}
+
 int main( int argc, char **argv )
 {
 	( void )argc;
@@ -260,6 +341,474 @@ int main( int argc, char **argv )
 		fprintf(stderr, "End of NCPY-RINGBUF-FILE-DAILY\n" );
 	}
 	
+	// NOTE: overflow policies of buffering printers
+	{
+		{
+			g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | XLOG_PRINTER_OVERFLOW_DROP_NEW, "./logs/overflow-drop-new.txt", 1024 );
+			unsigned int i = 0;
+			while( i < count_limit ) {
+				log_w( "%s", buffer );
+				i ++;
+			}
+			xlog_printer_destory( g_printer );
+			g_printer = NULL;
+		}
+		fprintf(stderr, "End of OVERFLOW-DROP-NEW\n" );
+		
+		{
+			g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_DEFERRED | XLOG_PRINTER_OVERFLOW_TIMEOUT, "./logs/overflow-timeout.txt", 1024, 10U );
+			unsigned int i = 0;
+			while( i < count_limit ) {
+				log_w( "%s", buffer );
+				i ++;
+			}
+			xlog_printer_destory( g_printer );
+			g_printer = NULL;
+		}
+		fprintf(stderr, "End of OVERFLOW-TIMEOUT\n" );
+		
+		{
+			g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_NCPYRBUF | XLOG_PRINTER_OVERFLOW_DROP_OLD, "./logs/overflow-drop-old.txt", 64 );
+			unsigned int i = 0;
+			while( i < count_limit ) {
+				log_w( "%s", buffer );
+				i ++;
+			}
+			xlog_printer_destory( g_printer );
+			g_printer = NULL;
+		}
+		fprintf(stderr, "End of OVERFLOW-DROP-OLD\n" );
+		
+		// records are retained until flushing, the oldest are overwritten
+		{
+			g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | XLOG_PRINTER_OVERFLOW_OVERWRITE, "./logs/overflow-overwrite.txt", 1024 );
+			XLOG_ASSERT( g_printer );
+			unsigned int i = 0;
+			while( i < count_limit ) {
+				log_w( "%s", buffer );
+				i ++;
+			}
+			g_printer->optctl( g_printer, XLOG_PRINTER_CTRL_FLUSH, NULL, 0 );
+			xlog_stats_t *stats = NULL;
+			if( g_printer->optctl( g_printer, XLOG_PRINTER_CTRL_GSTATS, &stats, sizeof( stats ) ) == 0 ) {
+				XLOG_ASSERT( XLOG_STATS_GET( stats, REQUEST, DROPPED ) > 0 );
+				XLOG_ASSERT( XLOG_STATS_GET( stats, BYTE, DROPPED ) > 0 );
+				fprintf(stderr, "Dropped %u records(%u bytes) of %u\n",
+					( unsigned int )XLOG_STATS_GET( stats, REQUEST, DROPPED ), ( unsigned int )XLOG_STATS_GET( stats, BYTE, DROPPED ),
+					( unsigned int )XLOG_STATS_GET( stats, REQUEST, INPUT )
+				);
+			}
+			xlog_printer_destory( g_printer );
+			g_printer = NULL;
+		}
+		fprintf(stderr, "End of OVERFLOW-OVERWRITE\n" );
+	}
+	
+	// NOTE: ring-buffer per producer thread, drained round-robin or merged by timestamp
+	{
+		static const struct {
+			const char *brief;
+			const char *file;
+			int options;
+		} cases[] = {
+			{ "PERTHREAD", "./logs/ringbuf-perthread.txt", XLOG_PRINTER_OPERTHREAD },
+			{ "PERTHREAD-ORDERED", "./logs/ringbuf-perthread-ordered.txt", XLOG_PRINTER_OORDERED },
+			{ "PERTHREAD-OVERWRITE", "./logs/ringbuf-perthread-overwrite.txt", XLOG_PRINTER_OPERTHREAD | XLOG_PRINTER_OVERFLOW_OVERWRITE },
+		};
+		for( int k = 0; k < sizeof( cases ) / sizeof( cases[0] ); k ++ ) {
+			unlink( cases[k].file );
+			g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | cases[k].options, cases[k].file, 64 * 1024 );
+			XLOG_ASSERT( g_printer );
+			pthread_t threads[4];
+			for( int i = 0; i < 4; i ++ ) {
+				pthread_create( threads + i, NULL, cov_producer_thread, buffer );
+			}
+			for( int i = 0; i < 4; i ++ ) {
+				pthread_join( threads[i], NULL );
+			}
+			/* rings of threads exited are reclaimed, and a new one registered */
+			usleep( 10 * 1000 );
+			cov_producer_thread( buffer );
+			xlog_printer_destory( g_printer );
+			g_printer = NULL;
+			XLOG_ASSERT( cov_count_lines( cases[k].file ) == 5 * 80 );
+			fprintf(stderr, "End of %s\n", cases[k].brief );
+		}
+	}
+	
+	// NOTE: coalescing buffer of file printers, rotated at the same bytes as written through
+	{
+		static const char *pattern[] = { "./logs/coalesce-none.txt", "./logs/coalesce-rotating.txt" };
+		static const char *files[] = { "./logs/coalesce-none_%05d.txt", "./logs/coalesce-rotating_%05d.txt" };
+		char path[64], line[128];
+		for( int k = 0; k < 2; k ++ ) {
+			for( int n = 0; n < 16; n ++ ) {
+				snprintf( path, sizeof( path ), files[k], n );
+				unlink( path );
+			}
+			g_printer = k == 0
+				? xlog_printer_create( XLOG_PRINTER_FILES_ROTATING, pattern[k], ( size_t )4096, ( size_t )16 )
+				: xlog_printer_create( XLOG_PRINTER_FILES_ROTATING | XLOG_PRINTER_OCOALESCE, pattern[k], ( size_t )4096, ( size_t )16, ( size_t )1000, 0 );
+			XLOG_ASSERT( g_printer );
+			for( int i = 0; i < 1000; i ++ ) {
+				snprintf( line, sizeof( line ), "%d: %.*s\n", i, i % BENCH_BUFFER_SIZE, buffer );
+				g_printer->append( g_printer, line );
+			}
+			xlog_printer_destory( g_printer );
+			g_printer = NULL;
+		}
+		for( int n = 0; n < 16; n ++ ) {
+			struct stat st[2] = { { 0 } };
+			for( int k = 0; k < 2; k ++ ) {
+				snprintf( path, sizeof( path ), files[k], n );
+				stat( path, st + k );
+			}
+			XLOG_ASSERT( st[0].st_size == st[1].st_size );
+		}
+		
+		/* bytes buffered are written out after latency, or on flush */
+		const char *file = "./logs/coalesce-basic.txt";
+		unlink( file );
+		g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_OCOALESCE, file, ( size_t )0, 50 );
+		XLOG_ASSERT( g_printer );
+		g_printer->append( g_printer, "first line\n" );
+		XLOG_ASSERT( cov_count_lines( file ) == 0 );
+		usleep( 200 * 1000 );
+		XLOG_ASSERT( cov_count_lines( file ) == 1 );
+		g_printer->append( g_printer, "second line\n" );
+		int error = g_printer->optctl( g_printer, XLOG_PRINTER_CTRL_FLUSH, NULL, 0 );
+		XLOG_ASSERT( error == 0 );
+		XLOG_ASSERT( cov_count_lines( file ) == 2 );
+		g_printer->append( g_printer, "third line\n" );
+		xlog_printer_destory( g_printer );
+		g_printer = NULL;
+		XLOG_ASSERT( cov_count_lines( file ) == 3 );
+		
+		/* batches drained by buffering printer are coalesced, written out on destory */
+		unlink( file );
+		g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_OCOALESCE | XLOG_PRINTER_BUFF_RINGBUF, file, ( size_t )0, 0, ( size_t )( 64 * 1024 ) );
+		XLOG_ASSERT( g_printer );
+		for( int i = 0; i < 80; i ++ ) {
+			log_w( "%d: %s", i, buffer );
+		}
+		xlog_printer_destory( g_printer );
+		g_printer = NULL;
+		XLOG_ASSERT( cov_count_lines( file ) == 80 );
+		fprintf(stderr, "End of COALESCE\n" );
+	}
+	
+	// NOTE: rotating printer appended concurrently, lines never torn or lost across rotation
+	{
+		char path[64];
+		for( int n = 0; n < 40; n ++ ) {
+			snprintf( path, sizeof( path ), "./logs/rotating-threads_%05d.txt", n );
+			unlink( path );
+		}
+		g_printer = xlog_printer_create( XLOG_PRINTER_FILES_ROTATING, "./logs/rotating-threads.txt", ( size_t )( 16 * 1024 ), ( size_t )40 );
+		XLOG_ASSERT( g_printer );
+		pthread_t threads[4];
+		for( int i = 0; i < 4; i ++ ) {
+			pthread_create( threads + i, NULL, cov_rotating_thread, ( void * )( intptr_t )i );
+		}
+		for( int i = 0; i < 4; i ++ ) {
+			pthread_join( threads[i], NULL );
+		}
+		xlog_printer_destory( g_printer );
+		g_printer = NULL;
+		off_t total = 0;
+		unsigned int lines = 0;
+		for( int n = 0; n < 40; n ++ ) {
+			struct stat st = { 0 };
+			snprintf( path, sizeof( path ), "./logs/rotating-threads_%05d.txt", n );
+			if( stat( path, &st ) != 0 ) {
+				continue;
+			}
+			XLOG_ASSERT( st.st_size % 64 == 0 );
+			total += st.st_size;
+			lines += cov_count_lines( path );
+		}
+		XLOG_ASSERT( total == 4 * 2000 * 64 && lines == 4 * 2000 );
+		fprintf(stderr, "End of ROTATING-THREADS\n" );
+	}
+	
+	// NOTE: data of known length appended as-is, '\0' included
+	{
+		const char *file = "./logs/append-length.txt";
+		static const char binary[] = { 'a', '\0', 'b', '\n' };
+		struct timespec now;
+		clock_gettime( CLOCK_REALTIME, &now );
+		unlink( file );
+		g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC, file );
+		XLOG_ASSERT( g_printer && g_printer->appendl );
+		int length = xlog_printer_append( g_printer, binary, sizeof( binary ), XLOG_LEVEL_INFO, &now );
+		XLOG_ASSERT( length == sizeof( binary ) );
+		xlog_printer_destory( g_printer );
+		g_printer = NULL;
+		struct stat st = { 0 };
+		XLOG_ASSERT( stat( file, &st ) == 0 && st.st_size == sizeof( binary ) );
+		
+		/* copied into ring-buffer of buffering printer with length */
+		unlink( file );
+		g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_RINGBUF | XLOG_PRINTER_OLOCKFREE, file, ( size_t )( 64 * 1024 ) );
+		XLOG_ASSERT( g_printer );
+		for( int i = 0; i < 10; i ++ ) {
+			length = xlog_printer_append( g_printer, binary, sizeof( binary ), XLOG_LEVEL_INFO, NULL );
+			XLOG_ASSERT( length == sizeof( binary ) );
+		}
+		xlog_printer_destory( g_printer );
+		g_printer = NULL;
+		XLOG_ASSERT( stat( file, &st ) == 0 && st.st_size == 10 * sizeof( binary ) );
+		fprintf(stderr, "End of APPEND-LENGTH\n" );
+	}
+	
+	// NOTE: buffer of format reused for another format before deferred record formatted
+	{
+		const char *file = "./logs/deferred-reused-format.txt";
+		unlink( file );
+		g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_DEFERRED, file, ( size_t )( 64 * 1024 ) );
+		XLOG_ASSERT( g_printer );
+		char format[16];
+		strcpy( format, "number %d" );
+		xlog_output_fmtlog( g_printer, NULL, XLOG_LEVEL_INFO, __FILE__, __func__, __LINE__, format, 42 );
+		strcpy( format, "string %s" );
+		xlog_output_fmtlog( g_printer, NULL, XLOG_LEVEL_INFO, __FILE__, __func__, __LINE__, format, "hello" );
+		memset( format, 'x', sizeof( format ) );
+		xlog_printer_destory( g_printer );
+		g_printer = NULL;
+		
+		char text[1024] = { 0 };
+		FILE *fp = fopen( file, "r" );
+		XLOG_ASSERT( fp );
+		size_t length = fread( text, 1, sizeof( text ) - 1, fp );
+		fclose( fp );
+		XLOG_ASSERT( length > 0 && strstr( text, "number 42" ) && strstr( text, "string hello" ) );
+		fprintf(stderr, "End of DEFERRED-REUSED-FORMAT\n" );
+	}
+	
+	// NOTE: formats built at runtime beyond slots of parsed formats are formatted immediately
+	{
+		const char *file = "./logs/deferred-runtime-formats.txt";
+		unlink( file );
+		g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_DEFERRED, file, ( size_t )( 64 * 1024 ) );
+		XLOG_ASSERT( g_printer );
+		for( int i = 0; i < 2 * XLOG_LIMIT_DEFERRED_FORMATS; i ++ ) {
+			char format[32];
+			snprintf( format, sizeof( format ), "runtime-%05d %%d", i );
+			xlog_output_fmtlog( g_printer, NULL, XLOG_LEVEL_INFO, __FILE__, __func__, __LINE__, format, i );
+		}
+		xlog_printer_destory( g_printer );
+		g_printer = NULL;
+		
+		char line[256];
+		int next = 0;
+		FILE *fp = fopen( file, "r" );
+		XLOG_ASSERT( fp );
+		while( fgets( line, sizeof( line ), fp ) ) {
+			char expected[32];
+			snprintf( expected, sizeof( expected ), "runtime-%05d %d", next, next );
+			if( strstr( line, expected ) ) {
+				next ++;
+			}
+		}
+		fclose( fp );
+		XLOG_ASSERT( next == 2 * XLOG_LIMIT_DEFERRED_FORMATS );
+		fprintf(stderr, "End of DEFERRED-RUNTIME-FORMATS\n" );
+	}
+	
+	// NOTE: lines larger than deferred record are never split or interleaved
+	{
+		const char *file = "./logs/deferred-large-lines.txt";
+		unlink( file );
+		g_printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC | XLOG_PRINTER_BUFF_DEFERRED | XLOG_PRINTER_OLOCKFREE, file, ( size_t )( 64 * 1024 ) );
+		XLOG_ASSERT( g_printer );
+		pthread_t threads[4];
+		for( int i = 0; i < 4; i ++ ) {
+			pthread_create( threads + i, NULL, cov_large_line_thread, ( void * )( intptr_t )i );
+		}
+		for( int i = 0; i < 4; i ++ ) {
+			pthread_join( threads[i], NULL );
+		}
+		xlog_printer_destory( g_printer );
+		g_printer = NULL;
+		
+		char line[4096];
+		unsigned int lines = 0;
+		FILE *fp = fopen( file, "r" );
+		XLOG_ASSERT( fp );
+		while( fgets( line, sizeof( line ), fp ) ) {
+			size_t length = strlen( line );
+			XLOG_ASSERT( length == 3000 && line[0] >= 'a' && line[0] <= 'd' );
+			for( size_t k = 1; k < length - 1; k ++ ) {
+				XLOG_ASSERT( line[k] == line[0] );
+			}
+			lines ++;
+		}
+		fclose( fp );
+		XLOG_ASSERT( lines == 4 * 200 );
+		fprintf(stderr, "End of DEFERRED-LARGE-LINES\n" );
+	}
+	
+	// NOTE: custom boundaries of daily printer, new file every second
+	{
+		const char *prefix = "rollover-file_";
+		DIR *dir = opendir( "./logs" );
+		XLOG_ASSERT( dir );
+		struct dirent *entry;
+		while( ( entry = readdir( dir ) ) != NULL ) {
+			if( strncmp( entry->d_name, prefix, strlen( prefix ) ) == 0 ) {
+				unlinkat( dirfd( dir ), entry->d_name, 0 );
+			}
+		}
+		closedir( dir );
+		
+		g_printer = xlog_printer_create( XLOG_PRINTER_FILES_DAILY | XLOG_PRINTER_OROLLOVER, "./logs/rollover-file.txt", 1U );
+		XLOG_ASSERT( g_printer );
+		int first = xlog_printer_append( g_printer, "first\n", 6, XLOG_LEVEL_INFO, NULL );
+		usleep( 1100 * 1000 );
+		int second = xlog_printer_append( g_printer, "second\n", 7, XLOG_LEVEL_INFO, NULL );
+		int third = xlog_printer_append( g_printer, "third\n", 6, XLOG_LEVEL_INFO, NULL );
+		XLOG_ASSERT( first == 6 && second == 7 && third == 6 );
+		xlog_printer_destory( g_printer );
+		g_printer = NULL;
+		
+		unsigned int files = 0;
+		off_t total = 0;
+		dir = opendir( "./logs" );
+		XLOG_ASSERT( dir );
+		while( ( entry = readdir( dir ) ) != NULL ) {
+			struct stat st;
+			if( strncmp( entry->d_name, prefix, strlen( prefix ) ) == 0 && fstatat( dirfd( dir ), entry->d_name, &st, 0 ) == 0 ) {
+				files ++;
+				total += st.st_size;
+			}
+		}
+		closedir( dir );
+		XLOG_ASSERT( files == 2 && total == 19 );
+		fprintf(stderr, "End of ROLLOVER\n" );
+	}
+	
+	// NOTE: processes forked log via ring-buffer in shared memory, drained here as xlog-drain does
+	{
+		const char *name = "/xlog-cov-printer";
+		ringbuf_unlink_shared( name );
+		ringbuf_t *rbuff = ringbuf_open_shared( name, 64 * 1024, RINGBUF_OLOCKFREE );
+		XLOG_ASSERT( rbuff );
+		pid_t pids[2];
+		for( int k = 0; k < 2; k ++ ) {
+			pids[k] = fork();
+			XLOG_ASSERT( pids[k] >= 0 );
+			if( pids[k] == 0 ) {
+				g_printer = xlog_printer_create( XLOG_PRINTER_SHMRING, name, ( size_t )( 64 * 1024 ) );
+				if( g_printer ) {
+					cov_producer_thread( buffer );
+					xlog_printer_destory( g_printer );
+				}
+				_exit( g_printer ? 0 : 1 );
+			}
+		}
+		unsigned int records = 0;
+		while( records < 2 * 80 ) {
+			ringbuf_record_t record;
+			char text[1024];
+			if( ringbuf_read_record( rbuff, &record, text, sizeof( text ) ) == 0 ) {
+				XLOG_ASSERT( record.length > 0 && record.length <= sizeof( text ) && text[record.length - 1] == '\n' );
+				records ++;
+			} else {
+				ringbuf_wait( rbuff, 100 );
+			}
+		}
+		for( int k = 0; k < 2; k ++ ) {
+			int status = -1;
+			pid_t pid = waitpid( pids[k], &status, 0 );
+			XLOG_ASSERT( pid == pids[k] && WIFEXITED( status ) && WEXITSTATUS( status ) == 0 );
+		}
+		
+		/* length appended returned, as other printers do */
+		g_printer = xlog_printer_create( XLOG_PRINTER_SHMRING, name, ( size_t )( 64 * 1024 ) );
+		XLOG_ASSERT( g_printer );
+		int length = xlog_printer_append( g_printer, "shmring\n", 8, XLOG_LEVEL_INFO, NULL );
+		XLOG_ASSERT( length == 8 );
+		xlog_printer_destory( g_printer );
+		g_printer = NULL;
+		ringbuf_record_t record;
+		char text[16];
+		int error = ringbuf_read_record( rbuff, &record, text, sizeof( text ) );
+		XLOG_ASSERT( error == 0 && record.length == 8 && memcmp( text, "shmring\n", 8 ) == 0 );
+		
+		ringbuf_destory( rbuff );
+		error = ringbuf_unlink_shared( name );
+		XLOG_ASSERT( error == 0 );
+		fprintf(stderr, "End of SHMRING\n" );
+	}
+	
+	// NOTE: flight recorder of process killed, records kept in file and read back
+	{
+		const char *file = "./logs/flight-recorder.bin";
+		unlink( file );
+		pid_t pid = fork();
+		XLOG_ASSERT( pid >= 0 );
+		if( pid == 0 ) {
+			g_printer = xlog_printer_create( XLOG_PRINTER_FILES_MAPPED, file, ( size_t )( 16 * 1024 ) );
+			for( int i = 0; g_printer && i < 2000; i ++ ) {
+				log_w( "flight %d", i );
+			}
+			raise( SIGKILL );
+		}
+		int status = -1;
+		pid_t reaped = waitpid( pid, &status, 0 );
+		XLOG_ASSERT( reaped == pid && WIFSIGNALED( status ) );
+		
+		/* the latest records kept, in order, the oldest evicted */
+		for( int round = 0; round < 2; round ++ ) {
+			ringbuf_t *rbuff = ringbuf_recover_file( round == 0 ? file : "./logs/flight-recorder.bin.last" );
+			XLOG_ASSERT( rbuff );
+			int last = -1, records = 0;
+			ringbuf_record_t record;
+			char text[1024];
+			while( ringbuf_read_record( rbuff, &record, text, sizeof( text ) - 1 ) == 0 ) {
+				text[record.length] = '\0';
+				const char *found = strstr( text, "flight " );
+				XLOG_ASSERT( found && text[record.length - 1] == '\n' );
+				int index = atoi( found + strlen( "flight " ) );
+				XLOG_ASSERT( last < 0 || index == last + 1 );
+				last = index;
+				records ++;
+			}
+			uint64_t evicted = 0;
+			ringbuf_dropped( rbuff, &evicted, NULL );
+			XLOG_ASSERT( last == 1999 && records > 0 && evicted + records == 2000 );
+			ringbuf_destory( rbuff );
+			if( round == 0 ) {
+				/* file of the last run renamed on creating */
+				g_printer = xlog_printer_create( XLOG_PRINTER_FILES_MAPPED, file, ( size_t )( 16 * 1024 ) );
+				XLOG_ASSERT( g_printer );
+				/* length appended returned, as other printers do */
+				int length = xlog_printer_append( g_printer, "flight\n", 7, XLOG_LEVEL_INFO, NULL );
+				XLOG_ASSERT( length == 7 );
+				xlog_printer_destory( g_printer );
+				g_printer = NULL;
+			}
+		}
+		fprintf(stderr, "End of FILES-MAPPED\n" );
+	}
+	
+	// NOTE: colorful output of printer defined by user, queried on first use
+	{
+		#if (defined XLOG_FEATURE_ENABLE_COLOR)
+		xlog_printer_t user_printer = {
+			#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
+			.magic = XLOG_MAGIC_PRINTER,
+			#endif
+			.append = cov_user_append,
+			.optctl = cov_user_optctl,
+		};
+		cov_user_text[0] = '\0';
+		xlog_output_fmtlog( &user_printer, NULL, XLOG_LEVEL_INFO, __FILE__, __func__, __LINE__, "colorful %d", 1 );
+		XLOG_ASSERT( strstr( cov_user_text, "colorful 1" ) && strstr( cov_user_text, "\033[" ) );
+		fprintf(stderr, "End of USER-PRINTER-ABICLR\n" );
+		#endif
+	}
+	
 	// NULL module and empty thread name test
 	{
 		#undef XLOG_MODULE
@@ -15,6 +15,8 @@
 #include <xlog/xlog_helper.h>
 
 static int shell_make_args( char *, int *, char **, int );
+static int shell_run( const char *cmdline );
+static int callsite_output( const char *tag );
 
 /*
 system
@@ -97,7 +99,7 @@ int main( int argc, char **argv )
 		char *targv[10];
 		shell_make_args( cmdline, &targc, targv, 10 );
 		xlog_shell_main( XLOG_CONTEXT, targc, targv );
-
+		
 		#undef XLOG_MODULE
 		#define XLOG_MODULE m_network_http
 		log_d( "Never Print" );
@@ -168,6 +170,27 @@ int main( int argc, char **argv )
 		xlog_shell_main( XLOG_CONTEXT, targc, targv );
 	}
 	
+	{
+		xlog_module_set_level( XLOG_MODULE, XLOG_LEVEL_DEBUG, XLOG_LEVEL_OFORCE );
+		int length = callsite_output( "default" );
+		assert( length > 0 );
+		
+		int status = shell_run( "debug --off --func=callsite_output" );
+		length = callsite_output( "off" );
+		assert( status == 0 && length == 0 );
+		shell_run( "debug --sites --file=cov-shell.c" );
+		
+		xlog_module_set_level( XLOG_MODULE, XLOG_LEVEL_SILENT, 0 );
+		status = shell_run( "debug --on --file=cov-shell.c --format=Call-site" );
+		length = callsite_output( "on" );
+		assert( status == 0 && length > 0 );
+		
+		status = shell_run( "debug --reset" );
+		length = callsite_output( "reset" );
+		assert( status == 0 && length == 0 );
+		shell_run( "debug --sites" );
+	}
+	
 	xlog_module_set_level( ROOT_MODULE, XLOG_LEVEL_VERBOSE, XLOG_LEVEL_ORECURSIVE | XLOG_LEVEL_OFORCE );
 	
 	xlog_list_modules( NULL, XLOG_LIST_OWITH_TAG | XLOG_LIST_OALL );
@@ -179,6 +202,22 @@ int main( int argc, char **argv )
 	return 0;
 }
 
+static int callsite_output( const char *tag )
+{
+	return log_d( "Call-site %s.\n", tag );
+}
+
+static int shell_run( const char *cmdline )
+{
+	char buffer[256];
+	int targc;
+	char *targv[10];
+	snprintf( buffer, sizeof( buffer ), "%s", cmdline );
+	shell_make_args( buffer, &targc, targv, 10 );
+	
+	return xlog_shell_main( XLOG_CONTEXT, targc, targv );
+}
+
 static int shell_make_args( char *cmdline, int *argc_p, char **argv_p, int max_args )
 {
 	assert( cmdline );
@@ -0,0 +1,154 @@
+#include <signal.h>
+
+#include <xlog/xlog.h>
+#include <xlog/xlog_helper.h>
+#include <xlog/plugins/ringbuf.h>
+
+#ifdef __GNUC__
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#pragma GCC diagnostic ignored "-Wshorten-64-to-32"
+#endif
+
+#define DRAIN_BATCH_SIZE		( 256 * 1024 )
+#define DRAIN_BATCH_RECORDS		64
+#define DRAIN_WAIT_MS			100
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void drain_stop( int signo )
+{
+	( void )signo;
+	g_stop = 1;
+}
+
+static void drain_usage( const char *prog )
+{
+	fprintf( stderr,
+		"Usage: %s [-c capacity] [-t basic|rotating|daily] [-s size] [-n files] [-u] name file\n"
+		"  drain shared ring-buffer of name(e.g. /xlog) written by XLOG_PRINTER_SHMRING into file(\"-\" for stdout)\n"
+		"  -c capacity of ring-buffer if created here, 8MB by default\n"
+		"  -t type of file printer, basic by default\n"
+		"  -s/-n max size per file and files to rotate, for rotating\n"
+		"  -u unlink ring-buffer on exit\n",
+		prog
+	);
+}
+
+/* write out records of batch, in one call if printer takes vectors */
+static void drain_flush( xlog_printer_t *printer, const struct iovec *iov, int iovcnt )
+{
+	if( iovcnt == 0 ) {
+		return;
+	}
+	if( printer->appendv ) {
+		printer->appendv( printer, iov, iovcnt );
+	} else {
+		for( int i = 0; i < iovcnt; i ++ ) {
+			xlog_printer_append( printer, iov[i].iov_base, iov[i].iov_len, XLOG_LEVEL_SILENT, NULL );
+		}
+	}
+}
+
+int main( int argc, char **argv )
+{
+	size_t capacity = 8 * 1024 * 1024;
+	const char *type = "basic";
+	size_t max_size = 16 * 1024 * 1024, max_files = 8;
+	bool unlink_on_exit = false;
+	int opt;
+	while( ( opt = getopt( argc, argv, "c:t:s:n:uh" ) ) != -1 ) {
+		switch( opt ) {
+			case 'c': capacity = strtoul( optarg, NULL, 0 ); break;
+			case 't': type = optarg; break;
+			case 's': max_size = strtoul( optarg, NULL, 0 ); break;
+			case 'n': max_files = strtoul( optarg, NULL, 0 ); break;
+			case 'u': unlink_on_exit = true; break;
+			default: drain_usage( argv[0] ); return EXIT_FAILURE;
+		}
+	}
+	if( argc - optind != 2 ) {
+		drain_usage( argv[0] );
+		return EXIT_FAILURE;
+	}
+	const char *name = argv[optind], *file = argv[optind + 1];
+	
+	xlog_printer_t *printer = NULL;
+	if( strcmp( file, "-" ) == 0 ) {
+		printer = xlog_printer_create( XLOG_PRINTER_STDOUT );
+	} else if( strcmp( type, "basic" ) == 0 ) {
+		printer = xlog_printer_create( XLOG_PRINTER_FILES_BASIC, file );
+	} else if( strcmp( type, "rotating" ) == 0 ) {
+		printer = xlog_printer_create( XLOG_PRINTER_FILES_ROTATING, file, max_size, max_files );
+	} else if( strcmp( type, "daily" ) == 0 ) {
+		printer = xlog_printer_create( XLOG_PRINTER_FILES_DAILY, file );
+	}
+	if( printer == NULL ) {
+		fprintf( stderr, "Failed to create printer of %s(%s).\n", file, type );
+		return EXIT_FAILURE;
+	}
+	ringbuf_t *rbuff = ringbuf_open_shared( name, capacity, RINGBUF_OLOCKFREE );
+	if( rbuff == NULL ) {
+		fprintf( stderr, "Failed to open %s: %s.\n", name, strerror( errno ) );
+		xlog_printer_destory( printer );
+		return EXIT_FAILURE;
+	}
+	
+	/* NOTE: records are at most half of the capacity */
+	size_t batch_size = rbuff->capacity / 2 + 1 > DRAIN_BATCH_SIZE ? rbuff->capacity / 2 + 1 : DRAIN_BATCH_SIZE;
+	char *batch = ( char * )malloc( batch_size );
+	if( batch == NULL ) {
+		ringbuf_destory( rbuff );
+		xlog_printer_destory( printer );
+		return EXIT_FAILURE;
+	}
+	
+	signal( SIGINT, drain_stop );
+	signal( SIGTERM, drain_stop );
+	signal( SIGPIPE, SIG_IGN );
+	
+	struct iovec iov[DRAIN_BATCH_RECORDS];
+	int iovcnt = 0;
+	size_t used = 0;
+	while( true ) {
+		/* NOTE: check stop flag before reading, or records appended right before stopping are lost */
+		bool stop = g_stop != 0;
+		ringbuf_record_t record;
+		if( ringbuf_peek_record( rbuff, &record ) == 0 ) {
+			if( iovcnt == DRAIN_BATCH_RECORDS || used + record.length + 1 > batch_size ) {
+				drain_flush( printer, iov, iovcnt );
+				iovcnt = 0;
+				used = 0;
+			}
+			ringbuf_read_record( rbuff, &record, batch + used, batch_size - used - 1 );
+			batch[used + record.length] = '\0';
+			iov[iovcnt].iov_base = batch + used;
+			iov[iovcnt].iov_len = record.length;
+			iovcnt ++;
+			used += record.length + 1;
+			continue;
+		}
+		drain_flush( printer, iov, iovcnt );
+		iovcnt = 0;
+		used = 0;
+		if( stop ) {
+			break;
+		}
+		ringbuf_wait( rbuff, DRAIN_WAIT_MS );
+	}
+	
+	uint64_t records = 0, bytes = 0;
+	ringbuf_dropped( rbuff, &records, &bytes );
+	if( records ) {
+		fprintf( stderr, "%llu records(%llu bytes) dropped by producers.\n", ( unsigned long long )records, ( unsigned long long )bytes );
+	}
+	free( batch );
+	ringbuf_destory( rbuff );
+	if( unlink_on_exit ) {
+		ringbuf_unlink_shared( name );
+	}
+	xlog_printer_destory( printer );
+	
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,65 @@
+#include <xlog/xlog.h>
+#include <xlog/xlog_helper.h>
+#include <xlog/plugins/ringbuf.h>
+
+#ifdef __GNUC__
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#pragma GCC diagnostic ignored "-Wshorten-64-to-32"
+#endif
+
+static void recover_usage( const char *prog )
+{
+	fprintf( stderr,
+		"Usage: %s [-t] file\n"
+		"  write records in flight recorder file of XLOG_PRINTER_FILES_MAPPED to stdout, the oldest first\n"
+		"  -t prefix records with nanoseconds since epoch when committed\n",
+		prog
+	);
+}
+
+int main( int argc, char **argv )
+{
+	bool timestamp = false;
+	int opt;
+	while( ( opt = getopt( argc, argv, "th" ) ) != -1 ) {
+		switch( opt ) {
+			case 't': timestamp = true; break;
+			default: recover_usage( argv[0] ); return EXIT_FAILURE;
+		}
+	}
+	if( argc - optind != 1 ) {
+		recover_usage( argv[0] );
+		return EXIT_FAILURE;
+	}
+	
+	ringbuf_t *rbuff = ringbuf_recover_file( argv[optind] );
+	if( rbuff == NULL ) {
+		fprintf( stderr, "Failed to recover %s: %s.\n", argv[optind], strerror( errno ) );
+		return EXIT_FAILURE;
+	}
+	/* NOTE: records are at most half of the capacity */
+	char *text = ( char * )malloc( rbuff->capacity / 2 + 1 );
+	if( text == NULL ) {
+		ringbuf_destory( rbuff );
+		return EXIT_FAILURE;
+	}
+	
+	unsigned long long records = 0;
+	ringbuf_record_t record;
+	while( ringbuf_read_record( rbuff, &record, text, rbuff->capacity / 2 + 1 ) == 0 ) {
+		if( timestamp ) {
+			fprintf( stdout, "%llu ", ( unsigned long long )record.timestamp );
+		}
+		fwrite( text, 1, record.length, stdout );
+		records ++;
+	}
+	uint64_t evicted = 0;
+	ringbuf_dropped( rbuff, &evicted, NULL );
+	fprintf( stderr, "%llu records recovered, %llu older evicted.\n", records, ( unsigned long long )evicted );
+	free( text );
+	ringbuf_destory( rbuff );
+	
+	return EXIT_SUCCESS;
+}
@@ -80,6 +80,9 @@ typedef struct {
 #define AUTOBUF_TEXT_COMPATIBLE(options)		!AUTOBUF_TEST_OPTION(options, AUTOBUF_OBINARY)
 #define AUTOBUF_BINARY_COMPATIBLE(options)		!AUTOBUF_TEST_OPTION(options, AUTOBUF_OTEXT)
 
+/** size of storage for autobuf attached to pre-allocated buffer(@see autobuf_attach) */
+#define AUTOBUF_ATTACHED_SIZE		( sizeof( autobuf_t ) + sizeof( void * ) )
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -96,6 +99,21 @@ extern "C" {
  */
 API_PUBLIC( autobuf_t * ) autobuf_create( unsigned int id, const char *brief, int options, ... );
 
+/**
+ * @brief  attach a fixed autobuf object to pre-allocated buffer, without allocating
+ *
+ * @param  storage, storage of autobuf object, AUTOBUF_ATTACHED_SIZE bytes at least
+ *         id, autobuf identifier(@see XLOG_PAYLOAD_ID_xxx)
+ *         brief, brief info of autobuf
+ *         options, AUTOBUF_OTEXT or AUTOBUF_OBINARY, AUTOBUF_OFIXED implied
+ *         vptr/size, pre-allocated buffer
+ * @return pointer to `autobuf_t` in storage.
+ *
+ * @note   do NOT destory the autobuf attached, appending beyond the buffer fails with EOVERFLOW.
+ *
+ */
+API_PUBLIC( autobuf_t * ) autobuf_attach( void *storage, unsigned int id, const char *brief, int options, void *vptr, size_t size );
+
 /**
  * @brief  resize data field of autobuf object
  *
@@ -134,6 +152,16 @@ API_PUBLIC( void * ) autobuf_data_vptr( const autobuf_t *autobuf );
  */
 API_PUBLIC( int ) autobuf_append_text( autobuf_t **autobuf, const char *text );
 
+/**
+ * @brief  append text of known length to a autobuf object
+ *
+ * @param  autobuf, autobuf object
+ *         text/textlen, text to append, '\0' not included in textlen
+ * @return error code(@see XLOG_Exxx).
+ *
+ */
+API_PUBLIC( int ) autobuf_append_text_n( autobuf_t **autobuf, const char *text, size_t textlen );
+
 /**
  * @brief  append text to a autobuf object
  *
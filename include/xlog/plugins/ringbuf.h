@@ -27,14 +27,61 @@
 extern "C" {
 #endif
 
+/** options of ring-buffer */
+#define RINGBUF_OLOCKFREE	0x01	/* lock-free, multi-producer/single-consumer */
+#define RINGBUF_OFRAMED		0x02	/* records carry header(ringbuf_record_t), implied by RINGBUF_ODROP_OLD */
+#define RINGBUF_OPOW2		0x04	/* size of power of two, offsets masked instead of modulo */
+#define RINGBUF_OHUGEPAGE	0x08	/* data backed by huge pages(MAP_HUGETLB, or transparent) and pre-faulted */
+#define RINGBUF_OMLOCK		0x80	/* data locked in memory(mlock), pre-faulted */
+
+/** overflow policies of ring-buffer, applied when there is no space for data */
+#define RINGBUF_OBLOCK		0x00	/* wait for consumer */
+#define RINGBUF_OTIMEOUT	0x10	/* wait for consumer, dropped after timeout(ringbuf_set_timeout) */
+#define RINGBUF_ODROP_NEW	0x20	/* drop data given */
+#define RINGBUF_ODROP_OLD	0x30	/* evict the oldest records, NOT lock-free */
+#define RINGBUF_OVERFLOW(options)	((options) & 0x70)
+
+#define RINGBUF_CACHELINE_SIZE	64
+#ifdef __GNUC__
+#define RINGBUF_CACHELINE_ALIGNED	__attribute__((aligned(RINGBUF_CACHELINE_SIZE)))
+#else
+#define RINGBUF_CACHELINE_ALIGNED
+#endif
+
+/** header of record, read by ringbuf_peek_record/ringbuf_read_record */
+typedef struct {
+	unsigned int length;	/* length of data */
+	unsigned int level;		/* level given by producer, 0~255 */
+	uint64_t timestamp;		/* nanoseconds since epoch when committed, zero if NOT RINGBUF_OFRAMED */
+} ringbuf_record_t;
+
 typedef struct __ringbuf {
 	pthread_mutex_t mutex;
 	pthread_cond_t  cond_data_out;
 	pthread_cond_t  cond_data_in;
 	
 	unsigned int capacity; /* capacity = size - 1, one byte for detecting the full condition. */
-	unsigned int rd_offset, wr_offset;
-	char *data;
+	uint64_t mask;				/* size - 1 if RINGBUF_OPOW2, or zero */
+	char *data;					/* NULL if mapped from shared memory or file, data follows the header */
+	size_t mapped;				/* bytes of data mapped if RINGBUF_OHUGEPAGE, of header and data if shared */
+	unsigned int shared;		/* magic if mapped(ringbuf_open_shared/ringbuf_open_file), or zero */
+	bool locked;				/* data locked by RINGBUF_OMLOCK */
+	int options;
+	unsigned int timeout_ms;	/* timeout of RINGBUF_OTIMEOUT */
+	bool wakeup;				/* consumer woken up by ringbuf_wakeup, protected by mutex */
+	
+	/* state of producers and consumer on separate cache lines, RINGBUF_OLOCKFREE uses monotonic positions */
+	unsigned int wr_offset RINGBUF_CACHELINE_ALIGNED;
+	uint64_t wr_reserved;		/* reserved by producers */
+	uint64_t dropped_records;	/* dropped by overflow policy */
+	uint64_t dropped_bytes;
+	int parked;					/* consumer sleeping on cond_data_in, producers signal only if set */
+	unsigned int rd_offset RINGBUF_CACHELINE_ALIGNED;
+	uint64_t rd_released;		/* released by consumer, data before is zeroed */
+	int wr_parked;				/* producers sleeping on cond_data_out if RINGBUF_OLOCKFREE, consumer signals only if set */
+	unsigned int rd_partial;	/* bytes of current record read */
+	uint64_t rd_stalled;		/* position of the oldest record found reserved but NOT committed */
+	uint64_t rd_stalled_ns;		/* since when it's found, zero if NOT stalled */
 } ringbuf_t;
 
 /* @brief  create ring-buffer
@@ -45,6 +92,71 @@ typedef struct __ringbuf {
  **/
 ringbuf_t *ringbuf_create( unsigned int capacity );
 
+/* @brief  create ring-buffer with options
+ * @param  capacity, capacity of ring-buffer
+ *         options, RINGBUF_Oxxx
+ * @return pointer to ring-buffer; NULL if failed to allocate memory
+ * @note   1. with RINGBUF_OLOCKFREE, producers reserve space by CAS and commit records by flags,
+ *         ringbuf_copy_from and ringbuf_findchr MUST be called by a single consumer.
+ *         2. with RINGBUF_OPOW2, capacity + 1 is rounded up to power of two(1024 at least),
+ *         free-running positions of RINGBUF_OLOCKFREE are masked instead of modulo.
+ *         3. with RINGBUF_OHUGEPAGE, data is mapped in multiples of 2MB, MAP_HUGETLB tried first,
+ *         then transparent huge pages, all pages faulted in before returned.
+ *         4. with RINGBUF_OMLOCK, failure of mlock(e.g. RLIMIT_MEMLOCK) is NOT fatal, see `locked`.
+ **/
+ringbuf_t *ringbuf_create_ex( unsigned int capacity, int options );
+
+/* @brief  create or attach ring-buffer in POSIX shared memory
+ * @param  name, name of shared memory, e.g. "/xlog"
+ *         capacity/options, of ring-buffer if created, those of ring-buffer existing are taken if attached
+ * @return pointer to ring-buffer; NULL if failed(errno set)
+ * @note   1. RINGBUF_OLOCKFREE recommended, producers of all processes reserve space by CAS,
+ *         a single consumer of all processes drains it, e.g. xlog-drain.
+ *         2. owner(pid) of record is kept in header until committed, record of producer exited without
+ *         committing is skipped by consumer after a while(dropped), its process MUST be reaped by parent.
+ *         3. RINGBUF_OHUGEPAGE and RINGBUF_OMLOCK are ignored.
+ *         4. ringbuf_destory detaches it only, removed by ringbuf_unlink_shared.
+ **/
+ringbuf_t *ringbuf_open_shared( const char *name, unsigned int capacity, int options );
+
+/* @brief  remove name of ring-buffer in shared memory
+ * @param  name, name of shared memory
+ * @return error code
+ * @note   ring-buffer attached is valid until destoryed
+ **/
+int ringbuf_unlink_shared( const char *name );
+
+/* @brief  create ring-buffer backed by file, e.g. flight recorder surviving crash of process
+ * @param  path, file to create, truncated if existing
+ *         capacity/options, of ring-buffer
+ * @return pointer to ring-buffer; NULL if failed(errno set)
+ * @note   1. same layout as ringbuf_open_shared, pages kept by kernel after crash of process,
+ *         read back by ringbuf_recover_file.
+ *         2. records are published after copied, the one being copied when crashed is NOT recovered.
+ *         3. ringbuf_destory unmaps it only, file is kept.
+ **/
+ringbuf_t *ringbuf_open_file( const char *path, unsigned int capacity, int options );
+
+/* @brief  map ring-buffer of file left by ringbuf_open_file for reading, file NOT modified
+ * @param  path, file of ring-buffer
+ * @return pointer to ring-buffer; NULL if failed(errno set, EPROTO if NOT a ring-buffer)
+ * @note   records are read by ringbuf_read_record or ringbuf_copy_from, in order written;
+ *         mapped copy-on-write, locks held by the process crashed are reinitialized.
+ **/
+ringbuf_t *ringbuf_recover_file( const char *path );
+
+/* @brief  set timeout of RINGBUF_OTIMEOUT
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         timeout_ms, max time to wait for space
+ **/
+void ringbuf_set_timeout( ringbuf_t *rb, unsigned int timeout_ms );
+
+/* @brief  get statistics of data dropped by overflow policy
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         records/bytes, dropped records and bytes, NULL to ignore
+ **/
+void ringbuf_dropped( const ringbuf_t *rb, uint64_t *records, uint64_t *bytes );
+
 /* @brief  destory ring-buffer
  * @param  rb, pointer to ring-buffer
  * @return error code(always zero for this interface)
@@ -55,7 +167,7 @@ int ringbuf_destory( ringbuf_t *rb );
  * @param  rb, pointer to ring-buffer(Non-NULL required)
  *         vptr/size, data to copy into
  *         block_size, minimal size of block to copy each time
- * @return error code(always zero for this interface)
+ * @return error code(EAGAIN/ETIMEDOUT if the rest of data dropped by overflow policy)
  * @note   1. data given may be separated into several fragments
  *         2. but NO LIMIT on size of data
  **/
@@ -64,10 +176,49 @@ int ringbuf_copy_into_separable( ringbuf_t *rb, const void *vptr, unsigned int s
 /* @brief  copy data to ring-buffer
  * @param  rb, pointer to ring-buffer(Non-NULL required)
  *         vptr/size, data to copy into ring-buffer
- * @return error code(EINVAL if size of data larger than half of the capacity)
+ * @return error code(EINVAL if size of data larger than half of the capacity,
+ *         EAGAIN/ETIMEDOUT if dropped by overflow policy)
  **/
 int ringbuf_copy_into( ringbuf_t *rb, const void *vptr, unsigned int size );
 
+/* @brief  copy a record of level given to ring-buffer
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         vptr/size, data of record
+ *         level, level of record, 0~255
+ * @return error code(EINVAL if size of data larger than half of the capacity,
+ *         EAGAIN/ETIMEDOUT if dropped by overflow policy)
+ * @note   level and timestamp are kept only if RINGBUF_OLOCKFREE or RINGBUF_OFRAMED
+ **/
+int ringbuf_copy_into_record( ringbuf_t *rb, const void *vptr, unsigned int size, unsigned int level );
+
+/* @brief  reserve contiguous space for a record, filled in place and then committed
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         size, max size of the record
+ *         vptr, pointer to space reserved
+ * @return error code(ENOTSUP if neither RINGBUF_OLOCKFREE nor RINGBUF_OFRAMED,
+ *         EINVAL if size larger than half of the capacity, EAGAIN/ETIMEDOUT by overflow policy)
+ * @note   1. space at the end of ring is skipped by a padding record if the record wraps
+ *         2. ringbuf_commit MUST follow on the same thread, mutex is held in between if NOT lock-free
+ **/
+int ringbuf_reserve( ringbuf_t *rb, unsigned int size, void **vptr );
+
+/* @brief  commit record reserved by ringbuf_reserve
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         vptr, pointer to space reserved
+ *         size, actual size of the record, no more than size reserved, zero to cancel
+ * @return error code(always zero for this interface)
+ **/
+int ringbuf_commit( ringbuf_t *rb, void *vptr, unsigned int size );
+
+/* @brief  commit record of level given, reserved by ringbuf_reserve
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         vptr, pointer to space reserved
+ *         size, actual size of the record, no more than size reserved, zero to cancel
+ *         level, level of record, 0~255
+ * @return error code(always zero for this interface)
+ **/
+int ringbuf_commit_record( ringbuf_t *rb, void *vptr, unsigned int size, unsigned int level );
+
 /* @brief  copy data from ring-buffer
  * @param  rb, pointer to ring-buffer(Non-NULL required)
  *         vptr/size, buffer to save copied data
@@ -76,6 +227,38 @@ int ringbuf_copy_into( ringbuf_t *rb, const void *vptr, unsigned int size );
  **/
 int ringbuf_copy_from( ringbuf_t *rb, void *vptr, unsigned int size, bool no_wait );
 
+/* @brief  get header of the oldest record in ring-buffer, NOT consumed
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         record, header of record
+ * @return error code(ENOTSUP if neither RINGBUF_OLOCKFREE nor RINGBUF_OFRAMED, EAGAIN if no record)
+ * @note   for the single consumer, e.g. to size buffer or skip by level before reading
+ **/
+int ringbuf_peek_record( ringbuf_t *rb, ringbuf_record_t *record );
+
+/* @brief  read the oldest record in ring-buffer as a whole
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         record, header of record read, NULL to ignore
+ *         vptr/size, buffer to save data, the rest of record larger than size is skipped
+ * @return error code(ENOTSUP if neither RINGBUF_OLOCKFREE nor RINGBUF_OFRAMED, EAGAIN if no record)
+ * @note   1. for the single consumer, NOT blocked, wait by ringbuf_wait
+ *         2. record evicted by RINGBUF_ODROP_OLD after peeking, header returned is of the record read
+ *         3. only the rest is read if record partially read by ringbuf_copy_from
+ **/
+int ringbuf_read_record( ringbuf_t *rb, ringbuf_record_t *record, void *vptr, unsigned int size );
+
+/* @brief  wait for data in ring-buffer: spin briefly, then yield, and then sleep
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         timeout_ms, max time to sleep, 0 to sleep until data in or woken up
+ * @return true if there is data in ring-buffer
+ * @note   for the single consumer, producers signal it only when it's sleeping
+ **/
+bool ringbuf_wait( ringbuf_t *rb, unsigned int timeout_ms );
+
+/* @brief  wake up consumer waiting in ringbuf_wait, e.g. to exit
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ **/
+void ringbuf_wakeup( ringbuf_t *rb );
+
 /* @brief  Locate the first occurrence of character c in ring-buffer
  * @param  rb, pointer to ring-buffer(Non-NULL required)
  *         c, character to locate
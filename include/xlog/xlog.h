@@ -39,10 +39,33 @@ extern "C" {
 #define XLOG_PRINTER_FILES_ROTATING	XLOG_PRINTER_TYPE_OPT(4)
 #define XLOG_PRINTER_FILES_DAILY	XLOG_PRINTER_TYPE_OPT(5)
 #define XLOG_PRINTER_RINGBUF		XLOG_PRINTER_TYPE_OPT(6)
+#define XLOG_PRINTER_SHMRING		XLOG_PRINTER_TYPE_OPT(7)	/**< ring-buffer in POSIX shared memory, drained by xlog-drain */
+#define XLOG_PRINTER_FILES_MAPPED	XLOG_PRINTER_TYPE_OPT(8)	/**< flight recorder in ring-buffer mapped from file, read by xlog-recover */
 
 #define XLOG_PRINTER_BUFF_NONE		XLOG_PRINTER_BUFF_OPT(0)
 #define XLOG_PRINTER_BUFF_RINGBUF	XLOG_PRINTER_BUFF_OPT(1)
 #define XLOG_PRINTER_BUFF_NCPYRBUF	XLOG_PRINTER_BUFF_OPT(2)
+#define XLOG_PRINTER_BUFF_DEFERRED	XLOG_PRINTER_BUFF_OPT(3)	/**< format on consumer thread */
+
+/** xlog printer flags */
+#define XLOG_PRINTER_OLOCKFREE		BIT_MASK(8)	/**< lock-free MPSC ring-buffer, for XLOG_PRINTER_RINGBUF and ring-buffer buffering */
+#define XLOG_PRINTER_OPERTHREAD		BIT_MASK(12)	/**< SPSC ring-buffer per producer thread, for XLOG_PRINTER_BUFF_RINGBUF */
+#define XLOG_PRINTER_OORDERED		BIT_MASK(13)	/**< records of XLOG_PRINTER_OPERTHREAD merged by timestamp, implies it */
+#define XLOG_PRINTER_OHUGEPAGE		BIT_MASK(14)	/**< ring-buffer backed by huge pages and pre-faulted */
+#define XLOG_PRINTER_OMLOCK			BIT_MASK(15)	/**< ring-buffer locked in memory and pre-faulted */
+#define XLOG_PRINTER_OCOALESCE		BIT_MASK(16)	/**< records of file printers coalesced in buffer, written out once full or late */
+#define XLOG_PRINTER_OROLLOVER		BIT_MASK(17)	/**< boundaries of XLOG_PRINTER_FILES_DAILY given in seconds */
+
+/** rollover boundaries of XLOG_PRINTER_FILES_DAILY, seconds after local midnight, or custom */
+#define XLOG_PRINTER_ROLLOVER_HOURLY	3600
+#define XLOG_PRINTER_ROLLOVER_DAILY		86400
+
+/** overflow policy of ring-buffer buffering, when ring-buffer is full */
+#define XLOG_PRINTER_OVERFLOW_BLOCK		XLOG_PRINTER_OVERFLOW_OPT(0)	/**< wait for space(default) */
+#define XLOG_PRINTER_OVERFLOW_TIMEOUT	XLOG_PRINTER_OVERFLOW_OPT(1)	/**< wait for space at most `timeout_ms`, then drop the newest */
+#define XLOG_PRINTER_OVERFLOW_DROP_NEW	XLOG_PRINTER_OVERFLOW_OPT(2)	/**< drop the newest record */
+#define XLOG_PRINTER_OVERFLOW_DROP_OLD	XLOG_PRINTER_OVERFLOW_OPT(3)	/**< evict the oldest records */
+#define XLOG_PRINTER_OVERFLOW_OVERWRITE	XLOG_PRINTER_OVERFLOW_OPT(4)	/**< flight recorder, keep the latest records until flushed */
 
 /** xlog format control options */
 #define XLOG_FORMAT_OTIME			BIT_MASK(0) /**< time */
@@ -110,6 +133,44 @@ XLOG_PUBLIC( xlog_t * ) xlog_module_context( const xlog_module_t *module );
  */
 XLOG_PUBLIC( int ) xlog_module_level_limit( const xlog_module_t *module );
 
+#if (defined XLOG_FEATURE_ENABLE_FAST_FILTER)
+/** generation of module tree, for internal use ONLY */
+extern XLOG_PUBLIC( unsigned int ) __xlog_module_generation;
+
+/**
+ * @brief  check if logging in this level will be dropped by module, without entering library
+ *
+ * @param  module, pointer to `xlog_module_t`
+ *         level, logging level
+ * @return true if dropped, false if not or undetermined(xlog_output_fmtlog will decide it).
+ *
+ */
+static inline bool xlog_module_fast_drop( xlog_module_t *module, int level )
+{
+	if( module == NULL ) {
+		return false;
+	}
+	#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
+	if( module->magic != XLOG_MAGIC_MODULE ) {
+		return false;
+	}
+	#endif
+	/* NOTE: generation loaded before the limit, pairs with the release in xlog_module_level_limit */
+	unsigned int generation = __atomic_load_n( &module->generation, __ATOMIC_ACQUIRE );
+	int limit = __atomic_load_n( &module->level_limit, __ATOMIC_RELAXED );
+	if( generation != __atomic_load_n( &__xlog_module_generation, __ATOMIC_ACQUIRE ) ) {
+		limit = xlog_module_level_limit( module );
+	}
+	if( XLOG_IF_DROP_LEVEL( level, limit ) ) {
+		XLOG_STATS_UPDATE( &module->stats, REQUEST, INPUT, 1 );
+		XLOG_STATS_UPDATE( &module->stats, REQUEST, DROPPED, 1 );
+		return true;
+	}
+	
+	return false;
+}
+#endif
+
 /**
  * @brief  get name of module
  *
@@ -191,6 +252,42 @@ XLOG_PUBLIC( int ) xlog_close( xlog_t *context, int option );
  */
 XLOG_PUBLIC( int ) xlog_version( char *buffer, int size );
 
+/**
+ * @brief  format log-time as "MM/DD HH:MM:SS.mmm"
+ *
+ * @param  buffer/size, buffer to save formatted time
+ *         ts, time to format; NULL to read current time via XLOG_CLOCK_LOG_TIME
+ * @return length of formatted time, 0 if buffer is too small.
+ *
+ * @note   "MM/DD HH:MM:SS" is cached per thread and re-rendered once per second.
+ *
+ */
+XLOG_PUBLIC( int ) xlog_format_time( char *buffer, int size, const struct timespec *ts );
+
+/**
+ * @brief  set attributes of logging level
+ *
+ * @param  context, pointer to `xlog_t`
+ *         level, logging level
+ *         attributes, format and prefix/suffix of segments
+ * @return error code.
+ *
+ * @note   format plans are compiled from attributes and options of context,
+ *         changes of prefix/suffix written to `context->attributes` directly
+ *         will NOT take effect.
+ *
+ */
+XLOG_PUBLIC( int ) xlog_set_level_attributes( xlog_t *context, int level, const xlog_level_attr_t *attributes );
+
+/**
+ * @brief  invalidate cached task descriptor("[ppid/pid name] ") of current thread
+ *
+ * @note   called by XLOG_SET_THREAD_NAME and in child process after fork(),
+ *         call it if thread renamed in other ways.
+ *
+ */
+XLOG_PUBLIC( void ) xlog_task_invalidate( void );
+
 /**
  * @brief  list all modules under xlog context
  *
@@ -226,6 +323,39 @@ XLOG_PUBLIC( xlog_printer_t * ) xlog_printer_set_default( xlog_printer_t *printe
  * @param  options, options to create printer
  * @return pointer to printer
  *
+ * @note   XLOG_PRINTER_BUFF_DEFERRED copies arguments only and formats them on the consumer thread,
+ *         strings are copied, but context/module MUST outlive the printer(destory printer first).
+ *         formats are parsed once and kept until exit, XLOG_LIMIT_DEFERRED_FORMATS at most, logs of
+ *         formats beyond(e.g. built at runtime) are formatted immediately.
+ *         XLOG_PRINTER_OLOCKFREE replaces mutex of ring-buffer with atomic reservation,
+ *         producers spin and yield briefly, and then sleep until consumer frees space when it is full.
+ *         XLOG_PRINTER_OVERFLOW_xxx selects what ring-buffer buffering does when it is full,
+ *         XLOG_PRINTER_OVERFLOW_TIMEOUT takes `unsigned int timeout_ms` after capacity of ring-buffer.
+ *         records evicted by XLOG_PRINTER_OVERFLOW_DROP_OLD/OVERWRITE are NOT written lock-free,
+ *         XLOG_PRINTER_BUFF_NCPYRBUF drops the newest instead of evicting.
+ *         XLOG_PRINTER_OVERFLOW_OVERWRITE writes records out on XLOG_PRINTER_CTRL_FLUSH or destory only.
+ *         dropped records/bytes are counted in DROPPED of statistics, see XLOG_PRINTER_CTRL_GSTATS.
+ *         XLOG_PRINTER_OPERTHREAD gives each producer thread a ring-buffer of the capacity on its first record,
+ *         drained round-robin, or merged by timestamp if XLOG_PRINTER_OORDERED; rings of threads exited are
+ *         released once drained, the rest on destory.
+ *         XLOG_PRINTER_OHUGEPAGE/XLOG_PRINTER_OMLOCK back ring-buffer by huge pages or lock it in memory,
+ *         pages faulted in on creation, so that the first burst takes no page faults;
+ *         huge pages are mapped in multiples of 2MB, per thread if XLOG_PRINTER_OPERTHREAD.
+ *         XLOG_PRINTER_SHMRING takes `const char *name` and `size_t capacity`, creates or attaches
+ *         the lock-free ring-buffer in shared memory of the name, appended by processes attached,
+ *         drained by a single xlog-drain; XLOG_PRINTER_OVERFLOW_xxx of the creator applies to it,
+ *         `unsigned int timeout_ms` follows capacity if XLOG_PRINTER_OVERFLOW_TIMEOUT.
+ *         XLOG_PRINTER_FILES_MAPPED takes `const char *file` and `size_t capacity`, records are copied
+ *         into ring-buffer mapped from the file, the oldest evicted, kept by kernel if process crashed;
+ *         file of the last run is renamed to "<file>.last", both read back by xlog-recover.
+ *         XLOG_PRINTER_OCOALESCE makes XLOG_PRINTER_FILES_BASIC/ROTATING/DAILY take `size_t coalesce_size`
+ *         (XLOG_LIMIT_PRINTER_COALESCE if zero) and `unsigned int latency_ms` after arguments of file,
+ *         records are copied into buffer of the size and written out once it is full, bytes buffered
+ *         longer than latency_ms(never if zero), file rotated, XLOG_PRINTER_CTRL_FLUSH or destory.
+ *         XLOG_PRINTER_OROLLOVER makes XLOG_PRINTER_FILES_DAILY take `unsigned int rollover_sec` right after
+ *         file, e.g. XLOG_PRINTER_ROLLOVER_HOURLY, new file opened at local midnight and every rollover_sec
+ *         after it(daily if zero or XLOG_PRINTER_ROLLOVER_DAILY), checked against XLOG_CLOCK_LOG_TIME per record.
+ *
  */
 XLOG_PUBLIC( xlog_printer_t * ) xlog_printer_create( int options, ... );
 
@@ -240,6 +370,36 @@ XLOG_PUBLIC( xlog_printer_t * ) xlog_printer_create( int options, ... );
  */
 XLOG_PUBLIC( int ) xlog_printer_destory( xlog_printer_t *printer );
 
+/**
+ * @brief  append data of known length to printer
+ *
+ * @param  printer, printer to append
+ *         data/length, data to append
+ *         level, level of record, XLOG_LEVEL_SILENT if unknown
+ *         ts, time of record, NULL if unknown
+ * @return length appended, or result of printer.
+ *
+ * @note   printers without appendl are called via append, data MUST be terminated by '\0' for them.
+ *
+ */
+XLOG_PUBLIC( int ) xlog_printer_append(
+	xlog_printer_t *printer, const void *data, size_t length, int level, const struct timespec *ts
+);
+
+
+/**
+ * @brief  output autobuf to printer, autobuf is still owned by caller
+ *
+ * @param  printer, printer to print the autobuf
+ *         autobuf, autobuf object to print
+ * @return length of printed autobuf data
+ *
+ * @note   NOT for no-copy-buffering printer, use xlog_printer_take_over_autobuf instead
+ *
+ */
+XLOG_PUBLIC( int ) xlog_printer_print_autobuf(
+	xlog_printer_t *printer, autobuf_t **autobuf
+);
 
 /**
  * @brief  output and destory autobuf to printer
@@ -286,10 +446,102 @@ XLOG_PUBLIC( int ) xlog_output_fmtlog(
 	const char *format, ...
 );
 
+/**
+ * @brief  output formated log of call-site, register call-site at the first time
+ *
+ * @param  printer, printer to output log
+ *         module, logging module
+ *         callsite, static descriptor of call-site(level and source location)
+ * @return length of logging.
+ *
+ */
+XLOG_PUBLIC( int ) xlog_output_sitelog(
+	xlog_printer_t *printer,
+	xlog_module_t *module, xlog_callsite_t *callsite,
+	const char *format, ...
+);
+
+/**
+ * @brief  register call-site, fill cached fields and assign a stable id to it
+ *
+ * @param  callsite, static descriptor of call-site
+ *         module/format, module and format seen at the first time
+ * @return id of call-site, XLOG_CALLSITE_ID_OVERFLOW if registry is full.
+ *
+ */
+XLOG_PUBLIC( unsigned int ) xlog_callsite_register( xlog_callsite_t *callsite, xlog_module_t *module, const char *format );
+
+/**
+ * @brief  lookup call-site by id
+ *
+ * @param  id, id of call-site
+ * @return pointer to call-site, NULL if NOT registered.
+ *
+ */
+XLOG_PUBLIC( const xlog_callsite_t * ) xlog_callsite_lookup( unsigned int id );
+
+/** selector of call-sites, fields given are ANDed, NULL/0 to match any */
+typedef struct {
+	const char *file;		/**< source file, matched by path suffix */
+	long int line;			/**< line number */
+	const char *func;		/**< function name */
+	const char *format;		/**< substring of format */
+} xlog_callsite_match_t;
+
+/**
+ * @brief  switch call-sites matched on/off, applied to call-sites registered later too
+ *
+ * @param  match, selector of call-sites, NULL to match all
+ *         control, XLOG_CALLSITE_CTRL_ON/OFF, XLOG_CALLSITE_CTRL_DEFAULT to follow level of module
+ * @return error code.
+ *
+ */
+XLOG_PUBLIC( int ) xlog_callsite_control( const xlog_callsite_match_t *match, int control );
+
+/**
+ * @brief  list registered call-sites matched
+ *
+ * @param  match, selector of call-sites, NULL to list all
+ *
+ */
+XLOG_PUBLIC( void ) xlog_callsite_list( const xlog_callsite_match_t *match );
+
+/**
+ * @brief  check if call-site is enabled, register it at the first time
+ *
+ * @param  callsite, static descriptor of call-site
+ *         module/format, module and format of logging
+ * @return false if dropped, true if not or undetermined(xlog_output_sitelog will decide it).
+ *
+ * @note   switched-off call-site costs a single branch.
+ *
+ */
+static inline bool xlog_callsite_enabled( xlog_callsite_t *callsite, xlog_module_t *module, const char *format )
+{
+	int control = __atomic_load_n( &callsite->control, __ATOMIC_ACQUIRE );
+	if( control == XLOG_CALLSITE_CTRL_OFF ) {
+		return false;
+	}
+	if( control == XLOG_CALLSITE_CTRL_NONE ) {
+		xlog_callsite_register( callsite, module, format );
+		control = __atomic_load_n( &callsite->control, __ATOMIC_ACQUIRE );
+		if( control == XLOG_CALLSITE_CTRL_OFF ) {
+			return false;
+		}
+	}
+	#if (defined XLOG_FEATURE_ENABLE_FAST_FILTER)
+	if( control == XLOG_CALLSITE_CTRL_DEFAULT ) {
+		return !xlog_module_fast_drop( module, callsite->level );
+	}
+	#endif
+	
+	return true;
+}
+
 
 
 /*
- * Usage: debug [OPTIONS] MODULE[/SUB-MODULE/...]
+ * Usage: debug [OPTIONS] [MODULE[/SUB-MODULE/...]]
  *
  * Mandatory arguments to long options are mandatory for short options too.
  *   -f, --force        Update module's paramters forcibly,
@@ -301,6 +553,13 @@ XLOG_PUBLIC( int ) xlog_output_fmtlog(
  *   -l, --list         List modules in your application.
  *   -a, --all          Show all modules, include the hidden.
  *       --only         Only enable output of specified modules(disabling will be applied to other modules).
+ *       --file=FILE[:LINE]  Select call-sites by source file(path suffix) and line.
+ *       --func=FUNC    Select call-sites by function.
+ *       --format=TEXT  Select call-sites by substring of format.
+ *       --on           Enable call-sites selected regardless of module's level(default).
+ *       --off          Disable call-sites selected.
+ *       --reset        Make call-sites selected(all if no selector) follow module's level again.
+ *       --sites        List call-sites selected.
  *   -v, --version      Show version of logger.
  *   -h, --help         Display this help and exit.
  */
@@ -323,38 +582,60 @@ XLOG_PUBLIC( int ) xlog_shell_main( xlog_t *context, int argc, char **argv );
 
 #define log_r(...)	xlog_output_rawlog( XLOG_PRINTER, NULL, NULL, NULL, __VA_ARGS__ )
 
+/**
+ * NOTE:
+ *   with XLOG_FEATURE_ENABLE_CALLSITE, each log_x owns a static descriptor of call-site,
+ *   source location is passed once at registration instead of every call,
+ *   and the call-site can be switched on/off individually(format is evaluated for registration).
+ *   with XLOG_FEATURE_ENABLE_FAST_FILTER, arguments will NOT be evaluated
+ *   if logging was dropped by call-site or level of module
+ */
+#if (defined XLOG_FEATURE_ENABLE_CALLSITE) && (defined __GNUC__)
+#define __XLOG_FIRST_ARG(first, ...)	first
+#define __XLOG_FMTLOG(level, ...)	__extension__ ({ \
+	static xlog_callsite_t __xlog_callsite = XLOG_CALLSITE_INITIALIZER( level, __FILE__, __func__, __LINE__ ); \
+	xlog_callsite_enabled( &__xlog_callsite, XLOG_MODULE, __XLOG_FIRST_ARG( __VA_ARGS__, NULL ) ) ? \
+		xlog_output_sitelog( XLOG_PRINTER, XLOG_MODULE, &__xlog_callsite, __VA_ARGS__ ) : 0; \
+})
+#elif (defined XLOG_FEATURE_ENABLE_FAST_FILTER)
+#define __XLOG_FMTLOG(level, ...)	( xlog_module_fast_drop( XLOG_MODULE, level ) ? 0 : \
+	xlog_output_fmtlog( XLOG_PRINTER, XLOG_MODULE, level, __FILE__, __func__, __LINE__, __VA_ARGS__ ) )
+#else
+#define __XLOG_FMTLOG(level, ...)	xlog_output_fmtlog( XLOG_PRINTER, XLOG_MODULE, level, __FILE__, __func__, __LINE__, __VA_ARGS__ )
+#endif
+
 #if XLOG_LIMIT_LEVEL_FACTORY >= XLOG_LEVEL_FATAL
-#define log_f(...)  xlog_output_fmtlog( XLOG_PRINTER, XLOG_MODULE, XLOG_LEVEL_FATAL, __FILE__, __func__, __LINE__, __VA_ARGS__ )
+#define log_f(...)  __XLOG_FMTLOG( XLOG_LEVEL_FATAL, __VA_ARGS__ )
 #else
 #define log_f(...)
 #endif
 
 #if XLOG_LIMIT_LEVEL_FACTORY >= XLOG_LEVEL_ERROR
-#define log_e(...)	xlog_output_fmtlog( XLOG_PRINTER, XLOG_MODULE, XLOG_LEVEL_ERROR, __FILE__, __func__, __LINE__, __VA_ARGS__ )
+#define log_e(...)	__XLOG_FMTLOG( XLOG_LEVEL_ERROR, __VA_ARGS__ )
 #else
 #define log_e(...)
 #endif
 
 #if XLOG_LIMIT_LEVEL_FACTORY >= XLOG_LEVEL_WARN
-#define log_w(...)	xlog_output_fmtlog( XLOG_PRINTER, XLOG_MODULE, XLOG_LEVEL_WARN, __FILE__, __func__, __LINE__, __VA_ARGS__ )
+#define log_w(...)	__XLOG_FMTLOG( XLOG_LEVEL_WARN, __VA_ARGS__ )
 #else
 #define log_w(...)
 #endif
 
 #if XLOG_LIMIT_LEVEL_FACTORY >= XLOG_LEVEL_INFO
-#define log_i(...)	xlog_output_fmtlog( XLOG_PRINTER, XLOG_MODULE, XLOG_LEVEL_INFO, __FILE__, __func__, __LINE__, __VA_ARGS__ )
+#define log_i(...)	__XLOG_FMTLOG( XLOG_LEVEL_INFO, __VA_ARGS__ )
 #else
 #define log_i(...)
 #endif
 
 #if XLOG_LIMIT_LEVEL_FACTORY >= XLOG_LEVEL_DEBUG
-#define log_d(...)	xlog_output_fmtlog( XLOG_PRINTER, XLOG_MODULE, XLOG_LEVEL_DEBUG, __FILE__, __func__, __LINE__, __VA_ARGS__ )
+#define log_d(...)	__XLOG_FMTLOG( XLOG_LEVEL_DEBUG, __VA_ARGS__ )
 #else
 #define log_d(...)
 #endif
 
 #if XLOG_LIMIT_LEVEL_FACTORY >= XLOG_LEVEL_VERBOSE
-#define log_v(...)	xlog_output_fmtlog( XLOG_PRINTER, XLOG_MODULE, XLOG_LEVEL_VERBOSE, __FILE__, __func__, __LINE__, __VA_ARGS__ )
+#define log_v(...)	__XLOG_FMTLOG( XLOG_LEVEL_VERBOSE, __VA_ARGS__ )
 #else
 #define log_v(...)
 #endif
@@ -0,0 +1,254 @@
+/**
+ * WARNING:
+ *   This file is autogenerated from xlog_config.h.in during the cmake configuration
+ *   of your project. If you need to make changes in your configuration,
+ *   edit the original file but NOT THIS FILE.
+ */
+
+#ifndef __XLOG_CONFIG_H
+#define __XLOG_CONFIG_H
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <assert.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <setjmp.h>
+
+/** check if headers exists */
+/* #undef HAVE_ASM_ATOMIC_H */
+
+
+/** assert and debug */
+#define XLOG_ASSERT(cond)			assert(cond)
+
+
+/** check the size of primitive types */
+#define BITS_PER_LONG 				64
+
+
+/** function: set/get thread name */
+#if (defined __linux__)
+#include <sys/prctl.h>
+#define XLOG_LIMIT_THREAD_NAME		16
+#define __XLOG_SET_THREAD_NAME(name)	prctl(PR_SET_NAME, name, 0, 0, 0)
+#define XLOG_GET_THREAD_NAME(name)	prctl(PR_GET_NAME, name)
+#elif (defined __unix__)
+#include <pthread.h>
+#define XLOG_LIMIT_THREAD_NAME		16
+#define __XLOG_SET_THREAD_NAME(name)	pthread_setname_np( pthread_self(), name )
+#define XLOG_GET_THREAD_NAME(name)	pthread_getname_np( pthread_self(), name, XLOG_LIMIT_THREAD_NAME )
+#elif (defined __FreeBSD__)
+#include <pthread.h>
+#define XLOG_LIMIT_THREAD_NAME		16
+#define __XLOG_SET_THREAD_NAME(name)	pthread_setname_np( pthread_self(), name )
+#define XLOG_GET_THREAD_NAME(name)
+#elif (defined __OpenBSD__)
+#include <pthread.h>
+#define XLOG_LIMIT_THREAD_NAME		16
+#define __XLOG_SET_THREAD_NAME(name)	pthread_setname_np( pthread_self(), name )
+#define XLOG_GET_THREAD_NAME(name)
+#elif (defined __NetBSD__)
+#include <pthread.h>
+#define XLOG_LIMIT_THREAD_NAME		16
+#define __XLOG_SET_THREAD_NAME(name)	pthread_setname_np( pthread_self(), name, NULL )
+#define XLOG_GET_THREAD_NAME(name)
+#elif (defined __APPLE__)
+#include <pthread.h>
+#define XLOG_LIMIT_THREAD_NAME		16
+#define __XLOG_SET_THREAD_NAME(name)	pthread_setname_np( name )
+#define XLOG_GET_THREAD_NAME(name)	pthread_getname_np( pthread_self(), name, XLOG_LIMIT_THREAD_NAME )
+#else
+#error No implementation for this system.
+#endif
+/* cached task descriptor of current thread will be invalidated(@see xlog_task_invalidate) */
+#define XLOG_SET_THREAD_NAME(name)	( xlog_task_invalidate(), __XLOG_SET_THREAD_NAME(name) )
+
+
+/** xlog limit */
+#define XLOG_LIMIT_LEVEL_FACTORY		XLOG_LEVEL_VERBOSE
+#define XLOG_LIMIT_MODULE_PATH			128
+#define XLOG_LIMIT_NODE_PATH			256
+#define XLOG_LIMIT_PLAN_SEGMENTS		16
+#define XLOG_LIMIT_PLAN_TEXT			256
+#define XLOG_LIMIT_SCRATCH_SIZE			65536
+#define XLOG_LIMIT_DEFERRED_RECORD		1024	/* max size of deferred record */
+#define XLOG_LIMIT_DEFERRED_SPEC		16		/* max length of conversion spec, "%-08.3lf" */
+#define XLOG_LIMIT_DEFERRED_PIECES		32		/* max conversions in format */
+#define XLOG_LIMIT_DEFERRED_FORMATS		1024	/* max formats parsed, power of 2, kept until exit */
+#define XLOG_LIMIT_DEFERRED_PROBES		8		/* max slots probed for a format, formatted immediately if NOT found */
+#define XLOG_LIMIT_CALLSITE_CHUNK		1024	/* call-sites per chunk of registry */
+#define XLOG_LIMIT_CALLSITE_CHUNKS		256		/* max chunks of registry */
+#define XLOG_LIMIT_INPLACE_RECORD		1024	/* max size of record formatted in ring-buffer in place, larger ones copied */
+#define XLOG_LIMIT_PRINTER_WAIT_YIELDS	16		/* yields of consumer before sleeping, XLOG_PRINTER_OPERTHREAD */
+#define XLOG_LIMIT_PRINTER_COALESCE	65536	/* default size of coalescing buffer of file printers, XLOG_PRINTER_OCOALESCE */
+#if (defined IOV_MAX) && ( IOV_MAX < 1024 )
+#define XLOG_LIMIT_PRINTER_BATCH		IOV_MAX	/* max records drained by buffering printer per batch */
+#else
+#define XLOG_LIMIT_PRINTER_BATCH		1024	/* max records drained by buffering printer per batch */
+#endif
+
+
+/** xlog style configuration */
+#define XLOG_STYLE_NEWLINE				"\r\n"
+
+
+/** xlog default runtime parameters and log format */
+#define XLOG_DEFAULT_PAYLOAD_SIZE		1024
+#define XLOG_DEFAULT_FORMAT_FATAL		(XLOG_FORMAT_OTIME | XLOG_FORMAT_OLEVEL)
+#define XLOG_DEFAULT_FORMAT_ERROR		(XLOG_FORMAT_OTIME | XLOG_FORMAT_OLEVEL)
+#define XLOG_DEFAULT_FORMAT_WARN		(XLOG_FORMAT_OTIME | XLOG_FORMAT_OLEVEL | XLOG_FORMAT_OMODULE)
+#define XLOG_DEFAULT_FORMAT_INFO		(XLOG_FORMAT_OTIME | XLOG_FORMAT_OLEVEL | XLOG_FORMAT_OMODULE)
+#define XLOG_DEFAULT_FORMAT_DEBUG		(XLOG_FORMAT_OTIME | XLOG_FORMAT_OLEVEL | XLOG_FORMAT_OMODULE | XLOG_FORMAT_OLOCATION)
+#define XLOG_DEFAULT_FORMAT_VERBOSE		(XLOG_FORMAT_OTIME | XLOG_FORMAT_OTASK | XLOG_FORMAT_OLEVEL | XLOG_FORMAT_OMODULE | XLOG_FORMAT_OLOCATION)
+
+
+/** xlog features */
+/* colorful logging */
+#define XLOG_FEATURE_ENABLE_COLOR
+
+/* logging stats */
+#define XLOG_FEATURE_ENABLE_STATS
+#define XLOG_FEATURE_ENABLE_STATS_PRINTER
+#define XLOG_FEATURE_ENABLE_STATS_MODULE
+
+/* auto create default context */
+#define XLOG_FEATURE_ENABLE_DEFAULT_CONTEXT
+
+/* use default printer if given printer is NULL */
+/* #undef XLOG_FEATURE_ENABLE_DEFAULT_PRINTER */
+
+/** dynamic default size of payload(auto-buffer) */
+#define XLOG_FEATURE_ENABLE_DYNAMIC_DEFAULT_AUTOBUF_SIZE
+
+/* drop logging by module level inside log_x macros */
+#define XLOG_FEATURE_ENABLE_FAST_FILTER
+
+/* register static descriptor of call-site in log_x macros */
+#define XLOG_FEATURE_ENABLE_CALLSITE
+
+/* read log-time via coarse clock */
+/* #undef XLOG_FEATURE_ENABLE_COARSE_CLOCK */
+#if (defined XLOG_FEATURE_ENABLE_COARSE_CLOCK) && (defined CLOCK_REALTIME_COARSE)
+#define XLOG_CLOCK_LOG_TIME				CLOCK_REALTIME_COARSE
+#else
+#define XLOG_CLOCK_LOG_TIME				CLOCK_REALTIME
+#endif
+
+
+/** xlog policies */
+#define XLOG_POLICY_ENABLE_RUNTIME_SAFE
+
+
+/** xlog bench */
+/* #undef XLOG_BENCH_NO_OUTPUT */
+
+
+
+/** xlog tags, prefixs, suffixs(stable) */
+#define XLOG_TAG_LEVEL_SILENT				"S"
+#define XLOG_TAG_LEVEL_FATAL				"F"
+#define XLOG_TAG_LEVEL_ERROR				"E"
+#define XLOG_TAG_LEVEL_WARN					"W"
+#define XLOG_TAG_LEVEL_INFO					"I"
+#define XLOG_TAG_LEVEL_DEBUG				"D"
+#define XLOG_TAG_LEVEL_VERBOSE				"V"
+
+/* Non-format prefix & suffix */
+/* prefix and suffix for log-time */
+#define XLOG_PREFIX_LOG_TIME_NONE			""
+#define XLOG_SUFFIX_LOG_TIME_NONE			" "
+/* prefix and suffix for log-task */
+#define XLOG_PREFIX_LOG_TASK_NONE			"["
+#define XLOG_SUFFIX_LOG_TASK_NONE			"] "
+/* prefix and suffix for log-class */
+#define XLOG_PREFIX_LOG_CLASS_NONE(LEVEL)	"[" XLOG_TAG_LEVEL_##LEVEL
+#define XLOG_SUFFIX_LOG_CLASS_NONE(LEVEL)	"] "
+/* prefix and suffix for log-point */
+#define XLOG_PREFIX_LOG_POINT_NONE			"("
+#define XLOG_SUFFIX_LOG_POINT_NONE			") "
+/* prefix and suffix for log-body */
+#define XLOG_PREFIX_LOG_BODY_NONE(LEVEL)	""
+#define XLOG_SUFFIX_LOG_BODY_NONE(LEVEL)	""
+
+/* CSI-based prefix & suffix */
+#define XLOG_COLOR_FATAL_CSI				"38;2;255;0;0;1m"
+#define XLOG_COLOR_ERROR_CSI				"38;2;255;0;0;1m"
+#define XLOG_COLOR_WARN_CSI					"38;2;255;199;6;1m"
+#define XLOG_COLOR_INFO_CSI					"38;2;85;255;255m"
+#define XLOG_COLOR_DEBUG_CSI				"1m"
+#define XLOG_COLOR_VERBOSE_CSI				"0m"
+
+/* prefix and suffix for log-time */
+#define XLOG_PREFIX_LOG_TIME_CSI			"\033[2;3m"
+#define XLOG_SUFFIX_LOG_TIME_CSI			"\033[0m "
+/* prefix and suffix for log-task */
+#define XLOG_PREFIX_LOG_TASK_CSI			"["
+#define XLOG_SUFFIX_LOG_TASK_CSI			"\033[0m] "
+/* prefix and suffix for log-class */
+#define XLOG_PREFIX_LOG_CLASS_CSI(LEVEL)	"[\033[" XLOG_COLOR_##LEVEL##_CSI XLOG_TAG_LEVEL_##LEVEL
+#define XLOG_SUFFIX_LOG_CLASS_CSI(LEVEL)	"\033[0m] "
+/* prefix and suffix for log-point */
+#define XLOG_PREFIX_LOG_POINT_CSI			"("
+#define XLOG_SUFFIX_LOG_POINT_CSI			") "
+/* prefix and suffix for log-body */
+#define XLOG_PREFIX_LOG_BODY_CSI(LEVEL)		"\033[" XLOG_COLOR_##LEVEL##_CSI
+#define XLOG_SUFFIX_LOG_BODY_CSI(LEVEL)		"\033[0m"
+
+
+#if !(defined XLOG_FEATURE_ENABLE_COLOR)
+
+/* prefix and suffix for log-time */
+#define XLOG_PREFIX_LOG_TIME				XLOG_PREFIX_LOG_TIME_NONE
+#define XLOG_SUFFIX_LOG_TIME				XLOG_SUFFIX_LOG_TIME_NONE
+/* prefix and suffix for log-task */
+#define XLOG_PREFIX_LOG_TASK				XLOG_PREFIX_LOG_TASK_NONE
+#define XLOG_SUFFIX_LOG_TASK				XLOG_SUFFIX_LOG_TASK_NONE
+/* prefix and suffix for log-class */
+#define XLOG_PREFIX_LOG_CLASS(LEVEL)		XLOG_PREFIX_LOG_CLASS_NONE(LEVEL)
+#define XLOG_SUFFIX_LOG_CLASS(LEVEL)		XLOG_SUFFIX_LOG_CLASS_NONE(LEVEL)
+/* prefix and suffix for log-point */
+#define XLOG_PREFIX_LOG_POINT				XLOG_PREFIX_LOG_POINT_NONE
+#define XLOG_SUFFIX_LOG_POINT				XLOG_SUFFIX_LOG_POINT_NONE
+/* prefix and suffix for log-body */
+#define XLOG_PREFIX_LOG_BODY(LEVEL)			XLOG_PREFIX_LOG_BODY_NONE(LEVEL)
+#define XLOG_SUFFIX_LOG_BODY(LEVEL)			XLOG_SUFFIX_LOG_BODY_NONE(LEVEL)
+
+#else
+
+/* prefix and suffix for log-time */
+#define XLOG_PREFIX_LOG_TIME				XLOG_PREFIX_LOG_TIME_CSI
+#define XLOG_SUFFIX_LOG_TIME				XLOG_SUFFIX_LOG_TIME_CSI
+/* prefix and suffix for log-task */
+#define XLOG_PREFIX_LOG_TASK				XLOG_PREFIX_LOG_TASK_CSI
+#define XLOG_SUFFIX_LOG_TASK				XLOG_SUFFIX_LOG_TASK_CSI
+/* prefix and suffix for log-class */
+#define XLOG_PREFIX_LOG_CLASS(LEVEL)		XLOG_PREFIX_LOG_CLASS_CSI(LEVEL)
+#define XLOG_SUFFIX_LOG_CLASS(LEVEL)		XLOG_SUFFIX_LOG_CLASS_CSI(LEVEL)
+/* prefix and suffix for log-point */
+#define XLOG_PREFIX_LOG_POINT				XLOG_PREFIX_LOG_POINT_CSI
+#define XLOG_SUFFIX_LOG_POINT				XLOG_SUFFIX_LOG_POINT_CSI
+/* prefix and suffix for log-body */
+#define XLOG_PREFIX_LOG_BODY(LEVEL)			XLOG_PREFIX_LOG_BODY_CSI(LEVEL)
+#define XLOG_SUFFIX_LOG_BODY(LEVEL)			XLOG_SUFFIX_LOG_BODY_CSI(LEVEL)
+
+#endif
+
+#endif
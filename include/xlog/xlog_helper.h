@@ -43,6 +43,16 @@
 #endif
 
 
+/**
+ * @brief Storage class of thread-local variables.
+ */
+#if defined(__GNUC__)
+#define XLOG_THREAD_LOCAL __thread
+#else
+#define XLOG_THREAD_LOCAL _Thread_local
+#endif
+
+
 #if !defined(__WINDOWS__) && (defined(WIN32) || defined(WIN64) || defined(_MSC_VER) || defined(_WIN32))
 #define __WINDOWS__
 #endif
@@ -151,13 +161,53 @@ typedef struct {
 	pthread_mutex_t lock;
 	
 	int level;
+	int level_limit;			/* cached effective level limit, valid if generation matched */
+	unsigned int generation;	/* generation of module tree when cache updated */
 	char *name;
+	char *path;					/* cached full path, "/a/b/c" */
+	int path_length;
 	void *context;
 	#if (defined XLOG_FEATURE_ENABLE_STATS) && (defined XLOG_FEATURE_ENABLE_STATS_MODULE)
 	xlog_stats_t stats;
 	#endif
 } xlog_module_t;
 
+/** static descriptor of log_x call-site, filled once at the first time it's reached */
+typedef struct {
+	unsigned int id;			/* stable id, 0 if NOT registered yet */
+	int level;
+	int control;				/* XLOG_CALLSITE_CTRL_xxx, switched via debug shell */
+	const char *file, *func;
+	long int line;
+	const char *format;			/* format seen at registration */
+	xlog_module_t *module;		/* module seen at registration */
+	int file_length, func_length;
+	int line_length;
+	char line_text[12];			/* line number rendered once */
+	const void *deferred;		/* parsed format for deferred formatting, private to xlog */
+} xlog_callsite_t;
+
+#define XLOG_CALLSITE_ID_NONE		0			/* NOT registered yet */
+#define XLOG_CALLSITE_ID_OVERFLOW	(~0U)		/* registered, but out of registry */
+
+#define XLOG_CALLSITE_CTRL_NONE		0			/* NOT registered yet */
+#define XLOG_CALLSITE_CTRL_DEFAULT	1			/* follow level of module */
+#define XLOG_CALLSITE_CTRL_OFF		2			/* always dropped */
+#define XLOG_CALLSITE_CTRL_ON		3			/* always output, level of module ignored */
+
+/** initializer of static call-site descriptor, all fields listed for C++ and -Wextra */
+#define XLOG_CALLSITE_INITIALIZER(level, file, func, line)	{ \
+	XLOG_CALLSITE_ID_NONE, level, XLOG_CALLSITE_CTRL_NONE, file, func, line, NULL, NULL, 0, 0, 0, { 0 }, NULL \
+}
+
+/** bits of xlog_printer_t::abiclr, queried by XLOG_PRINTER_CTRL_GABICLR on first use if NOT known */
+#define XLOG_PRINTER_ABICLR_YES		0x01	/* colorful output supported */
+#define XLOG_PRINTER_ABICLR_KNOWN	0x02	/* cached, zero-initialized printers of user are queried lazily */
+
+/**
+ * @note   appendl and abiclr are appended after 2.3.4, printers defined by user MUST be rebuilt
+ *         with this header and zero-initialized(e.g. designated initializers), abiclr queried lazily.
+ */
 typedef struct __xlog_printer {
 	#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
 	int magic;
@@ -165,7 +215,10 @@ typedef struct __xlog_printer {
 	void *context;
 	int options;
 	int ( *append )( struct __xlog_printer *printer, void *data );
+	int ( *appendv )( struct __xlog_printer *printer, const struct iovec *iov, int iovcnt );	/* optional, append texts in a batch */
+	int ( *appendl )( struct __xlog_printer *printer, const void *data, size_t length, int level, const struct timespec *ts );	/* optional, append data of known length, binary safe */
 	int ( *optctl )( struct __xlog_printer *printer, int option, void *vptr, size_t size );
+	int abiclr;		/* ability of colorful output, XLOG_PRINTER_ABICLR_xxx, read by xlog_printer_abiclr */
 } xlog_printer_t;
 
 typedef struct xlog_level_attr_tag {
@@ -175,6 +228,9 @@ typedef struct xlog_level_attr_tag {
 	const char *body_prefix, *body_suffix;
 } xlog_level_attr_t;
 
+/** compiled format plan, private to xlog */
+struct xlog_format_plan_tag;
+
 typedef struct {
 	#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
 	int magic;
@@ -186,7 +242,11 @@ typedef struct {
 	#if (defined XLOG_FEATURE_ENABLE_DYNAMIC_DEFAULT_AUTOBUF_SIZE)
 	size_t *size_votes;
 	#endif
-	xlog_level_attr_t attributes[XLOG_LIMIT_LEVEL_NUMBER];
+	xlog_level_attr_t attributes[XLOG_LIMIT_LEVEL_NUMBER];	/* set via xlog_set_level_attributes */
+	struct xlog_format_plan_tag *plans[XLOG_LIMIT_LEVEL_NUMBER][4];	/* compiled per-(level, color, anonymous) */
+	struct xlog_format_plan_tag *retired_plans;	/* released once no reader holds plans */
+	unsigned int plan_readers;
+	unsigned int plan_generation;
 	xlog_module_t *module;
 	#ifdef XLOG_FEATURE_ENABLE_STATS
 	xlog_stats_t stats;
@@ -200,12 +260,15 @@ typedef struct {
 #define XLOG_PRINTER_CTRL_FLUSH		2
 #define XLOG_PRINTER_CTRL_NOBUFF	3
 #define XLOG_PRINTER_CTRL_GABICLR	4
+#define XLOG_PRINTER_CTRL_GSTATS	5	/* get statistics of buffering printer, vptr is pointer to `xlog_stats_t *` */
 
 /** printer for xlog */
 #define XLOG_PRINTER_TYPE_OPT(type)		BITS_MASK_K(0, 4, type)
 #define XLOG_PRINTER_TYPE_GET(options)	CHK_BITS(options, 0, 4)
 #define XLOG_PRINTER_BUFF_OPT(type)		BITS_MASK_K(4, 8, type)
 #define XLOG_PRINTER_BUFF_GET(options)	CHK_BITS(options, 4, 8)
+#define XLOG_PRINTER_OVERFLOW_OPT(type)		BITS_MASK_K(9, 12, type)
+#define XLOG_PRINTER_OVERFLOW_GET(options)	CHK_BITS(options, 9, 12)
 
 /** statistics for xlog */
 #define XLOG_STATS_MAJOR_BYTE		0
@@ -269,6 +332,9 @@ typedef struct {
 	atomic_set( (pstats)->data + XLOG_STATS_OFFSET((pstats)->option, XLOG_STATS_MAJOR_##major, XLOG_STATS_MINOR_##minor), value ); \
 }
 
+#define XLOG_STATS_GET(pstats, major, minor)	(XLOG_STATS_ABICHK((pstats)->option, XLOG_STATS_MAJOR_##major, XLOG_STATS_MINOR_##minor) ? \
+	atomic_read( (pstats)->data + XLOG_STATS_OFFSET((pstats)->option, XLOG_STATS_MAJOR_##major, XLOG_STATS_MINOR_##minor) ) : 0)
+
 #else
 
 #define XLOG_STATS_INIT(pstats, options)	do { \
@@ -297,6 +363,9 @@ typedef struct {
 	(pstats)->data[XLOG_STATS_OFFSET((pstats)->option, XLOG_STATS_MAJOR_##major, XLOG_STATS_MINOR_##minor)] = (value); \
 }
 
+#define XLOG_STATS_GET(pstats, major, minor)	(XLOG_STATS_ABICHK((pstats)->option, XLOG_STATS_MAJOR_##major, XLOG_STATS_MINOR_##minor) ? \
+	(pstats)->data[XLOG_STATS_OFFSET((pstats)->option, XLOG_STATS_MAJOR_##major, XLOG_STATS_MINOR_##minor)] : 0)
+
 #endif
 
 #else
@@ -306,6 +375,7 @@ typedef struct {
 #define XLOG_STATS_CLEAR(pstats)
 #define XLOG_STATS_UPDATE(pstats, major, minor, inc)
 #define XLOG_STATS_CLEAR_FILED(pstats, major, minor, value)
+#define XLOG_STATS_GET(pstats, major, minor)	0
 
 #endif
 
@@ -3,6 +3,7 @@
 
 #include <xlog/xlog_config.h>
 #include <xlog/xlog_helper.h>
+#include <xlog/plugins/ringbuf.h>
 
 /** version number */
 #define XLOG_VERSION_MAJOR        	2
@@ -21,24 +22,165 @@
 /* trace for others exclude targets of __XLOG_TRACE */
 #define XLOG_TRACE(...)	// xlog_output_rawlog( xlog_printer_create( XLOG_PRINTER_STDERR ), NULL, "TRACE: <" __FILE__ ":" XSTRING(__LINE__) "> ", "\r\n", __VA_ARGS__ )
 
+/** deferred record, captured by producer and formatted by consumer of XLOG_PRINTER_BUFF_DEFERRED */
+#define XLOG_DEFERRED_ORAW			BIT_MASK(0)	/* text follows the header, print it as-is */
+
+typedef struct {
+	unsigned int size;				/* size of whole record, header included */
+	unsigned int flags;
+	int level;
+	unsigned int task_length;		/* length of task descriptor follows the header */
+	const void *format;				/* parsed format(@see xlog_deferred_format_t) */
+	unsigned int site;				/* id of call-site, XLOG_CALLSITE_ID_NONE if NOT logged via log_x */
+	xlog_t *context;
+	const xlog_module_t *module;
+	const char *file, *func;
+	long int line;
+	struct timespec ts;
+} xlog_deferred_record_t;
+
+/** coalescing buffer of file printers, XLOG_PRINTER_OCOALESCE */
+typedef struct {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	pthread_t flusher;			/* flushes bytes buffered longer than latency_ms, if latency_ms */
+	bool idle;					/* flusher sleeping on empty buffer, signaled on first byte */
+	bool exiting;
+	int fd;						/* file of bytes buffered */
+	char *data;
+	size_t size;
+	size_t length;
+	unsigned int latency_ms;
+	struct timespec deadline;	/* CLOCK_REALTIME, first byte buffered + latency_ms */
+} xlog_printer_wbuf_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 extern xlog_printer_t stdout_printer, stderr_printer;
 
-xlog_printer_t *xlog_printer_create_basic_file( const char *file );
+xlog_printer_t *xlog_printer_create_basic_file( const char *file, size_t coalesce_size, unsigned int latency_ms );
 int xlog_printer_destory_basic_file( xlog_printer_t *printer );
 
-xlog_printer_t *xlog_printer_create_rotating_file( const char *file, size_t max_size_per_file, size_t max_file_to_ratating );
+xlog_printer_t *xlog_printer_create_rotating_file( const char *file, size_t max_size_per_file, size_t max_file_to_ratating, size_t coalesce_size, unsigned int latency_ms );
 int xlog_printer_destory_rotating_file( xlog_printer_t *printer );
 
-xlog_printer_t *xlog_printer_create_daily_file( const char *file );
+xlog_printer_t *xlog_printer_create_daily_file( const char *file, unsigned int rollover_sec, size_t coalesce_size, unsigned int latency_ms );
 int xlog_printer_destory_daily_file( xlog_printer_t *printer );
 
-xlog_printer_t *xlog_printer_create_ringbuf( size_t capacity );
+xlog_printer_t *xlog_printer_create_ringbuf( size_t capacity, int rb_options );
 int xlog_printer_destory_ringbuf( xlog_printer_t *printer );
 
+/* NOTE: ring-buffer mapped by creator is owned by printer, destoried by xlog_printer_destory_mapped_ringbuf */
+xlog_printer_t *xlog_printer_create_mapped_ringbuf( ringbuf_t *rbuff, int type );
+int xlog_printer_destory_mapped_ringbuf( xlog_printer_t *printer );
+
+xlog_printer_t *xlog_printer_create_shmring( const char *name, size_t capacity, int rb_options, unsigned int timeout_ms );
+xlog_printer_t *xlog_printer_create_mapped_file( const char *file, size_t capacity );
+
+/**
+ * @brief  write all of iovecs to file, retry on partial writing
+ *
+ * @param  fd, file descriptor
+ *         iov/iovcnt, texts to write, no more than IOV_MAX
+ * @return bytes written, or -1 on error.
+ *
+ */
+ssize_t xlog_printer_writev( int fd, const struct iovec *iov, int iovcnt );
+
+/**
+ * @brief  create coalescing buffer
+ *
+ * @param  size, size of buffer
+ *         latency_ms, max time bytes stay in buffer, flushed on full/flush/destory only if zero
+ * @return pointer to coalescing buffer, or NULL.
+ *
+ */
+xlog_printer_wbuf_t *xlog_printer_wbuf_create( size_t size, unsigned int latency_ms );
+
+/**
+ * @brief  flush and destory coalescing buffer
+ *
+ */
+void xlog_printer_wbuf_destory( xlog_printer_wbuf_t *wbuf );
+
+/**
+ * @brief  copy texts into coalescing buffer, flushed first if full or file changed
+ *
+ * @param  wbuf, coalescing buffer
+ *         fd, file to write
+ *         iov/iovcnt, texts to write, written through if NOT fit in buffer
+ * @return bytes accepted, or -1 on error.
+ *
+ */
+ssize_t xlog_printer_wbuf_appendv( xlog_printer_wbuf_t *wbuf, int fd, const struct iovec *iov, int iovcnt );
+ssize_t xlog_printer_wbuf_append( xlog_printer_wbuf_t *wbuf, int fd, const char *text, size_t length );
+
+/**
+ * @brief  write out bytes buffered, MUST be called before file buffered is closed
+ *
+ */
+int xlog_printer_wbuf_flush( xlog_printer_wbuf_t *wbuf );
+
+/**
+ * @brief  get ability of colorful output, cached in printer
+ *
+ * @param  printer, printer to output log
+ * @return 1 if colorful output supported, or 0.
+ *
+ * @note   printers NOT created by xlog_printer_create(e.g. defined by user) are queried by
+ *         XLOG_PRINTER_CTRL_GABICLR on first use.
+ *
+ */
+int xlog_printer_abiclr( xlog_printer_t *printer );
+
+/**
+ * @brief  append deferred record to printer of XLOG_PRINTER_BUFF_DEFERRED
+ *
+ * @param  printer, deferred printer
+ *         record, deferred record, copied into ring-buffer
+ * @return error code.
+ *
+ */
+int xlog_printer_append_deferred( xlog_printer_t *printer, const xlog_deferred_record_t *record );
+
+/**
+ * @brief  reserve space of text in ring-buffer of XLOG_PRINTER_BUFF_RINGBUF, formatted in place
+ *
+ * @param  printer, buffering printer
+ *         size, max size of text, '\0' included
+ *         text, space reserved
+ * @return error code(ENOTSUP if NOT supported by printer, EAGAIN/ETIMEDOUT if dropped by overflow policy).
+ *
+ * @note   xlog_printer_commit_text MUST follow on the same thread.
+ *
+ */
+int xlog_printer_reserve_text( xlog_printer_t *printer, size_t size, char **text );
+
+/**
+ * @brief  commit text reserved by xlog_printer_reserve_text
+ *
+ * @param  printer, buffering printer
+ *         text, space reserved
+ *         length, length of text, '\0' NOT included, zero to cancel
+ *         level, level of record, kept in header of record
+ * @return error code.
+ *
+ */
+int xlog_printer_commit_text( xlog_printer_t *printer, char *text, size_t length, int level );
+
+/**
+ * @brief  format deferred record(header + task + raw arguments) to text
+ *
+ * @param  record, deferred record captured by xlog_output_fmtlog
+ *         abiclr, ability of colorful output of the wrapped printer
+ *         autobuf, autobuf to save the text
+ * @return length of text.
+ *
+ */
+int xlog_deferred_render( const xlog_deferred_record_t *record, int abiclr, autobuf_t **autobuf );
+
 #ifdef __cplusplus
 }
 #endif
@@ -111,6 +111,33 @@ API_PUBLIC( autobuf_t * ) autobuf_create( unsigned int id, const char *brief, in
 	return autobuf;
 }
 
+/**
+ * @brief  attach a fixed autobuf object to pre-allocated buffer, without allocating
+ *
+ * @param  storage, storage of autobuf object, AUTOBUF_ATTACHED_SIZE bytes at least
+ *         id, autobuf identifier(@see XLOG_PAYLOAD_ID_xxx)
+ *         brief, brief info of autobuf
+ *         options, AUTOBUF_OTEXT or AUTOBUF_OBINARY, AUTOBUF_OFIXED implied
+ *         vptr/size, pre-allocated buffer
+ * @return pointer to `autobuf_t` in storage.
+ *
+ * @note   do NOT destory the autobuf attached, appending beyond the buffer fails with EOVERFLOW.
+ *
+ */
+API_PUBLIC( autobuf_t * ) autobuf_attach( void *storage, unsigned int id, const char *brief, int options, void *vptr, size_t size )
+{
+	AUTOBUF_ASSERT( storage && vptr );
+	autobuf_t *autobuf = ( autobuf_t * )storage;
+	autobuf->id = id;
+	autobuf->brief = brief;
+	autobuf->options = ( options & ~( AUTOBUF_ODYNAMIC | AUTOBUF_OALIGN | AUTOBUF_ORESERVING ) ) | AUTOBUF_OFIXED;
+	autobuf->offset = 0;
+	autobuf->length = size;
+	memcpy( autobuf->data, &vptr, sizeof( void * ) );
+	
+	return autobuf;
+}
+
 /**
  * @brief  resize data field of autobuf object
  *
@@ -203,6 +230,24 @@ API_PUBLIC( void * ) autobuf_data_vptr( const autobuf_t *autobuf )
  *
  */
 API_PUBLIC( int ) autobuf_append_text( autobuf_t **autobuf, const char *text )
+{
+	if( text == NULL ) {
+		AUTOBUF_TRACE( "Invalid parameters. text = %p", text );
+		return EINVAL;
+	}
+	
+	return autobuf_append_text_n( autobuf, text, AUTOBUF_TEXT_LENGTH( text ) );
+}
+
+/**
+ * @brief  append text of known length to a autobuf object
+ *
+ * @param  autobuf, autobuf object
+ *         text/textlen, text to append, '\0' not included in textlen
+ * @return error code(@see Exxx).
+ *
+ */
+API_PUBLIC( int ) autobuf_append_text_n( autobuf_t **autobuf, const char *text, size_t textlen )
 {
 	if(
 		autobuf == NULL
@@ -214,7 +259,6 @@ API_PUBLIC( int ) autobuf_append_text( autobuf_t **autobuf, const char *text )
 		return EINVAL;
 	}
 	
-	size_t textlen = AUTOBUF_TEXT_LENGTH( text );
 	if( ( *autobuf )->offset + textlen < ( *autobuf )->length ) {
 		char *ptr = ( char * )autobuf_data_vptr( *autobuf );
 		memcpy( ptr + ( *autobuf )->offset, text, textlen );
@@ -234,6 +278,10 @@ API_PUBLIC( int ) autobuf_append_text( autobuf_t **autobuf, const char *text )
 		}
 		
 		return rv;
+	} else {
+		AUTOBUF_TRACE( "Overflow, terminate appending." );
+		( *autobuf )->offset = ( *autobuf )->length;
+		return EOVERFLOW;
 	}
 	
 	return 0;
@@ -1,5 +1,11 @@
 #include <xlog/plugins/ringbuf.h>
 
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
 #ifdef __GNUC__
 #pragma GCC diagnostic ignored "-Wpragmas"
 #pragma GCC diagnostic ignored "-Wunknown-pragmas"
@@ -11,9 +17,50 @@
 #endif
 
 #define RBUF_MIN(a, b) ((a) <= (b) ? (a) : (b))
+#define RBUF_MAX(a, b) ((a) >= (b) ? (a) : (b))
 #define RBUF_ALIGN_UP(size, align) ((align+size-1) & (~(align-1)))
 #define RBUF_TRACE(...)
 
+/* adaptive waiting of consumer */
+#define RBUF_WAIT_SPINS				256
+#define RBUF_WAIT_YIELDS			16
+#if (defined __x86_64__) || (defined __i386__)
+#define RBUF_CPU_RELAX()			__builtin_ia32_pause()
+#elif (defined __aarch64__)
+#define RBUF_CPU_RELAX()			__asm__ __volatile__( "yield" ::: "memory" )
+#else
+#define RBUF_CPU_RELAX()			__asm__ __volatile__( "" ::: "memory" )
+#endif
+
+/* backing of RINGBUF_OHUGEPAGE/RINGBUF_OMLOCK */
+#define RBUF_HUGEPAGE_SIZE			( 2 * 1024 * 1024 )
+#define RBUF_PAGE_SIZE				4096
+#if (defined MAP_POPULATE)
+#define RBUF_MAP_POPULATE			MAP_POPULATE
+#else
+#define RBUF_MAP_POPULATE			0
+#endif
+
+/* ring-buffer in shared memory: ringbuf_t + data, magic checks layout of processes attached */
+#define RBUF_SHARED_HEADER			RBUF_ALIGN_UP( sizeof( ringbuf_t ), RINGBUF_CACHELINE_SIZE )
+#define RBUF_SHARED_MAGIC			( 0x52420000 | ( unsigned int )( sizeof( ringbuf_t ) & 0xFFFF ) )
+#define RBUF_SHARED_ATTACH_TRIES	1000	/* 1ms each */
+
+/* record of lock-free ring-buffer: 8 bytes header(flags and length) + data, aligned to 8 bytes */
+#define RBUF_RECORD_ALIGN			8
+#define RBUF_RECORD_COMMITTED		( ( uint64_t )1 << 32 )
+#define RBUF_RECORD_PADDING			( ( uint64_t )1 << 33 )	/* skipped by consumer, fills the gap before wrapping or after committing */
+#define RBUF_RECORD_LEVEL(header)	( (unsigned int)( ( header ) >> 40 ) & 0xFF )
+#define RBUF_RECORD_OWNER(pid)		( ( uint64_t )( pid ) << 34 )	/* owner of record reserved, replaced by level once committed */
+#define RBUF_RECORD_PID(header)		( (pid_t)( ( header ) >> 34 ) )
+#define RBUF_ORPHAN_TIMEOUT_MS		100	/* record of owner exited without committing is skipped after */
+#define RBUF_RECORD_SIZE(length)	( sizeof( uint64_t ) + RBUF_ALIGN_UP( ( uint64_t )( length ), RBUF_RECORD_ALIGN ) )
+
+/* frame of RINGBUF_OFRAMED: ringbuf_record_t + data, NOT aligned, padding flagged in length */
+#define RBUF_FRAME_HEADER			sizeof( ringbuf_record_t )
+#define RBUF_FRAME_PADDING			( ( uint32_t )1 << 31 )
+#define RBUF_FRAME_LENGTH(header)	( ( header ) & ~RBUF_FRAME_PADDING )
+
 /* @brief  create ring-buffer
  * @param  capacity, capacity of ring-buffer
  * @return pointer to ring-buffer; NULL if failed to allocate memory
@@ -22,51 +69,407 @@
  **/
 ringbuf_t *ringbuf_create( unsigned int capacity )
 {
-	/* One byte used for detecting the full condition. */
+	return ringbuf_create_ex( capacity, 0 );
+}
+
+/* fault in each page of data, or first records written take the page faults */
+static void __data_prefault( char *data, size_t size )
+{
+	for( size_t offset = 0; offset < size; offset += RBUF_PAGE_SIZE ) {
+		( ( volatile char * )data )[offset] = 0;
+	}
+}
+
+/* allocate data of ring-buffer, mapped on huge pages if RINGBUF_OHUGEPAGE, locked if RINGBUF_OMLOCK */
+static char *__data_alloc( ringbuf_t *rb, size_t size, int options )
+{
+	char *data = NULL;
+	rb->mapped = 0;
+	rb->locked = false;
+	if( options & RINGBUF_OHUGEPAGE ) {
+		size_t mapped = RBUF_ALIGN_UP( size, ( size_t )RBUF_HUGEPAGE_SIZE );
+		#if (defined MAP_HUGETLB)
+		data = (char *)mmap( NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | RBUF_MAP_POPULATE, -1, 0 );
+		if( data == MAP_FAILED ) {
+			RBUF_TRACE( "No huge pages reserved, try transparent huge pages." );
+			data = NULL;
+		}
+		#endif
+		if( data == NULL ) {
+			data = (char *)mmap( NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+			if( data == MAP_FAILED ) {
+				data = NULL;
+			} else {
+				#if (defined MADV_HUGEPAGE)
+				madvise( data, mapped, MADV_HUGEPAGE );
+				#endif
+			}
+		}
+		if( data ) {
+			rb->mapped = mapped;
+			__data_prefault( data, mapped );
+		}
+	}
+	if( data == NULL ) {
+		data = (char *)RBUF_MALLOC( size );
+		if( data && ( options & RINGBUF_OHUGEPAGE ) ) {
+			__data_prefault( data, size );
+		}
+	}
+	if( data && ( options & RINGBUF_OMLOCK ) ) {
+		/* NOTE: pages faulted in by mlock */
+		rb->locked = mlock( data, rb->mapped ? rb->mapped : size ) == 0;
+		if( !rb->locked ) {
+			RBUF_TRACE( "Failed to lock memory, errno = %d.", errno );
+			__data_prefault( data, size );
+		}
+	}
+	
+	return data;
+}
+
+/* release data allocated by __data_alloc */
+static void __data_free( ringbuf_t *rb, size_t size )
+{
+	if( rb->locked ) {
+		munlock( rb->data, rb->mapped ? rb->mapped : size );
+	}
+	if( rb->mapped ) {
+		munmap( rb->data, rb->mapped );
+	} else {
+		RBUF_FREE( rb->data );
+	}
+}
+
+/* size of data for capacity given, one byte used for detecting the full condition */
+static size_t __ring_size( unsigned int capacity, int options )
+{
 	/* Align is applied 'cause the capacity usually very large for better performance */
-	ringbuf_t *rb = (ringbuf_t *)RBUF_MALLOC( sizeof( ringbuf_t ) );
+	size_t size = RBUF_ALIGN_UP( ( size_t )capacity + 1, 1024 );
+	if( options & RINGBUF_OPOW2 ) {
+		for( size = 1024; size < ( size_t )capacity + 1; size <<= 1 );
+	}
+	
+	return size;
+}
+
+/* initialize state of ring-buffer, mutex and conditions shared between processes if pshared */
+static void __ring_init( ringbuf_t *rb, size_t size, int options, bool pshared )
+{
+	if( RINGBUF_OVERFLOW( options ) == RINGBUF_ODROP_OLD ) {
+		RBUF_TRACE( "Records are evicted under mutex, lock-free disabled." );
+		options &= ~RINGBUF_OLOCKFREE;
+		options |= RINGBUF_OFRAMED;
+	}
+	rb->capacity = size - 1;
+	rb->mask = ( options & RINGBUF_OPOW2 ) ? size - 1 : 0;
+	rb->rd_offset = 0;
+	rb->wr_offset = 0;
+	rb->options = options;
+	rb->timeout_ms = 0;
+	rb->dropped_records = 0;
+	rb->dropped_bytes = 0;
+	rb->wakeup = false;
+	rb->parked = 0;
+	rb->wr_parked = 0;
+	rb->wr_reserved = 0;
+	rb->rd_released = 0;
+	rb->rd_partial = 0;
+	rb->rd_stalled = 0;
+	rb->rd_stalled_ns = 0;
+	
+	pthread_mutexattr_t mattr;
+	pthread_condattr_t cattr;
+	pthread_mutexattr_init( &mattr );
+	pthread_condattr_init( &cattr );
+	if( pshared ) {
+		pthread_mutexattr_setpshared( &mattr, PTHREAD_PROCESS_SHARED );
+		pthread_condattr_setpshared( &cattr, PTHREAD_PROCESS_SHARED );
+	}
+	pthread_mutex_init( &rb->mutex, &mattr );
+	pthread_cond_init( &rb->cond_data_out, &cattr );
+	pthread_cond_init( &rb->cond_data_in, &cattr );
+	pthread_mutexattr_destroy( &mattr );
+	pthread_condattr_destroy( &cattr );
+}
+
+/* @brief  create ring-buffer with options
+ * @param  capacity, capacity of ring-buffer
+ *         options, RINGBUF_Oxxx
+ * @return pointer to ring-buffer; NULL if failed to allocate memory
+ * @note   1. with RINGBUF_OLOCKFREE, producers reserve space by CAS and commit records by flags,
+ *         ringbuf_copy_from and ringbuf_findchr MUST be called by a single consumer.
+ *         2. with RINGBUF_OPOW2, capacity + 1 is rounded up to power of two(1024 at least),
+ *         free-running positions of RINGBUF_OLOCKFREE are masked instead of modulo.
+ *         3. with RINGBUF_OHUGEPAGE, data is mapped in multiples of 2MB, MAP_HUGETLB tried first,
+ *         then transparent huge pages, all pages faulted in before returned.
+ *         4. with RINGBUF_OMLOCK, failure of mlock(e.g. RLIMIT_MEMLOCK) is NOT fatal, see `locked`.
+ **/
+ringbuf_t *ringbuf_create_ex( unsigned int capacity, int options )
+{
+	/* NOTE: aligned to cache line, or state of producers and consumer may share one */
+	ringbuf_t *rb = NULL;
+	if( posix_memalign( (void **)&rb, RINGBUF_CACHELINE_SIZE, sizeof( ringbuf_t ) ) != 0 ) {
+		rb = NULL;
+	}
 	if( rb ) {
-		size_t size = RBUF_ALIGN_UP( capacity + 1, 1024 );
-		rb->data = (char *)RBUF_MALLOC( size );
+		memset( rb, 0, sizeof( ringbuf_t ) );
+		size_t size = __ring_size( capacity, options );
+		rb->data = size <= UINT32_MAX ? __data_alloc( rb, size, options ) : NULL;
 		if( rb->data == NULL ) {
 			RBUF_TRACE( "Failed to allocate memory." );
 			RBUF_FREE( rb );
 			return NULL;
 		}
-		rb->capacity = size - 1;
-		rb->rd_offset = 0;
-		rb->wr_offset = 0;
-		
+		__ring_init( rb, size, options, false );
+	}
+	
+	return rb;
+}
+
+/* create ring-buffer mapped from fd, header and data zeroed by ftruncate */
+static ringbuf_t *__mapped_create( int fd, size_t size, int options )
+{
+	ringbuf_t *rb = NULL;
+	size_t mapped = RBUF_SHARED_HEADER + size;
+	if( ftruncate( fd, mapped ) == 0 ) {
+		void *vptr = mmap( NULL, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+		rb = vptr == MAP_FAILED ? NULL : ( ringbuf_t * )vptr;
+	}
+	if( rb ) {
+		__ring_init( rb, size, options, true );
+		rb->mapped = mapped;
+		__atomic_store_n( &rb->shared, RBUF_SHARED_MAGIC, __ATOMIC_RELEASE );
+	}
+	
+	return rb;
+}
+
+/* map ring-buffer of fd, size of it waited for if NOT truncated by creator yet */
+static ringbuf_t *__mapped_attach( int fd, int flags, int tries, size_t *mapped )
+{
+	struct stat st;
+	for( int i = 0; i < tries; i ++ ) {
+		if( fstat( fd, &st ) != 0 ) {
+			return NULL;
+		}
+		if( ( size_t )st.st_size > RBUF_SHARED_HEADER ) {
+			void *vptr = mmap( NULL, st.st_size, PROT_READ | PROT_WRITE, flags, fd, 0 );
+			if( vptr == MAP_FAILED ) {
+				return NULL;
+			}
+			*mapped = st.st_size;
+			return ( ringbuf_t * )vptr;
+		}
+		usleep( 1000 );
+	}
+	errno = ETIMEDOUT;
+	
+	return NULL;
+}
+
+/* check layout of ring-buffer mapped, unmapped if mismatched */
+static ringbuf_t *__mapped_check( ringbuf_t *rb, size_t mapped )
+{
+	if( rb && (
+		rb->shared != RBUF_SHARED_MAGIC || rb->mapped != mapped
+		|| ( size_t )rb->capacity + 1 + RBUF_SHARED_HEADER != mapped
+		|| rb->rd_offset > rb->capacity || rb->wr_offset > rb->capacity
+	) ) {
+		RBUF_TRACE( "Layout of ring-buffer mapped mismatched." );
+		munmap( rb, mapped );
+		rb = NULL;
+		errno = EPROTO;
+	}
+	
+	return rb;
+}
+
+/* @brief  create or attach ring-buffer in POSIX shared memory
+ * @param  name, name of shared memory, e.g. "/xlog"
+ *         capacity/options, of ring-buffer if created, those of ring-buffer existing are taken if attached
+ * @return pointer to ring-buffer; NULL if failed(errno set)
+ * @note   1. RINGBUF_OLOCKFREE recommended, producers of all processes reserve space by CAS,
+ *         a single consumer of all processes drains it, e.g. xlog-drain.
+ *         2. owner(pid) of record is kept in header until committed, record of producer exited without
+ *         committing is skipped by consumer after a while(dropped), its process MUST be reaped by parent.
+ *         3. RINGBUF_OHUGEPAGE and RINGBUF_OMLOCK are ignored.
+ *         4. ringbuf_destory detaches it only, removed by ringbuf_unlink_shared.
+ **/
+ringbuf_t *ringbuf_open_shared( const char *name, unsigned int capacity, int options )
+{
+	options &= ~( RINGBUF_OHUGEPAGE | RINGBUF_OMLOCK );
+	size_t size = __ring_size( capacity, options );
+	if( size > UINT32_MAX ) {
+		errno = EINVAL;
+		return NULL;
+	}
+	
+	ringbuf_t *rb = NULL;
+	int fd = shm_open( name, O_RDWR | O_CREAT | O_EXCL, 0600 );
+	if( fd >= 0 ) {
+		rb = __mapped_create( fd, size, options );
+		if( rb == NULL ) {
+			int error = errno;
+			shm_unlink( name );
+			errno = error;
+		}
+	} else if( errno == EEXIST && ( fd = shm_open( name, O_RDWR, 0 ) ) >= 0 ) {
+		size_t mapped = 0;
+		rb = __mapped_attach( fd, MAP_SHARED, RBUF_SHARED_ATTACH_TRIES, &mapped );
+		/* NOTE: wait for creator to initialize it */
+		for( int i = 0; rb && i < RBUF_SHARED_ATTACH_TRIES; i ++ ) {
+			if( __atomic_load_n( &rb->shared, __ATOMIC_ACQUIRE ) != 0 ) {
+				break;
+			}
+			usleep( 1000 );
+		}
+		rb = __mapped_check( rb, mapped );
+	}
+	if( fd >= 0 ) {
+		int error = errno;
+		close( fd );
+		errno = error;
+	}
+	
+	return rb;
+}
+
+/* @brief  remove name of ring-buffer in shared memory
+ * @param  name, name of shared memory
+ * @return error code
+ * @note   ring-buffer attached is valid until destoryed
+ **/
+int ringbuf_unlink_shared( const char *name )
+{
+	return shm_unlink( name ) == 0 ? 0 : errno;
+}
+
+/* @brief  create ring-buffer backed by file, e.g. flight recorder surviving crash of process
+ * @param  path, file to create, truncated if existing
+ *         capacity/options, of ring-buffer
+ * @return pointer to ring-buffer; NULL if failed(errno set)
+ * @note   1. same layout as ringbuf_open_shared, pages kept by kernel after crash of process,
+ *         read back by ringbuf_recover_file.
+ *         2. records are published after copied, the one being copied when crashed is NOT recovered.
+ *         3. ringbuf_destory unmaps it only, file is kept.
+ **/
+ringbuf_t *ringbuf_open_file( const char *path, unsigned int capacity, int options )
+{
+	options &= ~( RINGBUF_OHUGEPAGE | RINGBUF_OMLOCK );
+	size_t size = __ring_size( capacity, options );
+	if( size > UINT32_MAX ) {
+		errno = EINVAL;
+		return NULL;
+	}
+	
+	int fd = open( path, O_RDWR | O_CREAT | O_TRUNC, 0644 );
+	if( fd < 0 ) {
+		return NULL;
+	}
+	ringbuf_t *rb = __mapped_create( fd, size, options );
+	int error = errno;
+	close( fd );
+	errno = error;
+	
+	return rb;
+}
+
+/* @brief  map ring-buffer of file left by ringbuf_open_file for reading, file NOT modified
+ * @param  path, file of ring-buffer
+ * @return pointer to ring-buffer; NULL if failed(errno set, EPROTO if NOT a ring-buffer)
+ * @note   records are read by ringbuf_read_record or ringbuf_copy_from, in order written;
+ *         mapped copy-on-write, locks held by the process crashed are reinitialized.
+ **/
+ringbuf_t *ringbuf_recover_file( const char *path )
+{
+	int fd = open( path, O_RDONLY );
+	if( fd < 0 ) {
+		return NULL;
+	}
+	size_t mapped = 0;
+	ringbuf_t *rb = __mapped_attach( fd, MAP_PRIVATE, 1, &mapped );
+	if( rb == NULL && errno == ETIMEDOUT ) {
+		/* NOTE: too short for header */
+		errno = EPROTO;
+	}
+	rb = __mapped_check( rb, mapped );
+	int error = errno;
+	close( fd );
+	errno = error;
+	if( rb ) {
 		pthread_mutex_init( &rb->mutex, NULL );
 		pthread_cond_init( &rb->cond_data_out, NULL );
 		pthread_cond_init( &rb->cond_data_in, NULL );
+		rb->parked = 0;
+		rb->wakeup = false;
 	}
 	
 	return rb;
 }
 
+/* @brief  set timeout of RINGBUF_OTIMEOUT
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         timeout_ms, max time to wait for space
+ **/
+void ringbuf_set_timeout( ringbuf_t *rb, unsigned int timeout_ms )
+{
+	assert( rb );
+	rb->timeout_ms = timeout_ms;
+}
+
+/* @brief  get statistics of data dropped by overflow policy
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         records/bytes, dropped records and bytes, NULL to ignore
+ **/
+void ringbuf_dropped( const ringbuf_t *rb, uint64_t *records, uint64_t *bytes )
+{
+	assert( rb );
+	if( records ) {
+		*records = __atomic_load_n( &rb->dropped_records, __ATOMIC_RELAXED );
+	}
+	if( bytes ) {
+		*bytes = __atomic_load_n( &rb->dropped_bytes, __ATOMIC_RELAXED );
+	}
+}
+
 /* @brief  destory ring-buffer
  * @param  rb, pointer to ring-buffer
  * @return error code(always zero for this interface)
  **/
 int ringbuf_destory( ringbuf_t *rb )
 {
-	if( rb ) {
+	if( rb && rb->shared ) {
+		/* NOTE: mutex and conditions are still used by other processes */
+		munmap( rb, rb->mapped );
+	} else if( rb ) {
 		pthread_mutex_destroy( &rb->mutex );
 		pthread_cond_destroy( &rb->cond_data_in );
 		pthread_cond_destroy( &rb->cond_data_out );
-		RBUF_FREE( rb->data );
+		__data_free( rb, ( size_t )rb->capacity + 1 );
 		RBUF_FREE( rb );
 	}
 	
 	return 0;
 }
 
+/* data of ring-buffer, following the header if in shared memory */
+static inline char *__ring_data( const ringbuf_t *rb )
+{
+	return rb->shared ? (char *)rb + RBUF_SHARED_HEADER : rb->data;
+}
+
+/* offset in ring of position, masked if RINGBUF_OPOW2 */
+static inline unsigned int __ring_index( const ringbuf_t *rb, uint64_t position )
+{
+	return rb->mask ? (unsigned int)( position & rb->mask ) : (unsigned int)( position % ( rb->capacity + 1 ) );
+}
+
 /* offset to next n bytes */
 static unsigned int __offset_next_n( const ringbuf_t* rb, int offset, int n )
 {
 	assert( ( offset >= 0 ) && ( offset <= rb->capacity ) );
-	return ( offset + n ) % ( rb->capacity + 1 );
+	return __ring_index( rb, ( uint64_t )offset + n );
 }
 
 /* get free size */
@@ -97,53 +500,600 @@ static unsigned int __size_used( const ringbuf_t *rb )
 	return bytes_used;
 }
 
-/* @brief  copy data to ring-buffer
- * @param  rb, pointer to ring-buffer(Non-NULL required)
- *         vptr/size, data to copy into
- *         block_size, minimal size of block to copy each time
- * @return error code(always zero for this interface)
- * @note   1. data given may be separated into several fragments
- *         2. but NO LIMIT on size of data
- **/
-int ringbuf_copy_into_separable( ringbuf_t *rb, const void *vptr, unsigned int size, unsigned int block_size )
+/* copy data into ring at position, wrapped */
+static void __ring_write( ringbuf_t *rb, uint64_t position, const void *vptr, unsigned int size )
+{
+	unsigned int offset = __ring_index( rb, position );
+	unsigned int non_overflow_size = RBUF_MIN( size, rb->capacity + 1 - offset );
+	memcpy( __ring_data( rb ) + offset, vptr, non_overflow_size );
+	if( non_overflow_size < size ) {
+		memcpy( __ring_data( rb ), (const char *)vptr + non_overflow_size, size - non_overflow_size );
+	}
+}
+
+/* copy data from ring at position, wrapped */
+static void __ring_read( const ringbuf_t *rb, uint64_t position, void *vptr, unsigned int size )
+{
+	unsigned int offset = __ring_index( rb, position );
+	unsigned int non_overflow_size = RBUF_MIN( size, rb->capacity + 1 - offset );
+	memcpy( vptr, __ring_data( rb ) + offset, non_overflow_size );
+	if( non_overflow_size < size ) {
+		memcpy( (char *)vptr + non_overflow_size, __ring_data( rb ), size - non_overflow_size );
+	}
+}
+
+/* zero data in ring at position, wrapped */
+static void __ring_zero( ringbuf_t *rb, uint64_t position, unsigned int size )
+{
+	unsigned int offset = __ring_index( rb, position );
+	unsigned int non_overflow_size = RBUF_MIN( size, rb->capacity + 1 - offset );
+	memset( __ring_data( rb ) + offset, 0, non_overflow_size );
+	if( non_overflow_size < size ) {
+		memset( __ring_data( rb ), 0, size - non_overflow_size );
+	}
+}
+
+/* header of record at position, zero if NOT committed */
+static inline uint64_t *__lockfree_header( const ringbuf_t *rb, uint64_t position )
+{
+	return (uint64_t *)( __ring_data( rb ) + __ring_index( rb, position ) );
+}
+
+/* size of header before data, timestamp follows the header if RINGBUF_OFRAMED */
+static inline unsigned int __lockfree_meta( const ringbuf_t *rb )
+{
+	return ( rb->options & RINGBUF_OFRAMED ) ? 2 * sizeof( uint64_t ) : sizeof( uint64_t );
+}
+
+/* size of record in ring, padding records carry NO timestamp */
+static inline uint64_t __lockfree_size( const ringbuf_t *rb, uint64_t header )
+{
+	if( header & RBUF_RECORD_PADDING ) {
+		return RBUF_RECORD_SIZE( (unsigned int)header );
+	}
+	
+	return __lockfree_meta( rb ) + RBUF_ALIGN_UP( ( uint64_t )(unsigned int)header, RBUF_RECORD_ALIGN );
+}
+
+/* nanoseconds since epoch, stamped on records of RINGBUF_OFRAMED */
+static uint64_t __timestamp( void )
+{
+	struct timespec now;
+	clock_gettime( CLOCK_REALTIME, &now );
+	
+	return ( uint64_t )now.tv_sec * 1000000000ULL + ( uint64_t )now.tv_nsec;
+}
+
+/* count data dropped by overflow policy */
+static void __dropped( ringbuf_t *rb, unsigned int size )
+{
+	__atomic_add_fetch( &rb->dropped_records, 1, __ATOMIC_RELAXED );
+	__atomic_add_fetch( &rb->dropped_bytes, size, __ATOMIC_RELAXED );
+}
+
+/* deadline after timeout_ms on clock */
+static void __deadline( struct timespec *deadline, clockid_t clock, unsigned int timeout_ms )
+{
+	clock_gettime( clock, deadline );
+	deadline->tv_sec += timeout_ms / 1000;
+	deadline->tv_nsec += ( timeout_ms % 1000 ) * 1000000L;
+	if( deadline->tv_nsec >= 1000000000L ) {
+		deadline->tv_sec ++;
+		deadline->tv_nsec -= 1000000000L;
+	}
+}
+
+/* check if deadline on clock passed */
+static bool __deadline_passed( const struct timespec *deadline, clockid_t clock )
+{
+	struct timespec now;
+	clock_gettime( clock, &now );
+	
+	return now.tv_sec > deadline->tv_sec || ( now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec );
+}
+
+/* evict the oldest frame to make room, mutex should be held */
+static bool __framed_evict( ringbuf_t *rb )
+{
+	if( rb->rd_partial > 0 || __size_used( rb ) == 0 ) {
+		RBUF_TRACE( "Nothing to evict, or the oldest frame is being read." );
+		return false;
+	}
+	uint32_t header = 0;
+	__ring_read( rb, rb->rd_offset, &header, sizeof( header ) );
+	__atomic_store_n( &rb->rd_offset, __offset_next_n( rb, rb->rd_offset, RBUF_FRAME_HEADER + RBUF_FRAME_LENGTH( header ) ), __ATOMIC_RELEASE );
+	if( !( header & RBUF_FRAME_PADDING ) ) {
+		__dropped( rb, header );
+	}
+	
+	return true;
+}
+
+/* wait for space by overflow policy, mutex should be held, return error code if it should be dropped */
+static int __overflow_wait( ringbuf_t *rb, struct timespec *deadline, bool *timed )
+{
+	switch( RINGBUF_OVERFLOW( rb->options ) ) {
+		case RINGBUF_OTIMEOUT: {
+			if( !*timed ) {
+				__deadline( deadline, CLOCK_REALTIME, rb->timeout_ms );
+				*timed = true;
+			}
+			if( pthread_cond_timedwait( &rb->cond_data_out, &rb->mutex, deadline ) == ETIMEDOUT ) {
+				return ETIMEDOUT;
+			}
+		} break;
+		case RINGBUF_ODROP_NEW: {
+			return EAGAIN;
+		} break;
+		case RINGBUF_ODROP_OLD: {
+			return __framed_evict( rb ) ? 0 : EAGAIN;
+		} break;
+		default: {
+			pthread_cond_wait( &rb->cond_data_out, &rb->mutex );
+		} break;
+	}
+	
+	return 0;
+}
+
+/* wait for space by overflow policy without lock: spin briefly, then yield, and then sleep until
+ * consumer released data before position required, return error code if it should be dropped */
+static int __overflow_spin( ringbuf_t *rb, uint64_t required, unsigned int *tries, struct timespec *deadline, bool *timed )
+{
+	switch( RINGBUF_OVERFLOW( rb->options ) ) {
+		case RINGBUF_OTIMEOUT: {
+			if( !*timed ) {
+				__deadline( deadline, CLOCK_REALTIME, rb->timeout_ms );
+				*timed = true;
+			} else if( __deadline_passed( deadline, CLOCK_REALTIME ) ) {
+				return ETIMEDOUT;
+			}
+		} break;
+		case RINGBUF_ODROP_NEW: {
+			return EAGAIN;
+		} break;
+	}
+	if( *tries < RBUF_WAIT_SPINS ) {
+		RBUF_CPU_RELAX();
+		( *tries ) ++;
+		return 0;
+	}
+	if( *tries < RBUF_WAIT_SPINS + RBUF_WAIT_YIELDS ) {
+		sched_yield();
+		( *tries ) ++;
+		return 0;
+	}
+	
+	pthread_mutex_lock( &rb->mutex );
+	__atomic_add_fetch( &rb->wr_parked, 1, __ATOMIC_RELAXED );
+	/* NOTE: pairs with the fence in __lockfree_release, either producer sees space released or consumer sees it parked */
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+	if( __atomic_load_n( &rb->rd_released, __ATOMIC_ACQUIRE ) < required ) {
+		RBUF_TRACE( "INTO: producer parked." );
+		if( *timed ) {
+			pthread_cond_timedwait( &rb->cond_data_out, &rb->mutex, deadline );
+		} else {
+			pthread_cond_wait( &rb->cond_data_out, &rb->mutex );
+		}
+	}
+	__atomic_sub_fetch( &rb->wr_parked, 1, __ATOMIC_RELAXED );
+	pthread_mutex_unlock( &rb->mutex );
+	
+	return 0;
+}
+
+/* pid of this process, cached for producers of shared ring-buffer, reset in child after fork */
+static pid_t __owner_pid = 0;
+static pthread_once_t __owner_once = PTHREAD_ONCE_INIT;
+
+static void __owner_forked( void )
+{
+	__owner_pid = 0;
+}
+
+static void __owner_init( void )
+{
+	pthread_atfork( NULL, NULL, __owner_forked );
+}
+
+static pid_t __owner( void )
+{
+	pid_t pid = __atomic_load_n( &__owner_pid, __ATOMIC_RELAXED );
+	if( pid == 0 ) {
+		pthread_once( &__owner_once, __owner_init );
+		pid = getpid();
+		__atomic_store_n( &__owner_pid, pid, __ATOMIC_RELAXED );
+	}
+	
+	return pid;
+}
+
+/* reserve record by CAS, padded to the end of ring first if record should be contiguous but wraps */
+static int __lockfree_reserve( ringbuf_t *rb, uint64_t record_size, bool contiguous, uint64_t *reserved )
+{
+	uint64_t position = __atomic_load_n( &rb->wr_reserved, __ATOMIC_RELAXED );
+	struct timespec deadline;
+	bool timed = false;
+	unsigned int tries = 0;
+	while( true ) {
+		uint64_t padding = 0;
+		if( contiguous && __ring_index( rb, position ) + record_size > rb->capacity + 1 ) {
+			padding = rb->capacity + 1 - __ring_index( rb, position );
+		}
+		uint64_t released = __atomic_load_n( &rb->rd_released, __ATOMIC_ACQUIRE );
+		if( position + padding + record_size - released > rb->capacity + 1 ) {
+			RBUF_TRACE( "INTO: ring-buffer is full, wait for consumer." );
+			int error = __overflow_spin( rb, position + padding + record_size - ( rb->capacity + 1 ), &tries, &deadline, &timed );
+			if( error ) {
+				return error;
+			}
+			position = __atomic_load_n( &rb->wr_reserved, __ATOMIC_RELAXED );
+			continue;
+		}
+		if( __atomic_compare_exchange_n( &rb->wr_reserved, &position, position + padding + record_size, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) {
+			if( padding > 0 ) {
+				__atomic_store_n( __lockfree_header( rb, position ), RBUF_RECORD_COMMITTED | RBUF_RECORD_PADDING | ( padding - sizeof( uint64_t ) ), __ATOMIC_RELEASE );
+			}
+			/* NOTE: size reserved and owner are kept in header until committing, NOT visible to consumer */
+			__atomic_store_n( __lockfree_header( rb, position + padding ), record_size | ( rb->shared ? RBUF_RECORD_OWNER( __owner() ) : 0 ), __ATOMIC_RELAXED );
+			*reserved = position + padding;
+			return 0;
+		}
+	}
+}
+
+/* commit record at position, consumer sleeping is woken up */
+static void __lockfree_commit( ringbuf_t *rb, uint64_t position, unsigned int size, unsigned int level )
+{
+	if( rb->options & RINGBUF_OFRAMED ) {
+		uint64_t timestamp = __timestamp();
+		__ring_write( rb, position + sizeof( uint64_t ), &timestamp, sizeof( timestamp ) );
+	}
+	__atomic_store_n( __lockfree_header( rb, position ), RBUF_RECORD_COMMITTED | size | ( ( uint64_t )( level & 0xFF ) << 40 ), __ATOMIC_RELEASE );
+	
+	/* NOTE: pairs with the fence in ringbuf_wait, either consumer sees the record or producer sees it parked */
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+	if( __atomic_load_n( &rb->parked, __ATOMIC_RELAXED ) ) {
+		pthread_mutex_lock( &rb->mutex );
+		pthread_cond_broadcast( &rb->cond_data_in );
+		pthread_mutex_unlock( &rb->mutex );
+	}
+}
+
+/* reserve space by CAS, copy data and then commit it */
+static int __lockfree_copy_into_record( ringbuf_t *rb, const void *vptr, unsigned int size, unsigned int level )
+{
+	uint64_t position = 0;
+	int error = __lockfree_reserve( rb, __lockfree_size( rb, size ), false, &position );
+	if( error ) {
+		__dropped( rb, size );
+		return error;
+	}
+	__ring_write( rb, position + __lockfree_meta( rb ), vptr, size );
+	__lockfree_commit( rb, position, size, level );
+	
+	return 0;
+}
+
+/* release the oldest record with header given, zeroed for reserving */
+static void __lockfree_release( ringbuf_t *rb, uint64_t header )
+{
+	uint64_t position = rb->rd_released;
+	__ring_zero( rb, position, __lockfree_size( rb, header ) );
+	__atomic_store_n( &rb->rd_released, position + __lockfree_size( rb, header ), __ATOMIC_RELEASE );
+	
+	/* NOTE: pairs with the fence in __overflow_spin, either consumer sees it parked or producer sees space released */
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+	if( __atomic_load_n( &rb->wr_parked, __ATOMIC_RELAXED ) ) {
+		pthread_mutex_lock( &rb->mutex );
+		pthread_cond_broadcast( &rb->cond_data_out );
+		pthread_mutex_unlock( &rb->mutex );
+	}
+}
+
+/* skip the oldest record reserved by process exited without committing, turned into padding and dropped */
+static bool __lockfree_skip_orphan( ringbuf_t *rb, uint64_t header )
+{
+	pid_t owner = RBUF_RECORD_PID( header );
+	if( !rb->shared || owner == 0 ) {
+		return false;
+	}
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	uint64_t now_ns = ( uint64_t )now.tv_sec * 1000000000ULL + ( uint64_t )now.tv_nsec;
+	if( rb->rd_stalled_ns == 0 || rb->rd_stalled != rb->rd_released ) {
+		rb->rd_stalled = rb->rd_released;
+		rb->rd_stalled_ns = now_ns;
+		return false;
+	}
+	if( now_ns - rb->rd_stalled_ns < RBUF_ORPHAN_TIMEOUT_MS * 1000000ULL ) {
+		return false;
+	}
+	if( kill( owner, 0 ) == 0 || errno != ESRCH ) {
+		RBUF_TRACE( "STALLED: owner %d of record alive, checked again later.", (int)owner );
+		rb->rd_stalled_ns = now_ns;
+		return false;
+	}
+	RBUF_TRACE( "STALLED: owner %d of record exited, skipped.", (int)owner );
+	unsigned int record_size = (unsigned int)header;
+	__dropped( rb, record_size - __lockfree_meta( rb ) );
+	__atomic_store_n( __lockfree_header( rb, rb->rd_released ), RBUF_RECORD_COMMITTED | RBUF_RECORD_PADDING | ( record_size - sizeof( uint64_t ) ), __ATOMIC_RELEASE );
+	rb->rd_stalled_ns = 0;
+	
+	return true;
+}
+
+/* copy committed data as a stream, records consumed are zeroed and released */
+static unsigned int __lockfree_copy_from_records( ringbuf_t *rb, void *vptr, unsigned int size )
+{
+	unsigned int length = 0;
+	while( length < size ) {
+		uint64_t position = rb->rd_released;
+		uint64_t header = __atomic_load_n( __lockfree_header( rb, position ), __ATOMIC_ACQUIRE );
+		if( !( header & RBUF_RECORD_COMMITTED ) ) {
+			if( __lockfree_skip_orphan( rb, header ) ) {
+				continue;
+			}
+			break;
+		}
+		unsigned int record_length = (unsigned int)header;
+		if( header & RBUF_RECORD_PADDING ) {
+			__lockfree_release( rb, header );
+			continue;
+		}
+		unsigned int copy_size = RBUF_MIN( record_length - rb->rd_partial, size - length );
+		__ring_read( rb, position + __lockfree_meta( rb ) + rb->rd_partial, (char *)vptr + length, copy_size );
+		length += copy_size;
+		rb->rd_partial += copy_size;
+		if( rb->rd_partial < record_length ) {
+			break;
+		}
+		rb->rd_partial = 0;
+		__lockfree_release( rb, header );
+	}
+	
+	return length;
+}
+
+/* copy data as records of level given, fragments of a record larger than block_size are framed separately */
+static int __copy_into( ringbuf_t *rb, const void *vptr, unsigned int size, unsigned int block_size, unsigned int level )
 {
 	assert( rb );
+	if( rb->options & RINGBUF_OLOCKFREE ) {
+		/* fragments are committed as records, no larger than half of the capacity */
+		unsigned int fragment_size = RBUF_MAX( block_size, rb->capacity >> 2 );
+		fragment_size = RBUF_MIN( fragment_size, rb->capacity >> 1 );
+		for( unsigned int done = 0; done < size; done += RBUF_MIN( fragment_size, size - done ) ) {
+			int error = __lockfree_copy_into_record( rb, (const char *)vptr + done, RBUF_MIN( fragment_size, size - done ), level );
+			if( error ) {
+				return error;
+			}
+		}
+		
+		return 0;
+	}
+	bool framed = rb->options & RINGBUF_OFRAMED;
+	if( framed && block_size >= size ) {
+		/* whole record in one frame, so eviction never splits it */
+		if( size + RBUF_FRAME_HEADER > rb->capacity ) {
+			__dropped( rb, size );
+			return EINVAL;
+		}
+		block_size = size;
+	} else if( framed ) {
+		/* fragments are framed as records, no larger than half of the capacity */
+		block_size = RBUF_MIN( RBUF_MAX( block_size, rb->capacity >> 2 ), rb->capacity >> 1 );
+	}
+	struct timespec deadline;
+	bool timed = false;
 	unsigned int left_size = size;
 	while( left_size > 0 ) {
+		unsigned int need = framed ? RBUF_FRAME_HEADER + RBUF_MIN( left_size, block_size ) : block_size;
 		pthread_mutex_lock( &rb->mutex );
-		while( __size_free(rb) < block_size ) {
-			pthread_cond_wait( &rb->cond_data_out, &rb->mutex );
+		while( __size_free(rb) < need ) {
+			int error = __overflow_wait( rb, &deadline, &timed );
+			if( error ) {
+				RBUF_TRACE( "INTO: dropped by overflow policy, error = %d.", error );
+				pthread_mutex_unlock( &rb->mutex );
+				__dropped( rb, left_size );
+				return error;
+			}
 		}
-		unsigned int copy_size = RBUF_MIN( left_size, __size_free(rb) );
-		unsigned int next_wr = __offset_next_n( rb, rb->wr_offset, copy_size );
-		unsigned int non_overflow_size = RBUF_MIN( copy_size, rb->capacity + 1 - rb->wr_offset );
-		memcpy( rb->data + rb->wr_offset, vptr, non_overflow_size );
-		if( non_overflow_size < copy_size ) {
-			memcpy( rb->data, (char *)vptr + non_overflow_size, copy_size - non_overflow_size );
+		unsigned int copy_size = 0, next_wr = 0, non_overflow_size = 0;
+		if( framed ) {
+			ringbuf_record_t header = { .length = RBUF_MIN( left_size, block_size ), .level = level, .timestamp = __timestamp() };
+			__ring_write( rb, rb->wr_offset, &header, RBUF_FRAME_HEADER );
+			__ring_write( rb, rb->wr_offset + RBUF_FRAME_HEADER, vptr, header.length );
+			copy_size = header.length;
+			next_wr = __offset_next_n( rb, rb->wr_offset, RBUF_FRAME_HEADER + header.length );
+		} else {
+			copy_size = RBUF_MIN( left_size, __size_free(rb) );
+			next_wr = __offset_next_n( rb, rb->wr_offset, copy_size );
+			non_overflow_size = RBUF_MIN( copy_size, rb->capacity + 1 - rb->wr_offset );
+			memcpy( __ring_data( rb ) + rb->wr_offset, vptr, non_overflow_size );
+			if( non_overflow_size < copy_size ) {
+				memcpy( __ring_data( rb ), (char *)vptr + non_overflow_size, copy_size - non_overflow_size );
+			}
 		}
+		vptr = (const char *)vptr + copy_size;
 		left_size -= copy_size;
 		RBUF_TRACE( "INTO: free/capacity = %u/%u, non-overflow-size/read-length = %u/%u, next_wr = %u", __size_free( rb ), rb->capacity, non_overflow_size, copy_size, next_wr );
-		rb->wr_offset = next_wr;
-		pthread_cond_broadcast( &rb->cond_data_in );
+		__atomic_store_n( &rb->wr_offset, next_wr, __ATOMIC_RELEASE );
+		if( rb->parked ) {
+			pthread_cond_broadcast( &rb->cond_data_in );
+		}
 		pthread_mutex_unlock( &rb->mutex );
 	}
 	
 	return 0;
 }
 
+/* @brief  copy data to ring-buffer
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         vptr/size, data to copy into
+ *         block_size, minimal size of block to copy each time
+ * @return error code(EAGAIN/ETIMEDOUT if the rest of data dropped by overflow policy)
+ * @note   1. data given may be separated into several fragments
+ *         2. but NO LIMIT on size of data
+ **/
+int ringbuf_copy_into_separable( ringbuf_t *rb, const void *vptr, unsigned int size, unsigned int block_size )
+{
+	return __copy_into( rb, vptr, size, block_size, 0 );
+}
+
 /* @brief  copy data to ring-buffer
  * @param  rb, pointer to ring-buffer(Non-NULL required)
  *         vptr/size, data to copy into ring-buffer
- * @return error code(EINVAL if size of data larger than half of the capacity)
+ * @return error code(EINVAL if size of data larger than half of the capacity,
+ *         EAGAIN/ETIMEDOUT if dropped by overflow policy)
  **/
 int ringbuf_copy_into( ringbuf_t *rb, const void *vptr, unsigned int size )
+{
+	return ringbuf_copy_into_record( rb, vptr, size, 0 );
+}
+
+/* @brief  copy a record of level given to ring-buffer
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         vptr/size, data of record
+ *         level, level of record, 0~255
+ * @return error code(EINVAL if size of data larger than half of the capacity,
+ *         EAGAIN/ETIMEDOUT if dropped by overflow policy)
+ **/
+int ringbuf_copy_into_record( ringbuf_t *rb, const void *vptr, unsigned int size, unsigned int level )
 {
 	assert( rb );
 	if( size > ( rb->capacity >> 1 ) ) {
 		RBUF_TRACE( "Buffer required cann't be satisfied by pre-created ring-buffer." );
 		return EINVAL;
 	}
-	ringbuf_copy_into_separable( rb, vptr, size, size );
+	if( rb->options & RINGBUF_OLOCKFREE ) {
+		return size > 0 ? __lockfree_copy_into_record( rb, vptr, size, level ) : 0;
+	}
+	
+	return __copy_into( rb, vptr, size, size, level );
+}
+
+/* @brief  reserve contiguous space for a record, filled in place and then committed
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         size, max size of the record
+ *         vptr, pointer to space reserved
+ * @return error code(ENOTSUP if neither RINGBUF_OLOCKFREE nor RINGBUF_OFRAMED,
+ *         EINVAL if size larger than half of the capacity, EAGAIN/ETIMEDOUT by overflow policy)
+ * @note   1. space at the end of ring is skipped by a padding record if the record wraps
+ *         2. ringbuf_commit MUST follow on the same thread, mutex is held in between if NOT lock-free
+ **/
+int ringbuf_reserve( ringbuf_t *rb, unsigned int size, void **vptr )
+{
+	assert( rb && vptr );
+	*vptr = NULL;
+	if( !( rb->options & ( RINGBUF_OLOCKFREE | RINGBUF_OFRAMED ) ) ) {
+		RBUF_TRACE( "Stream can't be padded, copy it instead." );
+		return ENOTSUP;
+	}
+	if( size + 2 * RBUF_FRAME_HEADER > ( rb->capacity >> 1 ) ) {
+		RBUF_TRACE( "Space required cann't be satisfied by pre-created ring-buffer." );
+		return EINVAL;
+	}
+	if( rb->options & RINGBUF_OLOCKFREE ) {
+		uint64_t position = 0;
+		uint64_t record_size = __lockfree_size( rb, size );
+		int error = __lockfree_reserve( rb, record_size, true, &position );
+		if( error ) {
+			__dropped( rb, 0 );
+			return error;
+		}
+		*vptr = __ring_data( rb ) + __ring_index( rb, position + __lockfree_meta( rb ) );
+		
+		return 0;
+	}
+	
+	struct timespec deadline;
+	bool timed = false;
+	pthread_mutex_lock( &rb->mutex );
+	while( true ) {
+		unsigned int data_offset = __offset_next_n( rb, rb->wr_offset, RBUF_FRAME_HEADER );
+		unsigned int padding = data_offset + size > rb->capacity + 1 ? rb->capacity + 1 - data_offset : 0;
+		unsigned int need = padding > 0 ? RBUF_FRAME_HEADER + padding + RBUF_FRAME_HEADER + size : RBUF_FRAME_HEADER + size;
+		if( __size_free( rb ) >= need ) {
+			if( padding > 0 ) {
+				ringbuf_record_t header = { .length = RBUF_FRAME_PADDING | padding };
+				__ring_write( rb, rb->wr_offset, &header, RBUF_FRAME_HEADER );
+				__atomic_store_n( &rb->wr_offset, __offset_next_n( rb, rb->wr_offset, RBUF_FRAME_HEADER + padding ), __ATOMIC_RELEASE );
+			}
+			break;
+		}
+		int error = __overflow_wait( rb, &deadline, &timed );
+		if( error ) {
+			RBUF_TRACE( "RESERVE: dropped by overflow policy, error = %d.", error );
+			pthread_mutex_unlock( &rb->mutex );
+			__dropped( rb, 0 );
+			return error;
+		}
+	}
+	*vptr = __ring_data( rb ) + __offset_next_n( rb, rb->wr_offset, RBUF_FRAME_HEADER );
+	
+	return 0;
+}
+
+/* @brief  commit record reserved by ringbuf_reserve
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         vptr, pointer to space reserved
+ *         size, actual size of the record, no more than size reserved, zero to cancel
+ * @return error code(always zero for this interface)
+ **/
+int ringbuf_commit( ringbuf_t *rb, void *vptr, unsigned int size )
+{
+	return ringbuf_commit_record( rb, vptr, size, 0 );
+}
+
+/* @brief  commit record of level given, reserved by ringbuf_reserve
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         vptr, pointer to space reserved
+ *         size, actual size of the record, no more than size reserved, zero to cancel
+ *         level, level of record, 0~255
+ * @return error code(always zero for this interface)
+ **/
+int ringbuf_commit_record( ringbuf_t *rb, void *vptr, unsigned int size, unsigned int level )
+{
+	assert( rb && vptr );
+	if( rb->options & RINGBUF_OLOCKFREE ) {
+		uint64_t *header = (uint64_t *)( (char *)vptr - __lockfree_meta( rb ) );
+		uint64_t position = (char *)header - __ring_data( rb );
+		uint64_t record_size = ( uint32_t )__atomic_load_n( header, __ATOMIC_RELAXED );
+		/* NOTE: zero size cancels the record, header included */
+		uint64_t used = size > 0 ? __lockfree_size( rb, size ) : 0;
+		assert( used <= record_size );
+		uint64_t padding = record_size - used;
+		uint64_t reserved = __atomic_load_n( &rb->wr_reserved, __ATOMIC_RELAXED );
+		if( padding > 0 && __ring_index( rb, reserved ) == __ring_index( rb, position + record_size ) ) {
+			/* NOTE: the last reservation, the rest is zeroed and given back instead of padded, space reserved MUST be zero */
+			__ring_zero( rb, position + used, padding );
+			if( __atomic_compare_exchange_n( &rb->wr_reserved, &reserved, reserved - padding, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) {
+				RBUF_TRACE( "COMMIT: %llu bytes given back.", (unsigned long long)padding );
+				padding = 0;
+			}
+		}
+		if( padding > 0 ) {
+			/* NOTE: the rest reserved is skipped, NOT part of the ring wrapped */
+			__atomic_store_n( __lockfree_header( rb, position + used ), RBUF_RECORD_COMMITTED | RBUF_RECORD_PADDING | ( padding - sizeof( uint64_t ) ), __ATOMIC_RELEASE );
+		}
+		if( used > 0 ) {
+			__lockfree_commit( rb, position, size, level );
+		}
+		
+		return 0;
+	}
+	
+	assert( (char *)vptr == __ring_data( rb ) + __offset_next_n( rb, rb->wr_offset, RBUF_FRAME_HEADER ) );
+	if( size > 0 ) {
+		ringbuf_record_t header = { .length = size, .level = level, .timestamp = __timestamp() };
+		__ring_write( rb, rb->wr_offset, &header, RBUF_FRAME_HEADER );
+		__atomic_store_n( &rb->wr_offset, __offset_next_n( rb, rb->wr_offset, RBUF_FRAME_HEADER + size ), __ATOMIC_RELEASE );
+		if( rb->parked ) {
+			pthread_cond_broadcast( &rb->cond_data_in );
+		}
+	}
+	pthread_mutex_unlock( &rb->mutex );
 	
 	return 0;
 }
@@ -156,6 +1106,16 @@ int ringbuf_copy_into( ringbuf_t *rb, const void *vptr, unsigned int size )
  **/
 int ringbuf_copy_from( ringbuf_t *rb, void *vptr, unsigned int size, bool no_wait )
 {
+	if( rb->options & RINGBUF_OLOCKFREE ) {
+		unsigned int length = __lockfree_copy_from_records( rb, vptr, size );
+		while( length == 0 && !no_wait && size > 0 ) {
+			/* NOTE: spin, then yield, and then sleep until producers commit, as mutex mode does */
+			ringbuf_wait( rb, 0 );
+			length = __lockfree_copy_from_records( rb, vptr, size );
+		}
+		
+		return length;
+	}
 	pthread_mutex_lock( &rb->mutex );
 	if( no_wait ) {
 		if( __size_used(rb) == 0 ) {
@@ -164,26 +1124,239 @@ int ringbuf_copy_from( ringbuf_t *rb, void *vptr, unsigned int size, bool no_wai
 		}
 	} else {
 		while( __size_used(rb) == 0 ) {
+			rb->parked = 1;
 			pthread_cond_wait( &rb->cond_data_in, &rb->mutex );
+			rb->parked = 0;
 		}
 	}
 	
+	if( rb->options & RINGBUF_OFRAMED ) {
+		/* copy data of frames as a stream, frame being read is NOT evicted */
+		unsigned int length = 0;
+		while( length < size && __size_used( rb ) > 0 ) {
+			uint32_t frame_length = 0;
+			__ring_read( rb, rb->rd_offset, &frame_length, sizeof( frame_length ) );
+			if( frame_length & RBUF_FRAME_PADDING ) {
+				__atomic_store_n( &rb->rd_offset, __offset_next_n( rb, rb->rd_offset, RBUF_FRAME_HEADER + RBUF_FRAME_LENGTH( frame_length ) ), __ATOMIC_RELEASE );
+				continue;
+			}
+			unsigned int copy_size = RBUF_MIN( frame_length - rb->rd_partial, size - length );
+			__ring_read( rb, (uint64_t)rb->rd_offset + RBUF_FRAME_HEADER + rb->rd_partial, (char *)vptr + length, copy_size );
+			length += copy_size;
+			rb->rd_partial += copy_size;
+			if( rb->rd_partial < frame_length ) {
+				break;
+			}
+			rb->rd_partial = 0;
+			__atomic_store_n( &rb->rd_offset, __offset_next_n( rb, rb->rd_offset, RBUF_FRAME_HEADER + frame_length ), __ATOMIC_RELEASE );
+		}
+		pthread_cond_broadcast( &rb->cond_data_out );
+		pthread_mutex_unlock( &rb->mutex );
+		
+		return length;
+	}
 	unsigned int bytes_used = __size_used( rb );
 	unsigned int length = RBUF_MIN( bytes_used, size );
 	unsigned int next_rd = __offset_next_n( rb, rb->rd_offset, length );
 	unsigned int non_overflow_size = RBUF_MIN( length, rb->capacity + 1 - rb->rd_offset );
-	memcpy( vptr, rb->data + rb->rd_offset, non_overflow_size );
+	memcpy( vptr, __ring_data( rb ) + rb->rd_offset, non_overflow_size );
 	if( non_overflow_size < length ) {
-		memcpy( (void *)( (char *)vptr + non_overflow_size ), rb->data, length - non_overflow_size );
+		memcpy( (void *)( (char *)vptr + non_overflow_size ), __ring_data( rb ), length - non_overflow_size );
 	}
 	RBUF_TRACE( "FROM: used/capacity = %u/%u, non-overflow-size/read-length = %u/%u, next_rd = %u", bytes_used, rb->capacity, non_overflow_size, length, next_rd );
-	rb->rd_offset = next_rd;
+	__atomic_store_n( &rb->rd_offset, next_rd, __ATOMIC_RELEASE );
 	pthread_cond_broadcast( &rb->cond_data_out );
 	pthread_mutex_unlock( &rb->mutex );
 	
 	return length;
 }
 
+/* header of the oldest record, padding skipped, mutex should be held if NOT lock-free */
+static int __peek_record( ringbuf_t *rb, ringbuf_record_t *record )
+{
+	if( rb->options & RINGBUF_OLOCKFREE ) {
+		while( true ) {
+			uint64_t header = __atomic_load_n( __lockfree_header( rb, rb->rd_released ), __ATOMIC_ACQUIRE );
+			if( !( header & RBUF_RECORD_COMMITTED ) ) {
+				if( __lockfree_skip_orphan( rb, header ) ) {
+					continue;
+				}
+				return EAGAIN;
+			}
+			if( header & RBUF_RECORD_PADDING ) {
+				__lockfree_release( rb, header );
+				continue;
+			}
+			record->length = (unsigned int)header - rb->rd_partial;
+			record->level = RBUF_RECORD_LEVEL( header );
+			record->timestamp = 0;
+			if( rb->options & RINGBUF_OFRAMED ) {
+				__ring_read( rb, rb->rd_released + sizeof( uint64_t ), &record->timestamp, sizeof( record->timestamp ) );
+			}
+			
+			return 0;
+		}
+	}
+	while( __size_used( rb ) > 0 ) {
+		__ring_read( rb, rb->rd_offset, record, RBUF_FRAME_HEADER );
+		if( record->length & RBUF_FRAME_PADDING ) {
+			__atomic_store_n( &rb->rd_offset, __offset_next_n( rb, rb->rd_offset, RBUF_FRAME_HEADER + RBUF_FRAME_LENGTH( record->length ) ), __ATOMIC_RELEASE );
+			continue;
+		}
+		record->length -= rb->rd_partial;
+		
+		return 0;
+	}
+	
+	return EAGAIN;
+}
+
+/* @brief  get header of the oldest record in ring-buffer, NOT consumed
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         record, header of record
+ * @return error code(ENOTSUP if neither RINGBUF_OLOCKFREE nor RINGBUF_OFRAMED, EAGAIN if no record)
+ **/
+int ringbuf_peek_record( ringbuf_t *rb, ringbuf_record_t *record )
+{
+	assert( rb && record );
+	if( !( rb->options & ( RINGBUF_OLOCKFREE | RINGBUF_OFRAMED ) ) ) {
+		return ENOTSUP;
+	}
+	if( rb->options & RINGBUF_OLOCKFREE ) {
+		return __peek_record( rb, record );
+	}
+	pthread_mutex_lock( &rb->mutex );
+	int error = __peek_record( rb, record );
+	pthread_mutex_unlock( &rb->mutex );
+	
+	return error;
+}
+
+/* @brief  read the oldest record in ring-buffer as a whole
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         record, header of record read, NULL to ignore
+ *         vptr/size, buffer to save data, the rest of record larger than size is skipped
+ * @return error code(ENOTSUP if neither RINGBUF_OLOCKFREE nor RINGBUF_OFRAMED, EAGAIN if no record)
+ **/
+int ringbuf_read_record( ringbuf_t *rb, ringbuf_record_t *record, void *vptr, unsigned int size )
+{
+	assert( rb );
+	if( !( rb->options & ( RINGBUF_OLOCKFREE | RINGBUF_OFRAMED ) ) ) {
+		return ENOTSUP;
+	}
+	ringbuf_record_t header;
+	if( rb->options & RINGBUF_OLOCKFREE ) {
+		int error = __peek_record( rb, &header );
+		if( error ) {
+			return error;
+		}
+		if( size > 0 ) {
+			__ring_read( rb, rb->rd_released + __lockfree_meta( rb ) + rb->rd_partial, vptr, RBUF_MIN( size, header.length ) );
+		}
+		rb->rd_partial = 0;
+		__lockfree_release( rb, *__lockfree_header( rb, rb->rd_released ) );
+	} else {
+		pthread_mutex_lock( &rb->mutex );
+		int error = __peek_record( rb, &header );
+		if( error ) {
+			pthread_mutex_unlock( &rb->mutex );
+			return error;
+		}
+		if( size > 0 ) {
+			__ring_read( rb, (uint64_t)rb->rd_offset + RBUF_FRAME_HEADER + rb->rd_partial, vptr, RBUF_MIN( size, header.length ) );
+		}
+		__atomic_store_n( &rb->rd_offset, __offset_next_n( rb, rb->rd_offset, RBUF_FRAME_HEADER + rb->rd_partial + header.length ), __ATOMIC_RELEASE );
+		rb->rd_partial = 0;
+		pthread_cond_broadcast( &rb->cond_data_out );
+		pthread_mutex_unlock( &rb->mutex );
+	}
+	if( record ) {
+		*record = header;
+	}
+	
+	return 0;
+}
+
+/* check if there is data to read, lock-free */
+static bool __has_data( const ringbuf_t *rb )
+{
+	if( rb->options & RINGBUF_OLOCKFREE ) {
+		uint64_t header = __atomic_load_n( __lockfree_header( rb, rb->rd_released ), __ATOMIC_ACQUIRE );
+		return ( header & RBUF_RECORD_COMMITTED ) != 0;
+	}
+	
+	return __atomic_load_n( &rb->wr_offset, __ATOMIC_ACQUIRE ) != __atomic_load_n( &rb->rd_offset, __ATOMIC_ACQUIRE );
+}
+
+/* @brief  wait for data in ring-buffer: spin briefly, then yield, and then sleep
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ *         timeout_ms, max time to sleep, 0 to sleep until data in or woken up
+ * @return true if there is data in ring-buffer
+ * @note   for the single consumer, producers signal it only when it's sleeping
+ **/
+bool ringbuf_wait( ringbuf_t *rb, unsigned int timeout_ms )
+{
+	assert( rb );
+	for( int i = 0; i < RBUF_WAIT_SPINS; i ++ ) {
+		if( __has_data( rb ) ) {
+			return true;
+		}
+		RBUF_CPU_RELAX();
+	}
+	for( int i = 0; i < RBUF_WAIT_YIELDS; i ++ ) {
+		if( __has_data( rb ) ) {
+			return true;
+		}
+		sched_yield();
+	}
+	
+	/* NOTE: record of owner exited is never committed, sleep bounded for consumer to skip it */
+	if( rb->shared && ( rb->options & RINGBUF_OLOCKFREE ) && ( timeout_ms == 0 || timeout_ms > RBUF_ORPHAN_TIMEOUT_MS ) ) {
+		uint64_t header = __atomic_load_n( __lockfree_header( rb, rb->rd_released ), __ATOMIC_ACQUIRE );
+		if( !( header & RBUF_RECORD_COMMITTED ) && RBUF_RECORD_PID( header ) != 0 ) {
+			timeout_ms = RBUF_ORPHAN_TIMEOUT_MS;
+		}
+	}
+	struct timespec deadline;
+	if( timeout_ms > 0 ) {
+		clock_gettime( CLOCK_REALTIME, &deadline );
+		deadline.tv_sec += timeout_ms / 1000;
+		deadline.tv_nsec += ( timeout_ms % 1000 ) * 1000000L;
+		if( deadline.tv_nsec >= 1000000000L ) {
+			deadline.tv_sec ++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+	}
+	pthread_mutex_lock( &rb->mutex );
+	__atomic_store_n( &rb->parked, 1, __ATOMIC_RELAXED );
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+	while( !rb->wakeup && !__has_data( rb ) ) {
+		RBUF_TRACE( "WAIT: consumer parked." );
+		if( timeout_ms == 0 ) {
+			pthread_cond_wait( &rb->cond_data_in, &rb->mutex );
+		} else if( pthread_cond_timedwait( &rb->cond_data_in, &rb->mutex, &deadline ) == ETIMEDOUT ) {
+			break;
+		}
+	}
+	__atomic_store_n( &rb->parked, 0, __ATOMIC_RELAXED );
+	rb->wakeup = false;
+	pthread_mutex_unlock( &rb->mutex );
+	
+	return __has_data( rb );
+}
+
+/* @brief  wake up consumer waiting in ringbuf_wait, e.g. to exit
+ * @param  rb, pointer to ring-buffer(Non-NULL required)
+ **/
+void ringbuf_wakeup( ringbuf_t *rb )
+{
+	assert( rb );
+	pthread_mutex_lock( &rb->mutex );
+	rb->wakeup = true;
+	pthread_cond_broadcast( &rb->cond_data_in );
+	pthread_mutex_unlock( &rb->mutex );
+}
+
 /* @brief  Locate the first occurrence of character c in ring-buffer
  * @param  rb, pointer to ring-buffer(Non-NULL required)
  *         c, character to locate
@@ -194,12 +1367,59 @@ int ringbuf_copy_from( ringbuf_t *rb, void *vptr, unsigned int size, bool no_wai
 unsigned int ringbuf_findchr( const ringbuf_t *rb, int c, unsigned int offset )
 {
 	assert( rb );
+	if( rb->options & RINGBUF_OLOCKFREE ) {
+		/* walk committed records, offset counts data only */
+		unsigned int passed = 0, partial = rb->rd_partial;
+		uint64_t position = rb->rd_released;
+		while( true ) {
+			uint64_t header = __atomic_load_n( __lockfree_header( rb, position ), __ATOMIC_ACQUIRE );
+			if( !( header & RBUF_RECORD_COMMITTED ) ) {
+				return passed;
+			}
+			unsigned int record_length = (unsigned int)header;
+			if( header & RBUF_RECORD_PADDING ) {
+				position += __lockfree_size( rb, header );
+				continue;
+			}
+			for( unsigned int i = partial; i < record_length; i ++, passed ++ ) {
+				if( passed >= offset && __ring_data( rb )[__ring_index( rb, position + __lockfree_meta( rb ) + i )] == (char)c ) {
+					return passed;
+				}
+			}
+			partial = 0;
+			position += __lockfree_size( rb, header );
+		}
+	}
+	if( rb->options & RINGBUF_OFRAMED ) {
+		/* walk frames, offset counts data only */
+		unsigned int passed = 0, partial = rb->rd_partial, bytes_used = __size_used( rb );
+		uint64_t position = rb->rd_offset;
+		for( unsigned int walked = 0; walked < bytes_used; ) {
+			uint32_t frame_length = 0;
+			__ring_read( rb, position, &frame_length, sizeof( frame_length ) );
+			if( frame_length & RBUF_FRAME_PADDING ) {
+				walked += RBUF_FRAME_HEADER + RBUF_FRAME_LENGTH( frame_length );
+				position += RBUF_FRAME_HEADER + RBUF_FRAME_LENGTH( frame_length );
+				continue;
+			}
+			for( unsigned int i = partial; i < frame_length; i ++, passed ++ ) {
+				if( passed >= offset && __ring_data( rb )[__ring_index( rb, position + RBUF_FRAME_HEADER + i )] == (char)c ) {
+					return passed;
+				}
+			}
+			partial = 0;
+			walked += RBUF_FRAME_HEADER + frame_length;
+			position += RBUF_FRAME_HEADER + frame_length;
+		}
+		
+		return passed;
+	}
 	unsigned int bytes_used = __size_used( rb );
 	if( offset >= bytes_used ) {
 		return bytes_used;
 	}
 	
-	const char *start = rb->data + __offset_next_n( rb , rb->rd_offset, offset );
+	const char *start = __ring_data( rb ) + __offset_next_n( rb , rb->rd_offset, offset );
 	unsigned int n = RBUF_MIN( bytes_used - offset, rb->capacity + 1 - rb->rd_offset );
 	const char *found = (const char *)memchr( start, c, n );
 	if( found ) {
@@ -18,12 +18,13 @@
 struct __basic_file_printer_context {
 	char *filename;
 	int fd;
+	xlog_printer_wbuf_t *wbuf;		/* XLOG_PRINTER_OCOALESCE */
 	#if (defined XLOG_FEATURE_ENABLE_STATS) && (defined XLOG_FEATURE_ENABLE_STATS_PRINTER)
 	xlog_stats_t stats;
 	#endif
 };
 
-static struct __basic_file_printer_context *__basic_file_create_context( const char *file )
+static struct __basic_file_printer_context *__basic_file_create_context( const char *file, size_t coalesce_size, unsigned int latency_ms )
 {
 	struct __basic_file_printer_context *context = ( struct __basic_file_printer_context * )XLOG_MALLOC( sizeof( struct __basic_file_printer_context ) );
 	if( context ) {
@@ -42,6 +43,18 @@ static struct __basic_file_printer_context *__basic_file_create_context( const c
 			
 			return NULL;
 		}
+		context->wbuf = NULL;
+		if( coalesce_size ) {
+			context->wbuf = xlog_printer_wbuf_create( coalesce_size, latency_ms );
+			if( context->wbuf == NULL ) {
+				__XLOG_TRACE( "Failed to create coalescing buffer." );
+				close( context->fd );
+				XLOG_FREE( context->filename );
+				XLOG_FREE( context );
+				
+				return NULL;
+			}
+		}
 	}
 	
 	return context;
@@ -50,6 +63,8 @@ static struct __basic_file_printer_context *__basic_file_create_context( const c
 static int __basic_file_destory_context( struct __basic_file_printer_context *context )
 {
 	if( context ) {
+		xlog_printer_wbuf_destory( context->wbuf );
+		context->wbuf = NULL;
 		close( context->fd );
 		context->fd = -1;
 		XLOG_FREE( context->filename );
@@ -59,14 +74,17 @@ static int __basic_file_destory_context( struct __basic_file_printer_context *co
 	return 0;
 }
 
-static int __basic_file_append( xlog_printer_t *printer, void *data )
+static int __basic_file_appendl( xlog_printer_t *printer, const void *data, size_t length, int level UNUSED, const struct timespec *ts UNUSED )
 {
 	const char *text = ( const char * )data;
 	struct __basic_file_printer_context *_ctx = ( struct __basic_file_printer_context * )printer->context;
 	int fd = _ctx->fd;
 	if( fd >= 0 ) {
-		size_t size = strlen( text );
+		size_t size = length;
 		XLOG_STATS_UPDATE( &( ( struct __basic_file_printer_context * )printer->context )->stats, BYTE, OUTPUT, size );
+		if( _ctx->wbuf ) {
+			return xlog_printer_wbuf_append( _ctx->wbuf, fd, text, size );
+		}
 		#ifndef XLOG_BENCH_NO_OUTPUT
 		return write( fd, text, size );
 		#else
@@ -78,10 +96,55 @@ static int __basic_file_append( xlog_printer_t *printer, void *data )
 	return 0;
 }
 
-xlog_printer_t *xlog_printer_create_basic_file( const char *file )
+static int __basic_file_append( xlog_printer_t *printer, void *data )
+{
+	const char *text = ( const char * )data;
+	return __basic_file_appendl( printer, text, strlen( text ), XLOG_LEVEL_SILENT, NULL );
+}
+
+static int __basic_file_appendv( xlog_printer_t *printer, const struct iovec *iov, int iovcnt )
+{
+	struct __basic_file_printer_context *_ctx = ( struct __basic_file_printer_context * )printer->context;
+	int fd = _ctx->fd;
+	if( fd >= 0 ) {
+		#ifndef XLOG_BENCH_NO_OUTPUT
+		ssize_t size = _ctx->wbuf ? xlog_printer_wbuf_appendv( _ctx->wbuf, fd, iov, iovcnt ) : xlog_printer_writev( fd, iov, iovcnt );
+		#else
+		ssize_t size = 0;
+		for( int i = 0; i < iovcnt; i ++ ) {
+			size += iov[i].iov_len;
+		}
+		#endif
+		XLOG_STATS_UPDATE( &_ctx->stats, BYTE, OUTPUT, size > 0 ? size : 0 );
+		return size;
+	} else {
+		__XLOG_TRACE( "Invalid file." );
+	}
+	return 0;
+}
+
+static int __basic_file_optctl( xlog_printer_t *printer, int option, void *vptr, size_t size )
+{
+	( void )vptr;
+	( void )size;
+	struct __basic_file_printer_context *_ctx = ( struct __basic_file_printer_context * )printer->context;
+	switch( option ) {
+		case XLOG_PRINTER_CTRL_FLUSH: {
+			if( _ctx->wbuf ) {
+				xlog_printer_wbuf_flush( _ctx->wbuf );
+			}
+		} break;
+		default: {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+xlog_printer_t *xlog_printer_create_basic_file( const char *file, size_t coalesce_size, unsigned int latency_ms )
 {
 	xlog_printer_t *printer = NULL;
-	struct __basic_file_printer_context *_prt_ctx = __basic_file_create_context( file );
+	struct __basic_file_printer_context *_prt_ctx = __basic_file_create_context( file, coalesce_size, latency_ms );
 	if( _prt_ctx ) {
 		printer = ( xlog_printer_t * )XLOG_MALLOC( sizeof( xlog_printer_t ) );
 		if( printer == NULL ) {
@@ -93,7 +156,9 @@ xlog_printer_t *xlog_printer_create_basic_file( const char *file )
 		printer->options = XLOG_PRINTER_TYPE_OPT( XLOG_PRINTER_FILES_BASIC );
 		printer->context = ( void * )_prt_ctx;
 		printer->append = __basic_file_append;
-		printer->optctl = NULL;
+		printer->appendv = __basic_file_appendv;
+		printer->appendl = __basic_file_appendl;
+		printer->optctl = __basic_file_optctl;
 	} else {
 		__XLOG_TRACE( "Failed to create file-basic context." );
 	}
@@ -14,14 +14,28 @@
 #pragma GCC diagnostic ignored "-Wshorten-64-to-32"
 #endif
 
-static int __now_day( void )
+/* NOTE: boundaries are local midnight and every period after it, midnight of tomorrow at the latest */
+static time_t __next_rollover( time_t now, unsigned int rollover_sec )
 {
-	struct timeval tv;
-	gettimeofday( &tv, NULL );
 	struct tm tm;
-	localtime_r( &tv.tv_sec, &tm );
+	localtime_r( &now, &tm );
+	tm.tm_hour = 0;
+	tm.tm_min = 0;
+	tm.tm_sec = 0;
+	tm.tm_isdst = -1;
+	time_t midnight = mktime( &tm );
+	tm.tm_mday += 1;
+	tm.tm_hour = 0;
+	tm.tm_min = 0;
+	tm.tm_sec = 0;
+	tm.tm_isdst = -1;
+	time_t tomorrow = mktime( &tm );
+	if( rollover_sec == 0 || rollover_sec >= XLOG_PRINTER_ROLLOVER_DAILY || midnight > now ) {
+		return tomorrow;
+	}
+	time_t next = midnight + ( ( now - midnight ) / rollover_sec + 1 ) * rollover_sec;
 	
-	return tm.tm_mday;
+	return next < tomorrow ? next : tomorrow;
 }
 
 static int __filepath( char *buffer, size_t size, const char *pattern )
@@ -78,13 +92,15 @@ struct __daily_file_printer_context {
 	char *pattern_file;
 	
 	int current_fd;
-	int current_day;
+	xlog_printer_wbuf_t *wbuf;		/* XLOG_PRINTER_OCOALESCE, flushed before rotating */
+	unsigned int rollover_sec;		/* XLOG_PRINTER_OROLLOVER, daily if zero */
+	time_t next_rollover;			/* instant of next rollover, computed on opening */
 	#if (defined XLOG_FEATURE_ENABLE_STATS) && (defined XLOG_FEATURE_ENABLE_STATS_PRINTER)
 	xlog_stats_t stats;
 	#endif
 };
 
-static struct __daily_file_printer_context *__daily_file_create_context( const char *file )
+static struct __daily_file_printer_context *__daily_file_create_context( const char *file, unsigned int rollover_sec, size_t coalesce_size, unsigned int latency_ms )
 {
 	char buffer[256] = { 0 };
 	if( __filepath( buffer, sizeof( buffer ), file ) != 0 ) {
@@ -95,8 +111,20 @@ static struct __daily_file_printer_context *__daily_file_create_context( const c
 	if( context ) {
 		context->pattern_file = XLOG_STRDUP( file );
 		
-		context->current_day = __now_day();
+		context->rollover_sec = rollover_sec;
+		context->next_rollover = 0;
 		context->current_fd = -1;
+		context->wbuf = NULL;
+		if( coalesce_size ) {
+			context->wbuf = xlog_printer_wbuf_create( coalesce_size, latency_ms );
+			if( context->wbuf == NULL ) {
+				XLOG_TRACE( "Failed to create coalescing buffer." );
+				XLOG_FREE( context->pattern_file );
+				XLOG_FREE( context );
+				
+				return NULL;
+			}
+		}
 		
 		XLOG_STATS_INIT( &context->stats, XLOG_STATS_PRINTER_OPTION );
 	}
@@ -107,6 +135,8 @@ static struct __daily_file_printer_context *__daily_file_create_context( const c
 static int __daily_file_destory_context( struct __daily_file_printer_context *context )
 {
 	if( context ) {
+		xlog_printer_wbuf_destory( context->wbuf );
+		context->wbuf = NULL;
 		close( context->current_fd );
 		context->current_fd = -1;
 		XLOG_FREE( context->pattern_file );
@@ -117,27 +147,35 @@ static int __daily_file_destory_context( struct __daily_file_printer_context *co
 	return 0;
 }
 
+static int daily_file_open( struct __daily_file_printer_context *context, time_t now )
+{
+	char buffer[256] = { 0 };
+	__filepath( buffer, sizeof( buffer ), context->pattern_file );
+	int fd = open( buffer, O_WRONLY | O_CREAT, 0644 );
+	__XLOG_TRACE( "Daily File(%d): %s", fd, buffer );
+	context->current_fd = fd;
+	context->next_rollover = __next_rollover( now, context->rollover_sec );
+	
+	return fd;
+}
+
 static int daily_file_get_fd( xlog_printer_t *printer )
 {
 	struct __daily_file_printer_context *context = ( struct __daily_file_printer_context * )printer->context;
 	if( context ) {
+		/* NOTE: clock of log time compared only, local time is NOT broken down per record */
+		struct timespec now;
+		clock_gettime( XLOG_CLOCK_LOG_TIME, &now );
 		int fd = context->current_fd;
 		if( fd < 0 ) {
-			char buffer[256] = { 0 };
-			__filepath( buffer, sizeof( buffer ), context->pattern_file );
-			fd = open( buffer, O_WRONLY | O_CREAT, 0644 );
-			__XLOG_TRACE( "Daily File(%d): %s", fd, buffer );
-			context->current_fd = fd;
-			context->current_day = __now_day();
-		} else if( context->current_day != __now_day() ) {
+			daily_file_open( context, now.tv_sec );
+		} else if( now.tv_sec >= context->next_rollover ) {
+			if( context->wbuf ) {
+				xlog_printer_wbuf_flush( context->wbuf );
+			}
 			close( fd );
 			context->current_fd = -1;
-			char buffer[256] = { 0 };
-			__filepath( buffer, sizeof( buffer ), context->pattern_file );
-			fd = open( buffer, O_WRONLY | O_CREAT, 0644 );
-			__XLOG_TRACE( "Daily File(%d): %s", fd, buffer );
-			context->current_fd = fd;
-			context->current_day = __now_day();
+			daily_file_open( context, now.tv_sec );
 		}
 		
 		return context->current_fd;
@@ -145,13 +183,17 @@ static int daily_file_get_fd( xlog_printer_t *printer )
 	return -1;
 }
 
-static int daily_file_append( xlog_printer_t *printer, void *data )
+static int daily_file_appendl( xlog_printer_t *printer, const void *data, size_t length, int level UNUSED, const struct timespec *ts UNUSED )
 {
 	const char *text = ( const char * )data;
 	int fd = daily_file_get_fd( printer );
+	struct __daily_file_printer_context *_ctx = ( struct __daily_file_printer_context * )printer->context;
 	if( fd >= 0 ) {
-		size_t size = strlen( text );
+		size_t size = length;
 		XLOG_STATS_UPDATE( &( ( struct __daily_file_printer_context * )printer->context )->stats, BYTE, OUTPUT, size );
+		if( _ctx->wbuf ) {
+			return xlog_printer_wbuf_append( _ctx->wbuf, fd, text, size );
+		}
 		#ifndef XLOG_BENCH_NO_OUTPUT
 		return write( fd, text, size );
 		#else
@@ -161,10 +203,53 @@ static int daily_file_append( xlog_printer_t *printer, void *data )
 	return 0;
 }
 
-xlog_printer_t *xlog_printer_create_daily_file( const char *file )
+static int daily_file_append( xlog_printer_t *printer, void *data )
+{
+	const char *text = ( const char * )data;
+	return daily_file_appendl( printer, text, strlen( text ), XLOG_LEVEL_SILENT, NULL );
+}
+
+static int daily_file_appendv( xlog_printer_t *printer, const struct iovec *iov, int iovcnt )
+{
+	int fd = daily_file_get_fd( printer );
+	struct __daily_file_printer_context *_ctx = ( struct __daily_file_printer_context * )printer->context;
+	if( fd >= 0 ) {
+		#ifndef XLOG_BENCH_NO_OUTPUT
+		ssize_t size = _ctx->wbuf ? xlog_printer_wbuf_appendv( _ctx->wbuf, fd, iov, iovcnt ) : xlog_printer_writev( fd, iov, iovcnt );
+		#else
+		ssize_t size = 0;
+		for( int i = 0; i < iovcnt; i ++ ) {
+			size += iov[i].iov_len;
+		}
+		#endif
+		XLOG_STATS_UPDATE( &( ( struct __daily_file_printer_context * )printer->context )->stats, BYTE, OUTPUT, size > 0 ? size : 0 );
+		return size;
+	}
+	return 0;
+}
+
+static int daily_file_optctl( xlog_printer_t *printer, int option, void *vptr, size_t size )
+{
+	( void )vptr;
+	( void )size;
+	struct __daily_file_printer_context *_ctx = ( struct __daily_file_printer_context * )printer->context;
+	switch( option ) {
+		case XLOG_PRINTER_CTRL_FLUSH: {
+			if( _ctx->wbuf ) {
+				xlog_printer_wbuf_flush( _ctx->wbuf );
+			}
+		} break;
+		default: {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+xlog_printer_t *xlog_printer_create_daily_file( const char *file, unsigned int rollover_sec, size_t coalesce_size, unsigned int latency_ms )
 {
 	xlog_printer_t *printer = NULL;
-	struct __daily_file_printer_context *_prt_ctx = __daily_file_create_context( file );
+	struct __daily_file_printer_context *_prt_ctx = __daily_file_create_context( file, rollover_sec, coalesce_size, latency_ms );
 	if( _prt_ctx ) {
 		printer = ( xlog_printer_t * ) XLOG_MALLOC( sizeof( xlog_printer_t ) );
 		if( printer == NULL ) {
@@ -176,7 +261,9 @@ xlog_printer_t *xlog_printer_create_daily_file( const char *file )
 		printer->context = ( void * )_prt_ctx;
 		printer->options = XLOG_PRINTER_FILES_DAILY;
 		printer->append = daily_file_append;
-		printer->optctl = NULL;
+		printer->appendv = daily_file_appendv;
+		printer->appendl = daily_file_appendl;
+		printer->optctl = daily_file_optctl;
 	}
 	
 	return printer;
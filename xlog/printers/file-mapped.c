@@ -0,0 +1,47 @@
+#include <xlog/xlog.h>
+#include <xlog/xlog_helper.h>
+
+#include <xlog/plugins/ringbuf.h>
+
+#include "internal.h"
+
+#ifdef __GNUC__
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wunknown-pragmas"
+#pragma GCC diagnostic ignored "-Wzero-length-array"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#pragma GCC diagnostic ignored "-Wcast-qual"
+#pragma GCC diagnostic ignored "-Wcast-align"
+#pragma GCC diagnostic ignored "-Wshorten-64-to-32"
+#endif
+
+#undef __XLOG_TRACE
+#define __XLOG_TRACE(...) // xlog_output_rawlog( xlog_printer_create( XLOG_PRINTER_STDERR ), NULL, "TRACE: ", "\r\n", __VA_ARGS__ )
+
+#define MAPPED_FILE_LAST_SUFFIX	".last"
+
+/** flight recorder: records copied into ring-buffer mapped from file, the oldest evicted, read back by xlog-recover */
+xlog_printer_t *xlog_printer_create_mapped_file( const char *file, size_t capacity )
+{
+	/* NOTE: records of the last run, e.g. crashed, are kept for xlog-recover */
+	size_t length = strlen( file ) + sizeof( MAPPED_FILE_LAST_SUFFIX );
+	char *last = ( char * )XLOG_MALLOC( length );
+	if( last == NULL ) {
+		return NULL;
+	}
+	snprintf( last, length, "%s%s", file, MAPPED_FILE_LAST_SUFFIX );
+	if( rename( file, last ) != 0 && errno != ENOENT ) {
+		__XLOG_TRACE( "Failed to keep records of the last run, 'cause %s.", strerror( errno ) );
+	}
+	XLOG_FREE( last );
+	
+	/* NOTE: no syscall to append, evicting and copying under mutex of ring-buffer */
+	ringbuf_t *rbuff = ringbuf_open_file( file, capacity, RINGBUF_ODROP_OLD );
+	if( rbuff == NULL ) {
+		__XLOG_TRACE( "Failed to map file(%s), 'cause %s.", file, strerror( errno ) );
+		return NULL;
+	}
+	
+	return xlog_printer_create_mapped_ringbuf( rbuff, XLOG_PRINTER_TYPE_OPT( XLOG_PRINTER_FILES_MAPPED ) );
+}
@@ -1,3 +1,6 @@
+#if (defined __linux__) && !(defined _GNU_SOURCE)
+#define _GNU_SOURCE		/* fallocate */
+#endif
 #include <xlog/xlog.h>
 #include <xlog/xlog_helper.h>
 
@@ -48,20 +51,114 @@ static int __filepath( char *buffer, size_t size, const char *pattern, int i )
 
 
 /** Rotating files */
+#define ROTATING_SLOTS			4		/* files of latest generations, power of 2 */
+#define ROTATING_BYTES_BITS		40		/* bytes reserved in file of current generation, low bits of state */
+#define ROTATING_BYTES_MASK		( ( 1ULL << ROTATING_BYTES_BITS ) - 1 )
+#define ROTATING_HELPER_WAIT_MS	10		/* retry of helper while files retired are still written */
+
+/* NOTE: file of a generation, closed by helper once retired and NOT written */
+struct __rotating_file_slot {
+	int fd;
+	unsigned int writers;
+};
+
 struct __rotating_file_printer_context {
 	char *pattern_file;
 	size_t max_size_per_file;
 	size_t max_file_to_ratating;
 	
-	int current_fd;
+	/* NOTE: generation << ROTATING_BYTES_BITS | bytes, reserved by appenders with CAS, never locked */
+	uint64_t state;
+	struct __rotating_file_slot slots[ROTATING_SLOTS];
+	
+	/* NOTE: rotation elected by trylock, file opened ahead of time by helper, swapped in under mutex */
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	pthread_t helper;
+	bool helping;
+	bool exiting;
 	int current_index;
-	int current_bytes;
+	int next_fd;
+	
+	xlog_printer_wbuf_t *wbuf;		/* XLOG_PRINTER_OCOALESCE, flushed before file retired is closed */
 	#if (defined XLOG_FEATURE_ENABLE_STATS) && (defined XLOG_FEATURE_ENABLE_STATS_PRINTER)
 	xlog_stats_t stats;
 	#endif
 };
 
-static struct __rotating_file_printer_context *__rotating_file_create_context( const char *file, size_t max_size_per_file, size_t max_file_to_ratating )
+static int rotating_file_open( struct __rotating_file_printer_context *context, int index )
+{
+	char buffer[256] = { 0 };
+	__filepath( buffer, sizeof( buffer ), context->pattern_file, index );
+	int fd = open( buffer, O_WRONLY | O_CREAT, 0644 );
+	#if (defined FALLOC_FL_KEEP_SIZE)
+	/* NOTE: blocks allocated ahead, size of file unchanged */
+	if( fd >= 0 && fallocate( fd, FALLOC_FL_KEEP_SIZE, 0, context->max_size_per_file ) != 0 ) {
+		__XLOG_TRACE( "Failed to allocate file(%s), 'cause %s.", buffer, strerror( errno ) );
+	}
+	#endif
+	
+	return fd;
+}
+
+/** open next file ahead of time, close files retired once NOT written */
+static void *rotating_file_helper( void *arg )
+{
+	struct __rotating_file_printer_context *context = ( struct __rotating_file_printer_context * )arg;
+	pthread_mutex_lock( &context->mutex );
+	while( !context->exiting ) {
+		bool pending = false;
+		if( context->next_fd < 0 ) {
+			int index = ( context->current_index + 1 ) % context->max_file_to_ratating;
+			pthread_mutex_unlock( &context->mutex );
+			int fd = rotating_file_open( context, index );
+			pthread_mutex_lock( &context->mutex );
+			context->next_fd = fd;
+			pending = fd < 0;
+		}
+		uint64_t generation = __atomic_load_n( &context->state, __ATOMIC_ACQUIRE ) >> ROTATING_BYTES_BITS;
+		for( unsigned int i = 1; i < ROTATING_SLOTS; i ++ ) {
+			struct __rotating_file_slot *slot = &context->slots[( generation - i ) & ( ROTATING_SLOTS - 1 )];
+			if( slot->fd < 0 ) {
+				continue;
+			}
+			if( __atomic_load_n( &slot->writers, __ATOMIC_SEQ_CST ) ) {
+				pending = true;
+				continue;
+			}
+			int fd = slot->fd;
+			slot->fd = -1;
+			pthread_mutex_unlock( &context->mutex );
+			if( context->wbuf ) {
+				xlog_printer_wbuf_flush( context->wbuf );
+			}
+			close( fd );
+			pthread_mutex_lock( &context->mutex );
+		}
+		if( context->exiting ) {
+			break;
+		}
+		if( pending ) {
+			struct timespec deadline;
+			clock_gettime( CLOCK_REALTIME, &deadline );
+			deadline.tv_nsec += ROTATING_HELPER_WAIT_MS * 1000000L;
+			if( deadline.tv_nsec >= 1000000000L ) {
+				deadline.tv_sec ++;
+				deadline.tv_nsec -= 1000000000L;
+			}
+			pthread_cond_timedwait( &context->cond, &context->mutex, &deadline );
+		} else {
+			pthread_cond_wait( &context->cond, &context->mutex );
+		}
+	}
+	pthread_mutex_unlock( &context->mutex );
+	
+	return NULL;
+}
+
+static int __rotating_file_destory_context( struct __rotating_file_printer_context *context );
+
+static struct __rotating_file_printer_context *__rotating_file_create_context( const char *file, size_t max_size_per_file, size_t max_file_to_ratating, size_t coalesce_size, unsigned int latency_ms )
 {
 	char buffer[256] = { 0 };
 	if( __filepath( buffer, sizeof( buffer ), file, 0 ) != 0 ) {
@@ -70,15 +167,37 @@ static struct __rotating_file_printer_context *__rotating_file_create_context( c
 	}
 	struct __rotating_file_printer_context *context = ( struct __rotating_file_printer_context * )XLOG_MALLOC( sizeof( struct __rotating_file_printer_context ) );
 	if( context ) {
+		memset( context, 0, sizeof( struct __rotating_file_printer_context ) );
 		context->pattern_file = XLOG_STRDUP( file );
-		context->max_size_per_file = max_size_per_file;
-		context->max_file_to_ratating = max_file_to_ratating;
+		context->max_size_per_file = max_size_per_file < ROTATING_BYTES_MASK ? max_size_per_file : ROTATING_BYTES_MASK;
+		context->max_file_to_ratating = max_file_to_ratating ? max_file_to_ratating : 1;
 		
-		context->current_bytes = 0;
+		context->state = 0;
 		context->current_index = 0;
-		context->current_fd = -1;
-		
+		context->next_fd = -1;
+		for( int i = 0; i < ROTATING_SLOTS; i ++ ) {
+			context->slots[i].fd = -1;
+		}
+		pthread_mutex_init( &context->mutex, NULL );
+		pthread_cond_init( &context->cond, NULL );
 		XLOG_STATS_INIT( &context->stats, XLOG_STATS_PRINTER_OPTION );
+		if( coalesce_size ) {
+			context->wbuf = xlog_printer_wbuf_create( coalesce_size, latency_ms );
+			if( context->wbuf == NULL ) {
+				XLOG_TRACE( "Failed to create coalescing buffer." );
+				__rotating_file_destory_context( context );
+				
+				return NULL;
+			}
+		}
+		context->slots[0].fd = rotating_file_open( context, 0 );
+		context->helping = context->slots[0].fd >= 0 && pthread_create( &context->helper, NULL, rotating_file_helper, context ) == 0;
+		if( !context->helping ) {
+			XLOG_TRACE( "Failed to open file or start helper." );
+			__rotating_file_destory_context( context );
+			
+			return NULL;
+		}
 	}
 	
 	return context;
@@ -87,8 +206,33 @@ static struct __rotating_file_printer_context *__rotating_file_create_context( c
 static int __rotating_file_destory_context( struct __rotating_file_printer_context *context )
 {
 	if( context ) {
-		close( context->current_fd );
-		context->current_fd = -1;
+		if( context->helping ) {
+			pthread_mutex_lock( &context->mutex );
+			context->exiting = true;
+			pthread_cond_signal( &context->cond );
+			pthread_mutex_unlock( &context->mutex );
+			pthread_join( context->helper, NULL );
+		}
+		xlog_printer_wbuf_destory( context->wbuf );
+		context->wbuf = NULL;
+		for( int i = 0; i < ROTATING_SLOTS; i ++ ) {
+			if( context->slots[i].fd >= 0 ) {
+				close( context->slots[i].fd );
+			}
+		}
+		if( context->next_fd >= 0 ) {
+			/* NOTE: next file never written, removed if created ahead of time */
+			struct stat st;
+			if( fstat( context->next_fd, &st ) == 0 && st.st_size == 0 ) {
+				char buffer[256] = { 0 };
+				__filepath( buffer, sizeof( buffer ), context->pattern_file, ( context->current_index + 1 ) % context->max_file_to_ratating );
+				unlink( buffer );
+			}
+			close( context->next_fd );
+		}
+		XLOG_STATS_FINI( &context->stats );
+		pthread_cond_destroy( &context->cond );
+		pthread_mutex_destroy( &context->mutex );
 		XLOG_FREE( context->pattern_file );
 		context->pattern_file = NULL;
 		XLOG_FREE( context );
@@ -97,57 +241,139 @@ static int __rotating_file_destory_context( struct __rotating_file_printer_conte
 	return 0;
 }
 
-static int rotating_file_get_fd( xlog_printer_t *printer )
+/** swap in file opened ahead of time, false if NOT ready or elected to another appender */
+static bool rotating_file_rotate( struct __rotating_file_printer_context *context, uint64_t generation )
 {
-	struct __rotating_file_printer_context *context = ( struct __rotating_file_printer_context * )printer->context;
-	if( context ) {
-		int fd = context->current_fd;
-		if( fd < 0 ) {
-			char buffer[256] = { 0 };
-			__filepath( buffer, sizeof( buffer ), context->pattern_file, context->current_index );
-			fd = open( buffer, O_WRONLY | O_CREAT, 0644 );
-			context->current_fd = fd;
-			context->current_bytes = 0;
-		} else if( context->current_bytes >= context->max_size_per_file ) {
-			close( fd );
-			context->current_fd = -1;
-			if( ( ++ context->current_index ) >= context->max_file_to_ratating ) {
-				context->current_index = 0;
+	if( pthread_mutex_trylock( &context->mutex ) != 0 ) {
+		return false;
+	}
+	bool rotated = true;
+	if( ( __atomic_load_n( &context->state, __ATOMIC_ACQUIRE ) >> ROTATING_BYTES_BITS ) == generation ) {
+		struct __rotating_file_slot *slot = &context->slots[( generation + 1 ) & ( ROTATING_SLOTS - 1 )];
+		if( context->next_fd >= 0 && slot->fd < 0 ) {
+			slot->fd = context->next_fd;
+			context->next_fd = -1;
+			context->current_index = ( context->current_index + 1 ) % context->max_file_to_ratating;
+			/* NOTE: appenders reserving bytes of last generation fail in CAS, try again in this one */
+			__atomic_store_n( &context->state, ( generation + 1 ) << ROTATING_BYTES_BITS, __ATOMIC_RELEASE );
+			pthread_cond_signal( &context->cond );
+		} else {
+			rotated = false;
+		}
+	}
+	pthread_mutex_unlock( &context->mutex );
+	
+	return rotated;
+}
+
+/**
+ * reserve bytes in file of current generation, the file is pinned until released.
+ * NOTE: record crossing the limit is kept in current file, the next one rotates as before;
+ *       file is overfilled rather than waiting for helper if next one is NOT ready.
+ */
+static struct __rotating_file_slot *rotating_file_acquire( struct __rotating_file_printer_context *context, size_t size )
+{
+	int yields = 0;
+	uint64_t state = __atomic_load_n( &context->state, __ATOMIC_ACQUIRE );
+	while( true ) {
+		uint64_t generation = state >> ROTATING_BYTES_BITS;
+		struct __rotating_file_slot *slot = &context->slots[generation & ( ROTATING_SLOTS - 1 )];
+		__atomic_add_fetch( &slot->writers, 1, __ATOMIC_SEQ_CST );
+		state = __atomic_load_n( &context->state, __ATOMIC_SEQ_CST );
+		while( ( state >> ROTATING_BYTES_BITS ) == generation ) {
+			if(
+				( state & ROTATING_BYTES_MASK ) >= context->max_size_per_file
+				&& yields < XLOG_LIMIT_PRINTER_WAIT_YIELDS
+			) {
+				break;
+			}
+			if( __atomic_compare_exchange_n( &context->state, &state, state + size, true, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ) ) {
+				return slot;
 			}
-			char buffer[256] = { 0 };
-			__filepath( buffer, sizeof( buffer ), context->pattern_file, context->current_index );
-			fd = open( buffer, O_WRONLY | O_CREAT, 0644 );
-			context->current_fd = fd;
-			context->current_bytes = 0;
 		}
-		
-		return context->current_fd;
+		__atomic_sub_fetch( &context->slots[generation & ( ROTATING_SLOTS - 1 )].writers, 1, __ATOMIC_RELEASE );
+		if( ( state >> ROTATING_BYTES_BITS ) == generation && !rotating_file_rotate( context, generation ) ) {
+			yields ++;
+			sched_yield();
+		}
+		state = __atomic_load_n( &context->state, __ATOMIC_ACQUIRE );
 	}
-	return -1;
 }
 
-static int rotating_file_append( xlog_printer_t *printer, void *data )
+static void rotating_file_release( struct __rotating_file_slot *slot )
+{
+	__atomic_sub_fetch( &slot->writers, 1, __ATOMIC_RELEASE );
+}
+
+static int rotating_file_appendl( xlog_printer_t *printer, const void *data, size_t length, int level UNUSED, const struct timespec *ts UNUSED )
 {
 	const char *text = ( const char * )data;
-	int fd = rotating_file_get_fd( printer );
 	struct __rotating_file_printer_context *_ctx = ( struct __rotating_file_printer_context * )printer->context;
-	if( fd >= 0 ) {
-		size_t size = strlen( text );
-		_ctx->current_bytes += size;
-		XLOG_STATS_UPDATE( &( ( struct __rotating_file_printer_context * )printer->context )->stats, BYTE, OUTPUT, size );
+	struct __rotating_file_slot *slot = rotating_file_acquire( _ctx, length );
+	XLOG_STATS_UPDATE( &_ctx->stats, BYTE, OUTPUT, length );
+	int size = 0;
+	if( _ctx->wbuf ) {
+		size = xlog_printer_wbuf_append( _ctx->wbuf, slot->fd, text, length );
+	} else {
 		#ifndef XLOG_BENCH_NO_OUTPUT
-		return write( fd, text, size );
+		size = write( slot->fd, text, length );
 		#else
-		return size;
+		size = length;
 		#endif
 	}
+	rotating_file_release( slot );
+	
+	return size;
+}
+
+static int rotating_file_append( xlog_printer_t *printer, void *data )
+{
+	const char *text = ( const char * )data;
+	return rotating_file_appendl( printer, text, strlen( text ), XLOG_LEVEL_SILENT, NULL );
+}
+
+static int rotating_file_appendv( xlog_printer_t *printer, const struct iovec *iov, int iovcnt )
+{
+	struct __rotating_file_printer_context *_ctx = ( struct __rotating_file_printer_context * )printer->context;
+	size_t total = 0;
+	for( int i = 0; i < iovcnt; i ++ ) {
+		total += iov[i].iov_len;
+	}
+	/* NOTE: batch is written into current file as a whole, rotated on next appending */
+	struct __rotating_file_slot *slot = rotating_file_acquire( _ctx, total );
+	#ifndef XLOG_BENCH_NO_OUTPUT
+	ssize_t size = _ctx->wbuf ? xlog_printer_wbuf_appendv( _ctx->wbuf, slot->fd, iov, iovcnt ) : xlog_printer_writev( slot->fd, iov, iovcnt );
+	#else
+	ssize_t size = total;
+	#endif
+	rotating_file_release( slot );
+	XLOG_STATS_UPDATE( &_ctx->stats, BYTE, OUTPUT, size > 0 ? size : 0 );
+	
+	return size;
+}
+
+static int rotating_file_optctl( xlog_printer_t *printer, int option, void *vptr, size_t size )
+{
+	( void )vptr;
+	( void )size;
+	struct __rotating_file_printer_context *_ctx = ( struct __rotating_file_printer_context * )printer->context;
+	switch( option ) {
+		case XLOG_PRINTER_CTRL_FLUSH: {
+			if( _ctx->wbuf ) {
+				xlog_printer_wbuf_flush( _ctx->wbuf );
+			}
+		} break;
+		default: {
+			return -1;
+		}
+	}
 	return 0;
 }
 
-xlog_printer_t *xlog_printer_create_rotating_file( const char *file, size_t max_size_per_file, size_t max_file_to_ratating )
+xlog_printer_t *xlog_printer_create_rotating_file( const char *file, size_t max_size_per_file, size_t max_file_to_ratating, size_t coalesce_size, unsigned int latency_ms )
 {
 	xlog_printer_t *printer = NULL;
-	struct __rotating_file_printer_context *_prt_ctx = __rotating_file_create_context( file, max_size_per_file, max_file_to_ratating );
+	struct __rotating_file_printer_context *_prt_ctx = __rotating_file_create_context( file, max_size_per_file, max_file_to_ratating, coalesce_size, latency_ms );
 	if( _prt_ctx ) {
 		printer = ( xlog_printer_t * ) XLOG_MALLOC( sizeof( xlog_printer_t ) );
 		if( printer == NULL ) {
@@ -159,7 +385,9 @@ xlog_printer_t *xlog_printer_create_rotating_file( const char *file, size_t max_
 		printer->context = ( void * )_prt_ctx;
 		printer->options = XLOG_PRINTER_FILES_ROTATING;
 		printer->append = rotating_file_append;
-		printer->optctl = NULL;
+		printer->appendv = rotating_file_appendv;
+		printer->appendl = rotating_file_appendl;
+		printer->optctl = rotating_file_optctl;
 	}
 	
 	return printer;
@@ -0,0 +1,123 @@
+#include <xlog/xlog.h>
+#include <xlog/xlog_helper.h>
+
+#include <xlog/plugins/ringbuf.h>
+
+#include "internal.h"
+
+#ifdef __GNUC__
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wunknown-pragmas"
+#pragma GCC diagnostic ignored "-Wzero-length-array"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#pragma GCC diagnostic ignored "-Wcast-qual"
+#pragma GCC diagnostic ignored "-Wcast-align"
+#pragma GCC diagnostic ignored "-Wshorten-64-to-32"
+#endif
+
+/** records copied into ring-buffer mapped by creator(shared memory or file), read out by another process */
+struct __mapped_ringbuf_printer_context {
+	ringbuf_t *rbuff;
+	#if (defined XLOG_FEATURE_ENABLE_STATS) && (defined XLOG_FEATURE_ENABLE_STATS_PRINTER)
+	xlog_stats_t stats;
+	#endif
+};
+
+static int __mapped_ringbuf_appendl( xlog_printer_t *printer, const void *data, size_t length, int level UNUSED, const struct timespec *ts UNUSED )
+{
+	const char *text = ( const char * )data;
+	struct __mapped_ringbuf_printer_context *_ctx = ( struct __mapped_ringbuf_printer_context * )printer->context;
+	/* NOTE: no syscall, lock-free or evicting under mutex of ring-buffer by its options */
+	int error = ringbuf_copy_into( _ctx->rbuff, text, length );
+	XLOG_STATS_UPDATE( &_ctx->stats, REQUEST, INPUT, 1 );
+	XLOG_STATS_UPDATE( &_ctx->stats, BYTE, INPUT, length );
+	if( error == 0 ) {
+		XLOG_STATS_UPDATE( &_ctx->stats, REQUEST, OUTPUT, 1 );
+		XLOG_STATS_UPDATE( &_ctx->stats, BYTE, OUTPUT, length );
+	}
+	
+	return error ? 0 : length;
+}
+
+static int __mapped_ringbuf_append( xlog_printer_t *printer, void *data )
+{
+	const char *text = ( const char * )data;
+	return __mapped_ringbuf_appendl( printer, text, strlen( text ), XLOG_LEVEL_SILENT, NULL );
+}
+
+static int __mapped_ringbuf_optctl( xlog_printer_t *printer, int option, void *vptr, size_t size )
+{
+	struct __mapped_ringbuf_printer_context *_ctx = ( struct __mapped_ringbuf_printer_context * )printer->context;
+	switch( option ) {
+		case XLOG_PRINTER_CTRL_GABICLR: {
+			if( size == sizeof( int ) && vptr ) {
+				*((int *)vptr) = 0;
+			}
+		} break;
+		case XLOG_PRINTER_CTRL_GSTATS: {
+			#if (defined XLOG_FEATURE_ENABLE_STATS) && (defined XLOG_FEATURE_ENABLE_STATS_PRINTER)
+			if( vptr == NULL || size != sizeof( xlog_stats_t * ) ) {
+				return EINVAL;
+			}
+			/* NOTE: dropped by producers of all processes, or the oldest evicted */
+			uint64_t records = 0, bytes = 0;
+			ringbuf_dropped( _ctx->rbuff, &records, &bytes );
+			XLOG_STATS_CLEAR_FILED( &_ctx->stats, REQUEST, DROPPED, records );
+			XLOG_STATS_CLEAR_FILED( &_ctx->stats, BYTE, DROPPED, bytes );
+			*( xlog_stats_t ** )vptr = &_ctx->stats;
+			#else
+			return -1;
+			#endif
+		} break;
+		default: {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+xlog_printer_t *xlog_printer_create_mapped_ringbuf( ringbuf_t *rbuff, int type )
+{
+	struct __mapped_ringbuf_printer_context *_prt_ctx = ( struct __mapped_ringbuf_printer_context * )XLOG_MALLOC( sizeof( struct __mapped_ringbuf_printer_context ) );
+	if( _prt_ctx == NULL ) {
+		ringbuf_destory( rbuff );
+		return NULL;
+	}
+	memset( _prt_ctx, 0, sizeof( struct __mapped_ringbuf_printer_context ) );
+	_prt_ctx->rbuff = rbuff;
+	XLOG_STATS_INIT( &_prt_ctx->stats, XLOG_STATS_PRINTER_OPTION );
+	
+	xlog_printer_t *printer = ( xlog_printer_t * )XLOG_MALLOC( sizeof( xlog_printer_t ) );
+	if( printer == NULL ) {
+		XLOG_STATS_FINI( &_prt_ctx->stats );
+		ringbuf_destory( _prt_ctx->rbuff );
+		XLOG_FREE( _prt_ctx );
+		return NULL;
+	}
+	printer->options = type;
+	printer->context = ( void * )_prt_ctx;
+	printer->append = __mapped_ringbuf_append;
+	printer->appendv = NULL;
+	printer->appendl = __mapped_ringbuf_appendl;
+	printer->optctl = __mapped_ringbuf_optctl;
+	
+	return printer;
+}
+
+int xlog_printer_destory_mapped_ringbuf( xlog_printer_t *printer )
+{
+	#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
+	if( printer->magic != XLOG_MAGIC_PRINTER ) {
+		return EINVAL;
+	}
+	#endif
+	struct __mapped_ringbuf_printer_context *_ctx = ( struct __mapped_ringbuf_printer_context * )printer->context;
+	XLOG_STATS_FINI( &_ctx->stats );
+	ringbuf_destory( _ctx->rbuff );
+	XLOG_FREE( _ctx );
+	printer->context = NULL;
+	XLOG_FREE( printer );
+	
+	return 0;
+}
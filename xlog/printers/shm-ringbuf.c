@@ -0,0 +1,35 @@
+#include <xlog/xlog.h>
+#include <xlog/xlog_helper.h>
+
+#include <xlog/plugins/ringbuf.h>
+
+#include "internal.h"
+
+#ifdef __GNUC__
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wunknown-pragmas"
+#pragma GCC diagnostic ignored "-Wzero-length-array"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#pragma GCC diagnostic ignored "-Wcast-qual"
+#pragma GCC diagnostic ignored "-Wcast-align"
+#pragma GCC diagnostic ignored "-Wshorten-64-to-32"
+#endif
+
+#undef __XLOG_TRACE
+#define __XLOG_TRACE(...) // xlog_output_rawlog( xlog_printer_create( XLOG_PRINTER_STDERR ), NULL, "TRACE: ", "\r\n", __VA_ARGS__ )
+
+/* NOTE: no consumer in this process, ring-buffer drained by xlog-drain */
+xlog_printer_t *xlog_printer_create_shmring( const char *name, size_t capacity, int rb_options, unsigned int timeout_ms )
+{
+	ringbuf_t *rbuff = ringbuf_open_shared( name, capacity, rb_options );
+	if( rbuff == NULL ) {
+		__XLOG_TRACE( "Failed to open shared ring-buffer \"%s\", errno = %d.", name, errno );
+		return NULL;
+	}
+	if( RINGBUF_OVERFLOW( rbuff->options ) == RINGBUF_OTIMEOUT && timeout_ms ) {
+		ringbuf_set_timeout( rbuff, timeout_ms );
+	}
+	
+	return xlog_printer_create_mapped_ringbuf( rbuff, XLOG_PRINTER_TYPE_OPT( XLOG_PRINTER_SHMRING ) );
+}
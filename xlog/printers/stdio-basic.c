@@ -28,16 +28,38 @@ stderr_printer_context = {
     .lock = PTHREAD_MUTEX_INITIALIZER,
 };
 
+static int __stdxxx_appendl( xlog_printer_t *printer, const void *data, size_t length, int level UNUSED, const struct timespec *ts UNUSED )
+{
+    #ifndef XLOG_BENCH_NO_OUTPUT
+    return fwrite(
+        data, 1, length,
+        XLOG_PRINTER_TYPE_GET(printer->options) == XLOG_PRINTER_STDOUT ? stdout : stderr
+    );
+    #else
+    return length;
+    #endif
+}
+
 static int __stdxxx_append( xlog_printer_t *printer, void *data )
 {
     const char *text = ( const char * )data;
+    
+    return __stdxxx_appendl( printer, text, strlen( text ), XLOG_LEVEL_SILENT, NULL );
+}
+
+static int __stdxxx_appendv( xlog_printer_t *printer, const struct iovec *iov, int iovcnt )
+{
+    FILE *stream = XLOG_PRINTER_TYPE_GET(printer->options) == XLOG_PRINTER_STDOUT ? stdout : stderr;
     #ifndef XLOG_BENCH_NO_OUTPUT
-    return fprintf(
-        XLOG_PRINTER_TYPE_GET(printer->options) == XLOG_PRINTER_STDOUT ? stdout : stderr,
-        "%s", text
-    );
+    /* NOTE: flush text buffered by stdio first, or the order is broken */
+    fflush( stream );
+    return xlog_printer_writev( fileno( stream ), iov, iovcnt );
     #else
-    return strlen( text );
+    ssize_t size = 0;
+    for( int i = 0; i < iovcnt; i ++ ) {
+        size += iov[i].iov_len;
+    }
+    return size;
     #endif
 }
 
@@ -70,7 +92,10 @@ xlog_printer_t stdout_printer = {
     .context = ( void * ) &stdout_printer_context,
     .options = XLOG_PRINTER_STDOUT,
     .append = __stdxxx_append,
+    .appendv = __stdxxx_appendv,
+    .appendl = __stdxxx_appendl,
     .optctl = __stdxxx_optctl,
+    .abiclr = XLOG_PRINTER_ABICLR_KNOWN | XLOG_PRINTER_ABICLR_YES,
 },
 stderr_printer = {
     #if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
@@ -79,5 +104,8 @@ stderr_printer = {
     .context = ( void * ) &stderr_printer_context,
     .options = XLOG_PRINTER_STDERR,
     .append  = __stdxxx_append,
+    .appendv = __stdxxx_appendv,
+    .appendl = __stdxxx_appendl,
     .optctl = __stdxxx_optctl,
+    .abiclr = XLOG_PRINTER_ABICLR_KNOWN | XLOG_PRINTER_ABICLR_YES,
 };
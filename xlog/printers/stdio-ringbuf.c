@@ -39,6 +39,8 @@ static void *ringbuf_consumer_main( void *arg )
 	
 	bool idle_show = false;
 	while( true ) {
+		/* NOTE: check exit flag before reading, or records appended right before exiting are lost */
+		bool force_exit = __atomic_load_n( &context->force_exit, __ATOMIC_ACQUIRE );
 		int length = ringbuf_copy_from( context->rbuff , buffer, sizeof( buffer ) - 1, true );
 		if( length > 0 ) {
 			__XLOG_TRACE( "consumer-READ: length = %d\n", length );
@@ -48,7 +50,7 @@ static void *ringbuf_consumer_main( void *arg )
 			#endif
 			XLOG_STATS_UPDATE( &context->stats, BYTE, OUTPUT, length);
 			idle_show = true;
-		} else if( context->force_exit ) {
+		} else if( force_exit ) {
 			__XLOG_TRACE( "Force exit." )
 			return NULL;
 		} else {
@@ -56,6 +58,7 @@ static void *ringbuf_consumer_main( void *arg )
 				__XLOG_TRACE( "Consumer IDLE." );
 				idle_show = false;
 			}
+			ringbuf_wait( context->rbuff, 0 );
 		}
 	}
 	
@@ -63,11 +66,11 @@ static void *ringbuf_consumer_main( void *arg )
 	return NULL;
 }
 
-static struct __ringbuf_printer_context *__ringbuf_create_context( unsigned int capacity )
+static struct __ringbuf_printer_context *__ringbuf_create_context( unsigned int capacity, int rb_options )
 {
 	struct __ringbuf_printer_context *context = ( struct __ringbuf_printer_context * )XLOG_MALLOC( sizeof( struct __ringbuf_printer_context ) + capacity );
 	if( context ) {
-		context->rbuff = ringbuf_create( capacity );
+		context->rbuff = ringbuf_create_ex( capacity, rb_options );
 	}
 	
 	return context;
@@ -76,9 +79,8 @@ static struct __ringbuf_printer_context *__ringbuf_create_context( unsigned int
 static int __ringbuf_destory_context( struct __ringbuf_printer_context *context )
 {
 	if( context ) {
-		pthread_mutex_lock( &context->rbuff->mutex );
-		context->force_exit = true;
-		pthread_mutex_unlock( &context->rbuff->mutex );
+		__atomic_store_n( &context->force_exit, true, __ATOMIC_RELEASE );
+		ringbuf_wakeup( context->rbuff );
 		pthread_join( context->thread_consumer, NULL );
 		
 		ringbuf_destory( context->rbuff );
@@ -88,14 +90,19 @@ static int __ringbuf_destory_context( struct __ringbuf_printer_context *context
 	return 0;
 }
 
-static int __ringbuf_append( xlog_printer_t *printer, void *data )
+static int __ringbuf_appendl( xlog_printer_t *printer, const void *data, size_t length, int level UNUSED, const struct timespec *ts UNUSED )
 {
-	const char *text = ( const char * )data;
 	struct __ringbuf_printer_context *_ctx = ( struct __ringbuf_printer_context * )printer->context;
-	ringbuf_copy_into( _ctx->rbuff, text, strlen( text ) );
+	ringbuf_copy_into( _ctx->rbuff, data, length );
 	return 0;
 }
 
+static int __ringbuf_append( xlog_printer_t *printer, void *data )
+{
+	const char *text = ( const char * )data;
+	return __ringbuf_appendl( printer, text, strlen( text ), XLOG_LEVEL_SILENT, NULL );
+}
+
 static int __ringbuf_optctl( xlog_printer_t *printer UNUSED, int option, void *vptr, size_t size )
 {
 	switch( option ) {
@@ -111,10 +118,10 @@ static int __ringbuf_optctl( xlog_printer_t *printer UNUSED, int option, void *v
 	return 0;
 }
 
-xlog_printer_t *xlog_printer_create_ringbuf( size_t capacity )
+xlog_printer_t *xlog_printer_create_ringbuf( size_t capacity, int rb_options )
 {
 	xlog_printer_t *printer = NULL;
-	struct __ringbuf_printer_context *_prt_ctx = __ringbuf_create_context( capacity );
+	struct __ringbuf_printer_context *_prt_ctx = __ringbuf_create_context( capacity, rb_options );
 	if( _prt_ctx ) {
 		printer = ( xlog_printer_t * )XLOG_MALLOC( sizeof( xlog_printer_t ) );
 		if( printer == NULL ) {
@@ -125,6 +132,8 @@ xlog_printer_t *xlog_printer_create_ringbuf( size_t capacity )
 		printer->options = XLOG_PRINTER_TYPE_OPT( XLOG_PRINTER_RINGBUF );
 		printer->context = ( void * )_prt_ctx;
 		printer->append = __ringbuf_append;
+		printer->appendv = NULL;
+		printer->appendl = __ringbuf_appendl;
 		printer->optctl = __ringbuf_optctl;
 		
 		if( 0 == pthread_create( &_prt_ctx->thread_consumer, NULL, ringbuf_consumer_main, _prt_ctx ) ) {
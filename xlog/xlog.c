@@ -72,19 +72,30 @@ static const xlog_level_attr_t _level_attributes_none[] = {
 	XLOG_LEVEL_ATTR_NONE( VERBOSE ),
 };
 
-/** reverse version of strncpy */
-static char *__strnrcpy( char *dst, size_t size, const char *src )
-{
-	XLOG_ASSERT( dst );
-	XLOG_ASSERT( src );
-	
-	const char *cur = src + strlen( src ) - 1;
-	while( size-- && cur >= src ) {
-		*dst-- = *cur--;
-	}
-	
-	return dst;
-}
+/** generation of module tree, bumped once level or topology of module(s) changed */
+XLOG_PUBLIC( unsigned int ) __xlog_module_generation = 1;
+
+/** per-thread log-time cache, "MM/DD HH:MM:SS" re-rendered once per second */
+typedef struct {
+	time_t second;
+	int length;
+	char text[24];
+} xlog_time_cache_t;
+static XLOG_THREAD_LOCAL xlog_time_cache_t __time_cache = { .second = -1 };
+
+/** per-thread task descriptor cache, pre-rendered "[ppid/pid name] " */
+typedef struct {
+	int length;		/* 0 if invalid */
+	char text[XLOG_LIMIT_THREAD_NAME + 64];
+} xlog_task_cache_t;
+static XLOG_THREAD_LOCAL xlog_task_cache_t __task_cache = { .length = 0 };
+static pthread_once_t __task_cache_once = PTHREAD_ONCE_INIT;
+
+/** per-thread scratch autobuf, reused by records which never outlive the call */
+static XLOG_THREAD_LOCAL autobuf_t *__scratch_autobuf = NULL;
+static XLOG_THREAD_LOCAL bool __scratch_busy = false;
+static pthread_key_t __scratch_key;
+static pthread_once_t __scratch_once = PTHREAD_ONCE_INIT;
 
 /** copy a C-string into a sized buffer */
 static size_t __strlcpy( char *dest, const char *src, size_t size )
@@ -234,25 +245,48 @@ static const char *__xlog_level_short_name( int level )
 	}
 }
 
-/** check if format is enabled for specified level */
-static bool __xlog_format_been_enabled( const xlog_module_t *module, int level, int format )
+/** invalidate cached fields of all modules */
+static inline void __xlog_module_tree_changed( void )
+{
+	__atomic_add_fetch( &__xlog_module_generation, 1, __ATOMIC_RELEASE );
+}
+
+/** get parent of module, NULL if root module */
+static inline xlog_module_t *__xlog_module_parent( const xlog_module_t *module )
+{
+	family_tree_t *__node = family_tree_parent( ( const family_tree_t * )XLOG_MODULE_TO_NODE( module ) );
+	return __node ? ( xlog_module_t * )XLOG_MODULE_FROM_NODE( __node ) : NULL;
+}
+
+/** rebuild cached full path of module and it's sub-modules */
+static void __xlog_module_update_path( xlog_module_t *module )
 {
-	XLOG_ASSERT( XLOG_IF_NOT_SILENT_LEVEL( level ) );
+	const xlog_module_t *parent = __xlog_module_parent( module );
+	size_t plen = parent && parent->path ? parent->path_length : 0;
+	size_t nlen = module->name ? strlen( module->name ) : 0;
+	size_t len = module->name ? plen + 1 + nlen : plen;
 	
-	if( module ) {
-		xlog_t *context = xlog_module_context( module );
-		
-		if(
-			context
-			&& ( context->options & XLOG_CONTEXT_OALIVE )
-			&& ( context->attributes[level].format & format )
-		) {
-			return true;
+	char *path = ( char * )XLOG_MALLOC( len + 1 );
+	if( path ) {
+		if( plen ) {
+			memcpy( path, parent->path, plen );
 		}
-		
-		return false;
+		if( module->name ) {
+			path[plen] = '/';
+			memcpy( path + plen + 1, module->name, nlen );
+		}
+		path[len] = '\0';
+		XLOG_FREE( module->path );
+		module->path = path;
+		module->path_length = len;
 	} else {
-		return true;
+		XLOG_TRACE( "Failed to allocate memory for module path, keep the old one." );
+	}
+	
+	family_tree_t *child = ( ( family_tree_t * )XLOG_MODULE_TO_NODE( module ) )->child;
+	while( child ) {
+		__xlog_module_update_path( ( xlog_module_t * )XLOG_MODULE_FROM_NODE( child ) );
+		child = child->next;
 	}
 }
 
@@ -309,7 +343,9 @@ static inline xlog_module_t *__xlog_module_open( const char *name, int level, xl
 		XLOG_STATS_INIT( &module->stats, XLOG_STATS_MODULE_OPTION );
 		if( te_parent ) {
 			family_tree_set_parent( te_module, te_parent );
+			__xlog_module_tree_changed();
 		}
+		__xlog_module_update_path( module );
 	} else {
 		XLOG_TRACE( "Failed to create tree node: %s", strerror( errno ) );
 	}
@@ -330,6 +366,7 @@ static inline void __xlog_module_destory_hook( family_tree_t *node )
 		#endif
 		xlog_module_t *module = ( xlog_module_t * )XLOG_MODULE_FROM_NODE( node );
 		XLOG_FREE( module->name );
+		XLOG_FREE( module->path );
 		XLOG_STATS_FINI( &module->stats );
 		pthread_mutex_destroy( &module->lock );
 	} else {
@@ -524,18 +561,29 @@ XLOG_PUBLIC( int ) xlog_module_level_limit( const xlog_module_t *module )
 		return XLOG_LEVEL_SILENT;
 	}
 	#endif
-	int level = XLOG_LEVEL_VERBOSE;
-	const xlog_module_t *cur = module;
-	while( cur ) {
-		if( XLOG_IF_DROP_LEVEL( level, cur->level ) ) {
-			XLOG_TRACE( "Log in this level will be dropped." );
-			level = cur->level;
+	if( module == NULL ) {
+		return XLOG_LEVEL_VERBOSE;
+	}
+	
+	unsigned int generation = __atomic_load_n( &__xlog_module_generation, __ATOMIC_ACQUIRE );
+	if( __atomic_load_n( &module->generation, __ATOMIC_ACQUIRE ) != generation ) {
+		XLOG_TRACE( "Module tree changed, refresh cached level limit." );
+		int level = module->level;
+		const xlog_module_t *parent = __xlog_module_parent( module );
+		if( parent ) {
+			int limit = xlog_module_level_limit( parent );
+			if( XLOG_IF_DROP_LEVEL( level, limit ) ) {
+				level = limit;
+			}
 		}
-		family_tree_t *__node = family_tree_parent( ( const family_tree_t * )XLOG_MODULE_TO_NODE( cur ) );
-		cur = __node ? ( const xlog_module_t * )XLOG_MODULE_FROM_NODE( __node ) : NULL;
+		/* NOTE: refreshed by readers concurrently, limit published by the release of generation */
+		__atomic_store_n( &( ( xlog_module_t * )module )->level_limit, level, __ATOMIC_RELAXED );
+		__atomic_store_n( &( ( xlog_module_t * )module )->generation, generation, __ATOMIC_RELEASE );
+		
+		return level;
 	}
 	
-	return level;
+	return __atomic_load_n( &module->level_limit, __ATOMIC_RELAXED );
 }
 
 /**
@@ -558,21 +606,15 @@ XLOG_PUBLIC( const char * ) xlog_module_name( char *buffer, int length, const xl
 		XLOG_TRACE( "invalid parameters." );
 		return module ? module->name : NULL;
 	} else {
-		char *ptr = buffer + length - 1;
-		*ptr -- = '\0';
-		
-		const xlog_module_t *cur = module;
-		while( cur ) {
-			if( cur->name ) {
-				ptr = __strnrcpy( ptr, ptr - buffer, cur->name );
-				ptr = __strnrcpy( ptr, ptr - buffer, "/" );
-			} else {
-				XLOG_TRACE( "Name of current module is NULL, pay attention to it." );
-			}
-			family_tree_t *__node = family_tree_parent( ( const family_tree_t * )XLOG_MODULE_TO_NODE( cur ) );
-			cur = __node ? ( const xlog_module_t * )XLOG_MODULE_FROM_NODE( __node ) : NULL;
+		const char *path = module && module->path ? module->path : "";
+		int len = module && module->path ? module->path_length : 0;
+		if( len > length - 1 ) {
+			XLOG_TRACE( "Buffer too small, keep tail of module path." );
+			path += len - ( length - 1 );
+			len = length - 1;
 		}
-		memcpy( buffer, ptr + 1, ptr - buffer );
+		memcpy( buffer, path, len );
+		buffer[len] = '\0';
 		
 		return buffer;
 	}
@@ -676,6 +718,7 @@ static int __xlog_module_set_level_recursive( xlog_module_t *module, int level )
 		__module = ( xlog_module_t * )XLOG_MODULE_FROM_NODE( __node );
 		if( __module->level != level ) {
 			__module->level = level;
+			__xlog_module_tree_changed();
 			if( context && ( context->options & XLOG_CONTEXT_OAUTO_DUMP ) ) {
 				xlog_module_dump_to( __module, NULL );
 			}
@@ -726,6 +769,7 @@ XLOG_PUBLIC( int ) xlog_module_set_level( xlog_module_t *module, int level, int
 	if( module ) {
 		if( module->level != level ) {
 			module->level = level;
+			__xlog_module_tree_changed();
 			if( context && ( context->options & XLOG_CONTEXT_OAUTO_DUMP ) ) {
 				XLOG_TRACE( "Auto dump enabled, dump to file now." );
 				xlog_module_dump_to( module, NULL );
@@ -748,6 +792,7 @@ XLOG_PUBLIC( int ) xlog_module_set_level( xlog_module_t *module, int level, int
 			__module = ( xlog_module_t * )XLOG_MODULE_FROM_NODE( __node );
 			if( XLOG_IF_LOWER_LEVEL( __module->level, level ) ) {
 				__module->level = level;
+				__xlog_module_tree_changed();
 				if( context && ( context->options & XLOG_CONTEXT_OAUTO_DUMP ) ) {
 					xlog_module_dump_to( __module, NULL );
 				}
@@ -897,6 +942,7 @@ XLOG_PUBLIC( int ) xlog_module_load_from( xlog_module_t *module, const char *loa
 			if( XLOG_IF_LEGAL_LEVEL( config.level ) ) {
 				XLOG_TRACE( "level = %d, config.level = %d", module->level, config.level );
 				module->level = config.level;
+				__xlog_module_tree_changed();
 			}
 			#if (defined XLOG_FEATURE_ENABLE_STATS) && (defined XLOG_FEATURE_ENABLE_STATS_MODULE)
 			memcpy( module->stats.data, config.stats.data, sizeof( unsigned int ) * XLOG_STATS_LENGTH( module->stats.option ) );
@@ -1012,180 +1058,1292 @@ static int __xlog_load_modules( xlog_t *context )
 
 
 /**
- * @brief  create xlog context
+ * @brief  invalidate cached task descriptor("[ppid/pid name] ") of current thread
  *
- * @param  savepath, path to save configurations
- *         option, open option
- * @return pointer to `xlog_t`, NULL if failed to create context.
+ * @note   called by XLOG_SET_THREAD_NAME and in child process after fork(),
+ *         call it if thread renamed in other ways.
  *
  */
-XLOG_PUBLIC( xlog_t * ) xlog_open( const char *savepath, int option )
+XLOG_PUBLIC( void ) xlog_task_invalidate( void )
 {
-	xlog_t *context = NULL;
-	context = ( xlog_t * )XLOG_MALLOC( sizeof( xlog_t ) );
-	if( context ) {
-		memset( context, 0, sizeof( xlog_t ) );
+	__task_cache.length = 0;
+}
+
+/** register fork handler, pid/ppid cached by the forking thread are stale in child */
+static void __xlog_task_cache_init_once( void )
+{
+	pthread_atfork( NULL, NULL, xlog_task_invalidate );
+}
+
+/** get task descriptor of current thread, rendered once until invalidated */
+static const char *__xlog_task_descriptor( int *length )
+{
+	if( __task_cache.length == 0 ) {
+		XLOG_TRACE( "Task descriptor invalidated, render it." );
+		pthread_once( &__task_cache_once, __xlog_task_cache_init_once );
 		
-		/** NOTE: initialize lock */
-		if( pthread_mutex_init( &context->lock, NULL ) != 0 ) {
-			XLOG_FREE( context );
-			context = NULL;
-		} else {
-			context->module = __xlog_module_open( NULL, XLOG_LEVEL_VERBOSE, NULL );
-			if( NULL == context->module ) {
-				pthread_mutex_destroy( &context->lock );
-				XLOG_FREE( context );
-				context = NULL;
-				
-				return context;
-			}
-			context->module->context = context;
-			context->options = XLOG_CONTEXT_OALIVE | XLOG_CONTEXT_OCOLOR;
-			if( savepath ) {
-				XLOG_TRACE( "Auto dump enabled 'cause savepath is NOT NULL." );
-				context->options |= XLOG_CONTEXT_OAUTO_DUMP;
-			}
-			memcpy( context->attributes, &_level_attributes_default, sizeof( context->attributes ) );
-			
-			/** NOTE: create files to save configurations */
-			if( savepath ) {
-				char *_dir = XLOG_STRDUP( savepath ), *_ptr = _dir;
-				if( _dir ) {
-					_ptr = _dir + strlen( _dir ) - 1;
-					while( _ptr > _dir && ( '\\' == *_ptr || '/' == *_ptr ) ) {
-						XLOG_TRACE( "Strip ending \"/\" and \"\\\"." );
-						*_ptr -- = '\0';
-					}
-					context->savepath = _dir;
-					__mkdir_p( context->savepath, 0777 );
-					
-					if( option & XLOG_OPEN_LOAD ) {
-						XLOG_TRACE( "Loading configuration from files." );
-						__xlog_load_modules( context );
-					}
-				}
-			} else {
-				XLOG_TRACE( "Set savepath to NULL." );
-				context->savepath = NULL;
-			}
-			
-			/** NOTE: voting to initial-size of autobuf */
-			context->initial_size = XLOG_DEFAULT_PAYLOAD_SIZE;
-			#if (defined XLOG_FEATURE_ENABLE_DYNAMIC_DEFAULT_AUTOBUF_SIZE)
-			context->size_votes = XLOG_MALLOC( sizeof( size_t ) * XLOG_ARRAY_SIZE( vote_thresholds ) );
-			if( context->size_votes == NULL ) {
-				XLOG_TRACE( "Failed to allocate memory for voting." );
-			}
-			#endif
-			
-			/** NOTE: initialize stats */
-			XLOG_STATS_INIT( &context->stats, XLOG_STATS_CONTEXT_OPTION );
-			
-			#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
-			context->magic = XLOG_MAGIC_CONTEXT;
-			#endif
+		char taskname[XLOG_LIMIT_THREAD_NAME] = { 0 };
+		XLOG_GET_THREAD_NAME( taskname );
+		if( taskname[0] == '\0' ) {
+			snprintf( taskname, sizeof( taskname ), "%s", XLOG_THREAD_UNNAMED );
+		}
+		int len = snprintf(
+			__task_cache.text, sizeof( __task_cache.text ), XLOG_PREFIX_LOG_TASK "%d/%d %s" XLOG_SUFFIX_LOG_TASK,
+			getppid(), getpid(), taskname
+		);
+		if( len >= ( int )sizeof( __task_cache.text ) ) {
+			len = sizeof( __task_cache.text ) - 1;
 		}
+		__task_cache.length = len > 0 ? len : 0;
 	}
+	*length = __task_cache.length;
 	
-	return context;
+	return __task_cache.text;
+}
+
+/** release scratch autobuf on thread exit */
+static void __xlog_scratch_destory( void *arg )
+{
+	autobuf_t *autobuf = ( autobuf_t * )arg;
+	autobuf_destory( &autobuf );
+}
+
+static void __xlog_scratch_init_once( void )
+{
+	pthread_key_create( &__scratch_key, __xlog_scratch_destory );
+}
+
+/** get scratch autobuf of current thread, NULL if it's in use or failed to create */
+static autobuf_t *__xlog_scratch_acquire( size_t initial_size )
+{
+	if( __scratch_busy ) {
+		XLOG_TRACE( "Scratch autobuf is in use, reentered." );
+		return NULL;
+	}
+	if( __scratch_autobuf == NULL ) {
+		pthread_once( &__scratch_once, __xlog_scratch_init_once );
+		__scratch_autobuf = autobuf_create(
+			XLOG_PAYLOAD_ID_AUTO, "Scratch",
+			AUTOBUF_ODYNAMIC | AUTOBUF_OALIGN | AUTOBUF_OTEXT, initial_size, 64
+		);
+		if( __scratch_autobuf == NULL ) {
+			XLOG_TRACE( "Failed to create scratch autobuf." );
+			return NULL;
+		}
+		pthread_setspecific( __scratch_key, __scratch_autobuf );
+	}
+	__scratch_busy = true;
+	__scratch_autobuf->offset = 0;
+	*( char * )autobuf_data_vptr( __scratch_autobuf ) = '\0';
+	
+	return __scratch_autobuf;
+}
+
+/** give back scratch autobuf, it may be moved by resizing */
+static void __xlog_scratch_release( autobuf_t *autobuf )
+{
+	if( autobuf && autobuf->length > XLOG_LIMIT_SCRATCH_SIZE ) {
+		XLOG_TRACE( "Scratch autobuf grows too large, release it." );
+		autobuf_destory( &autobuf );
+	}
+	if( autobuf != __scratch_autobuf ) {
+		__scratch_autobuf = autobuf;
+		pthread_setspecific( __scratch_key, autobuf );
+	}
+	__scratch_busy = false;
+}
+
+/** registry of call-sites, indexed by (id - 1) */
+static xlog_callsite_t **__callsites[XLOG_LIMIT_CALLSITE_CHUNKS];
+static unsigned int __callsites_count = 0;
+static pthread_mutex_t __callsites_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** rules of call-site control, the newest first */
+typedef struct xlog_callsite_rule {
+	struct xlog_callsite_rule *next;
+	xlog_callsite_match_t match;
+	int control;
+	char strings[0];	/* file, func and format */
+} xlog_callsite_rule_t;
+static xlog_callsite_rule_t *__callsite_rules = NULL;
+
+/** check if call-site matched, file is matched by path suffix */
+static bool __xlog_callsite_match( const xlog_callsite_t *callsite, const xlog_callsite_match_t *match )
+{
+	if( match == NULL ) {
+		return true;
+	}
+	if( match->file && *( match->file ) != '\0' ) {
+		if( callsite->file == NULL ) {
+			return false;
+		}
+		size_t length = strlen( match->file );
+		size_t file_length = strlen( callsite->file );
+		if( file_length < length || strcmp( callsite->file + file_length - length, match->file ) ) {
+			return false;
+		}
+		if( file_length > length && callsite->file[file_length - length - 1] != '/' ) {
+			return false;
+		}
+	}
+	if( match->line > 0 && match->line != callsite->line ) {
+		return false;
+	}
+	if( match->func && *( match->func ) != '\0' ) {
+		if( callsite->func == NULL || strcmp( callsite->func, match->func ) ) {
+			return false;
+		}
+	}
+	if( match->format && *( match->format ) != '\0' ) {
+		if( callsite->format == NULL || strstr( callsite->format, match->format ) == NULL ) {
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+/** control of call-site by rules, lock should be held */
+static int __xlog_callsite_control_by_rules( const xlog_callsite_t *callsite )
+{
+	for( const xlog_callsite_rule_t *rule = __callsite_rules; rule; rule = rule->next ) {
+		if( __xlog_callsite_match( callsite, &rule->match ) ) {
+			return rule->control;
+		}
+	}
+	
+	return XLOG_CALLSITE_CTRL_DEFAULT;
 }
 
 /**
- * @brief  destory xlog context
+ * @brief  register call-site, fill cached fields and assign a stable id to it
  *
- * @param  context, pointer to `xlog_t`
- *         option, close option
- * @return error code.
+ * @param  callsite, static descriptor of call-site
+ *         module/format, module and format seen at the first time
+ * @return id of call-site, XLOG_CALLSITE_ID_OVERFLOW if registry is full.
  *
  */
-XLOG_PUBLIC( int ) xlog_close( xlog_t *context, int option )
+XLOG_PUBLIC( unsigned int ) xlog_callsite_register( xlog_callsite_t *callsite, xlog_module_t *module, const char *format )
 {
-	#if (defined XLOG_FEATURE_ENABLE_DEFAULT_CONTEXT)
-	if( context == NULL ) {
-		XLOG_TRACE( "Redirect to default context." );
-		context = __default_context;
+	XLOG_ASSERT( callsite );
+	pthread_mutex_lock( &__callsites_lock );
+	unsigned int id = callsite->id;
+	if( id != XLOG_CALLSITE_ID_NONE ) {
+		XLOG_TRACE( "Registered by others." );
+		pthread_mutex_unlock( &__callsites_lock );
+		return id;
 	}
-	#endif
-	if( context ) {
-		#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
-		if( context->magic != XLOG_MAGIC_CONTEXT ) {
-			XLOG_TRACE( "Runtime error: may be context has been closed." );
-			return EINVAL;
-		}
-		context->magic = XLOG_MAGIC_CONTEXT;
-		#endif
-		pthread_mutex_lock( &context->lock );
-		xlog_module_close( context->module );
-		if( context->savepath ) {
-			if( option & XLOG_CLOSE_CLEAR ) {
-				XLOG_TRACE( "CLEAR ON CLOSE is enabled, and savepath is NOT NULL, remove directories." );
-				__rmdir_r( context->savepath );
-			}
-			XLOG_FREE( context->savepath );
+	
+	callsite->format = format;
+	callsite->module = module;
+	callsite->file_length = callsite->file ? strlen( callsite->file ) : 0;
+	callsite->func_length = callsite->func ? strlen( callsite->func ) : 0;
+	callsite->line_length = snprintf( callsite->line_text, sizeof( callsite->line_text ), "%ld", callsite->line );
+	
+	id = XLOG_CALLSITE_ID_OVERFLOW;
+	unsigned int index = __callsites_count;
+	unsigned int chunk = index / XLOG_LIMIT_CALLSITE_CHUNK;
+	if( chunk < XLOG_LIMIT_CALLSITE_CHUNKS ) {
+		if( __callsites[chunk] == NULL ) {
+			xlog_callsite_t **slots = ( xlog_callsite_t ** )XLOG_MALLOC( sizeof( xlog_callsite_t * ) * XLOG_LIMIT_CALLSITE_CHUNK );
+			__atomic_store_n( &__callsites[chunk], slots, __ATOMIC_RELEASE );
 		}
-		#if (defined XLOG_FEATURE_ENABLE_DYNAMIC_DEFAULT_AUTOBUF_SIZE)
-		XLOG_FREE( context->size_votes );
-		#endif
-		XLOG_STATS_FINI( &context->stats );
-		pthread_mutex_unlock( &context->lock );
-		pthread_mutex_destroy( &context->lock );
-		#if (defined XLOG_FEATURE_ENABLE_DEFAULT_CONTEXT)
-		if( context == __default_context ) {
-			XLOG_TRACE( "Destory default context." );
-			__default_context = NULL;
+		if( __callsites[chunk] ) {
+			__atomic_store_n( &__callsites[chunk][index % XLOG_LIMIT_CALLSITE_CHUNK], callsite, __ATOMIC_RELEASE );
+			__callsites_count ++;
+			id = index + 1;
+		} else {
+			XLOG_TRACE( "Failed to allocate memory for registry." );
 		}
-		#endif
-		XLOG_FREE( context );
+	} else {
+		XLOG_TRACE( "Too many call-sites." );
 	}
+	__atomic_store_n( &callsite->id, id, __ATOMIC_RELEASE );
+	__atomic_store_n( &callsite->control, __xlog_callsite_control_by_rules( callsite ), __ATOMIC_RELEASE );
+	pthread_mutex_unlock( &__callsites_lock );
 	
-	return 0;
+	return id;
 }
 
 /**
- * @brief  list all modules under xlog context
+ * @brief  lookup call-site by id
  *
- * @param  context, pointer to `xlog_t`
- *         options, print options
+ * @param  id, id of call-site
+ * @return pointer to call-site, NULL if NOT registered.
  *
  */
-XLOG_PUBLIC( void ) xlog_list_modules( const xlog_t *context, int options )
+XLOG_PUBLIC( const xlog_callsite_t * ) xlog_callsite_lookup( unsigned int id )
 {
-	#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
-	if( context && context->magic != XLOG_MAGIC_CONTEXT ) {
-		XLOG_TRACE( "Runtime error: may be context has been closed." );
-		return;
+	if( id == XLOG_CALLSITE_ID_NONE || id == XLOG_CALLSITE_ID_OVERFLOW ) {
+		return NULL;
 	}
-	#endif
-	#if (defined XLOG_FEATURE_ENABLE_DEFAULT_CONTEXT)
-	if( context == NULL ) {
-		if( __default_context == NULL ) {
-			XLOG_TRACE( "Create default context." );
-			__default_context = xlog_open( NULL, 0 );
-			if( __default_context == NULL ) {
-				XLOG_TRACE( "Failed to create default context." );
-				return;
-			}
+	unsigned int index = id - 1;
+	unsigned int chunk = index / XLOG_LIMIT_CALLSITE_CHUNK;
+	if( chunk >= XLOG_LIMIT_CALLSITE_CHUNKS ) {
+		return NULL;
+	}
+	xlog_callsite_t **slots = __atomic_load_n( &__callsites[chunk], __ATOMIC_ACQUIRE );
+	
+	return slots ? __atomic_load_n( &slots[index % XLOG_LIMIT_CALLSITE_CHUNK], __ATOMIC_ACQUIRE ) : NULL;
+}
+
+/**
+ * @brief  switch call-sites matched on/off, applied to call-sites registered later too
+ *
+ * @param  match, selector of call-sites, NULL to match all
+ *         control, XLOG_CALLSITE_CTRL_ON/OFF, XLOG_CALLSITE_CTRL_DEFAULT to follow level of module
+ * @return error code.
+ *
+ */
+XLOG_PUBLIC( int ) xlog_callsite_control( const xlog_callsite_match_t *match, int control )
+{
+	if( control != XLOG_CALLSITE_CTRL_DEFAULT && control != XLOG_CALLSITE_CTRL_OFF && control != XLOG_CALLSITE_CTRL_ON ) {
+		return EINVAL;
+	}
+	const char *file = match && match->file ? match->file : "";
+	const char *func = match && match->func ? match->func : "";
+	const char *format = match && match->format ? match->format : "";
+	long int line = match ? match->line : 0;
+	bool any = !*file && !*func && !*format && line <= 0;
+	
+	xlog_callsite_rule_t *rule = NULL;
+	if( !( any && control == XLOG_CALLSITE_CTRL_DEFAULT ) ) {
+		size_t file_size = strlen( file ) + 1, func_size = strlen( func ) + 1, format_size = strlen( format ) + 1;
+		rule = ( xlog_callsite_rule_t * )XLOG_MALLOC( sizeof( xlog_callsite_rule_t ) + file_size + func_size + format_size );
+		if( rule == NULL ) {
+			XLOG_TRACE( "Failed to allocate memory for rule." );
+			return ENOMEM;
 		}
-		XLOG_TRACE( "Redirected to default context." );
-		context = __default_context;
+		char *ptr = rule->strings;
+		rule->match.file = memcpy( ptr, file, file_size );
+		ptr += file_size;
+		rule->match.func = memcpy( ptr, func, func_size );
+		ptr += func_size;
+		rule->match.format = memcpy( ptr, format, format_size );
+		rule->match.line = line;
+		rule->control = control;
 	}
-	#else
-	XLOG_ASSERT( context && context->module );
-	#endif
 	
-	xlog_module_list_submodules( context->module, options );
+	pthread_mutex_lock( &__callsites_lock );
+	if( rule ) {
+		rule->next = __callsite_rules;
+		__callsite_rules = rule;
+	} else {
+		XLOG_TRACE( "Reset all rules." );
+		while( __callsite_rules ) {
+			xlog_callsite_rule_t *next = __callsite_rules->next;
+			XLOG_FREE( __callsite_rules );
+			__callsite_rules = next;
+		}
+	}
+	for( unsigned int index = 0; index < __callsites_count; index ++ ) {
+		xlog_callsite_t *callsite = __callsites[index / XLOG_LIMIT_CALLSITE_CHUNK][index % XLOG_LIMIT_CALLSITE_CHUNK];
+		if( rule == NULL || __xlog_callsite_match( callsite, &rule->match ) ) {
+			__atomic_store_n( &callsite->control, control, __ATOMIC_RELEASE );
+		}
+	}
+	pthread_mutex_unlock( &__callsites_lock );
+	
+	return 0;
 }
 
 /**
- * @brief  get xlog version
+ * @brief  list registered call-sites matched
  *
- * @param  buffer/size, buffer to save version description
- * @return version code[MSB...8 major, 7...4 minor, 3...0 revision]
+ * @param  match, selector of call-sites, NULL to list all
  *
  */
-XLOG_PUBLIC( int ) xlog_version( char *buffer, int size )
+XLOG_PUBLIC( void ) xlog_callsite_list( const xlog_callsite_match_t *match )
 {
-	#if (defined XLOG_VERSION_WITH_BUILDDATE)
+	static const char *controls[] = {
+		[XLOG_CALLSITE_CTRL_NONE] = "default",
+		[XLOG_CALLSITE_CTRL_DEFAULT] = "default",
+		[XLOG_CALLSITE_CTRL_OFF] = "off",
+		[XLOG_CALLSITE_CTRL_ON] = "on",
+	};
+	
+	pthread_mutex_lock( &__callsites_lock );
+	for( unsigned int index = 0; index < __callsites_count; index ++ ) {
+		const xlog_callsite_t *callsite = __callsites[index / XLOG_LIMIT_CALLSITE_CHUNK][index % XLOG_LIMIT_CALLSITE_CHUNK];
+		if( __xlog_callsite_match( callsite, match ) ) {
+			const char *format = callsite->format ? callsite->format : "";
+			log_r(
+				"%s:%ld [%s] %s \"%.*s\"\n",
+				callsite->file ? callsite->file : "", callsite->line,
+				callsite->func ? callsite->func : "",
+				controls[__atomic_load_n( &callsite->control, __ATOMIC_ACQUIRE ) & 0x03],
+				( int )strcspn( format, "\r\n" ), format
+			);
+		}
+	}
+	pthread_mutex_unlock( &__callsites_lock );
+}
+
+/** argument types of deferred formatting */
+#define XLOG_ARG_NONE		0
+#define XLOG_ARG_INT		1
+#define XLOG_ARG_LONG		2
+#define XLOG_ARG_LLONG		3
+#define XLOG_ARG_INTMAX		4
+#define XLOG_ARG_SIZE		5
+#define XLOG_ARG_PTRDIFF	6
+#define XLOG_ARG_DOUBLE		7
+#define XLOG_ARG_LDOUBLE	8
+#define XLOG_ARG_PTR		9
+#define XLOG_ARG_STR		10
+
+/** piece of parsed format, constant text followed by an optional conversion */
+typedef struct {
+	unsigned int offset, length;			/* constant text in format */
+	unsigned char type;						/* XLOG_ARG_xxx of conversion */
+	unsigned char stars;					/* number of '*' in width/precision */
+	int precision;							/* -1 if not given, -2 if given by argument('*') */
+	char spec[XLOG_LIMIT_DEFERRED_SPEC];	/* conversion specification, "%-8.3f" */
+} xlog_deferred_piece_t;
+
+/** format parsed once for deferred formatting */
+typedef struct {
+	const char *format;						/* copy of format, outlives buffer of caller */
+	bool supported;
+	int count;
+	xlog_deferred_piece_t pieces[XLOG_LIMIT_DEFERRED_PIECES];
+} xlog_deferred_format_t;
+
+/** parsed formats, indexed by content of format */
+static struct {
+	const char *format;
+	xlog_deferred_format_t *parsed;
+} __deferred_formats[XLOG_LIMIT_DEFERRED_FORMATS];
+static pthread_mutex_t __deferred_formats_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** get argument type of conversion, XLOG_ARG_NONE if NOT supported */
+static int __xlog_deferred_arg_type( const char *modifier, size_t length, char conversion )
+{
+	if( conversion == '\0' ) {
+		return XLOG_ARG_NONE;
+	}
+	#define __MODIFIER_IS(m)	( length == sizeof( m ) - 1 && strncmp( modifier, m, length ) == 0 )
+	if( strchr( "diouxX", conversion ) || ( conversion == 'c' && length == 0 ) ) {
+		if( length == 0 || __MODIFIER_IS( "hh" ) || __MODIFIER_IS( "h" ) ) {
+			return XLOG_ARG_INT;
+		} else if( __MODIFIER_IS( "l" ) ) {
+			return XLOG_ARG_LONG;
+		} else if( __MODIFIER_IS( "ll" ) ) {
+			return XLOG_ARG_LLONG;
+		} else if( __MODIFIER_IS( "j" ) ) {
+			return XLOG_ARG_INTMAX;
+		} else if( __MODIFIER_IS( "z" ) ) {
+			return XLOG_ARG_SIZE;
+		} else if( __MODIFIER_IS( "t" ) ) {
+			return XLOG_ARG_PTRDIFF;
+		}
+	} else if( strchr( "fFeEgGaA", conversion ) ) {
+		if( length == 0 || __MODIFIER_IS( "l" ) ) {
+			return XLOG_ARG_DOUBLE;
+		} else if( __MODIFIER_IS( "L" ) ) {
+			return XLOG_ARG_LDOUBLE;
+		}
+	} else if( conversion == 's' && length == 0 ) {
+		return XLOG_ARG_STR;
+	} else if( conversion == 'p' && length == 0 ) {
+		return XLOG_ARG_PTR;
+	}
+	#undef __MODIFIER_IS
+	
+	return XLOG_ARG_NONE;
+}
+
+/** parse format into pieces, unsupported if any conversion can't be deferred(%n, %m, %ls, %1$d, ...) */
+static void __xlog_deferred_parse( xlog_deferred_format_t *parsed, const char *format )
+{
+	const char *cur = format, *text = format;
+	xlog_deferred_piece_t *piece = NULL;
+	
+	parsed->format = format;
+	parsed->supported = false;
+	parsed->count = 0;
+	while( *cur ) {
+		if( *cur != '%' ) {
+			cur ++;
+			continue;
+		}
+		if( parsed->count >= XLOG_LIMIT_DEFERRED_PIECES ) {
+			XLOG_TRACE( "Too many pieces in format." );
+			return;
+		}
+		piece = &parsed->pieces[parsed->count ++];
+		piece->offset = text - format;
+		piece->type = XLOG_ARG_NONE;
+		piece->stars = 0;
+		piece->precision = -1;
+		piece->spec[0] = '\0';
+		if( cur[1] == '%' ) {
+			piece->length = cur + 1 - text;
+			cur += 2;
+			text = cur;
+			continue;
+		}
+		piece->length = cur - text;
+		
+		const char *spec = cur ++;
+		while( *cur && strchr( "-+ #0", *cur ) ) {
+			cur ++;
+		}
+		if( *cur == '*' ) {
+			piece->stars ++;
+			cur ++;
+		} else {
+			while( isdigit( ( unsigned char )*cur ) ) {
+				cur ++;
+			}
+		}
+		if( *cur == '.' ) {
+			cur ++;
+			if( *cur == '*' ) {
+				piece->stars ++;
+				piece->precision = -2;
+				cur ++;
+			} else {
+				piece->precision = 0;
+				while( isdigit( ( unsigned char )*cur ) ) {
+					piece->precision = piece->precision * 10 + ( *cur - '0' );
+					cur ++;
+				}
+			}
+		}
+		const char *modifier = cur;
+		while( *cur && strchr( "hljztL", *cur ) ) {
+			cur ++;
+		}
+		piece->type = __xlog_deferred_arg_type( modifier, cur - modifier, *cur );
+		if( piece->type == XLOG_ARG_NONE ) {
+			XLOG_TRACE( "Conversion NOT supported: %s", spec );
+			return;
+		}
+		cur ++;
+		if( ( size_t )( cur - spec ) >= sizeof( piece->spec ) ) {
+			XLOG_TRACE( "Conversion specification too long: %s", spec );
+			return;
+		}
+		memcpy( piece->spec, spec, cur - spec );
+		piece->spec[cur - spec] = '\0';
+		text = cur;
+	}
+	
+	if( parsed->count >= XLOG_LIMIT_DEFERRED_PIECES ) {
+		XLOG_TRACE( "Too many pieces in format." );
+		return;
+	}
+	piece = &parsed->pieces[parsed->count ++];
+	piece->offset = text - format;
+	piece->length = cur - text;
+	piece->type = XLOG_ARG_NONE;
+	piece->stars = 0;
+	parsed->supported = true;
+}
+
+/** get parsed format, parse it at the first time, NULL if no room for it in slots probed */
+static const xlog_deferred_format_t *__xlog_deferred_lookup( const char *format )
+{
+	/* NOTE: buffer of format may be reused for another one, keyed by content but NOT address */
+	size_t hash = 2166136261u;
+	const char *cur = format;
+	while( *cur ) {
+		hash = ( hash ^ ( unsigned char )*cur ++ ) * 16777619u;
+	}
+	size_t length = cur - format;
+	/* NOTE: probes bounded, formats built at runtime never cost producers more than a few comparisons */
+	for( size_t i = 0; i < XLOG_LIMIT_DEFERRED_PROBES; i ++ ) {
+		size_t slot = ( hash + i ) & ( XLOG_LIMIT_DEFERRED_FORMATS - 1 );
+		const char *key = __atomic_load_n( &__deferred_formats[slot].format, __ATOMIC_ACQUIRE );
+		if( key == NULL ) {
+			pthread_mutex_lock( &__deferred_formats_lock );
+			key = __deferred_formats[slot].format;
+			if( key == NULL ) {
+				xlog_deferred_format_t *parsed = ( xlog_deferred_format_t * )XLOG_MALLOC( sizeof( xlog_deferred_format_t ) + length + 1 );
+				if( parsed ) {
+					char *copy = ( char * )( parsed + 1 );
+					memcpy( copy, format, length + 1 );
+					__xlog_deferred_parse( parsed, copy );
+					__deferred_formats[slot].parsed = parsed;
+					__atomic_store_n( &__deferred_formats[slot].format, copy, __ATOMIC_RELEASE );
+					key = copy;
+				}
+			}
+			pthread_mutex_unlock( &__deferred_formats_lock );
+			if( key == NULL ) {
+				XLOG_TRACE( "Failed to allocate memory for parsed format." );
+				return NULL;
+			}
+		}
+		if( strcmp( key, format ) == 0 ) {
+			return __deferred_formats[slot].parsed;
+		}
+	}
+	XLOG_TRACE( "No room for parsed format." );
+	
+	return NULL;
+}
+
+/** format log body from raw arguments of deferred record */
+static void __xlog_deferred_render_body( autobuf_t **autobuf, const xlog_deferred_record_t *record )
+{
+	const xlog_deferred_format_t *parsed = ( const xlog_deferred_format_t * )record->format;
+	const char *args = ( const char * )( record + 1 ) + record->task_length;
+	
+	#define __DEFERRED_GET(type, value)	type value; memcpy( &value, args, sizeof( type ) ); args += sizeof( type )
+	#define __DEFERRED_APPEND(value)	do { \
+		if( piece->stars == 0 ) { autobuf_append_text_va( autobuf, piece->spec, value ); } \
+		else if( piece->stars == 1 ) { autobuf_append_text_va( autobuf, piece->spec, stars[0], value ); } \
+		else { autobuf_append_text_va( autobuf, piece->spec, stars[0], stars[1], value ); } \
+	} while( 0 )
+	for( int i = 0; i < parsed->count; i ++ ) {
+		const xlog_deferred_piece_t *piece = &parsed->pieces[i];
+		if( piece->length ) {
+			autobuf_append_text_n( autobuf, parsed->format + piece->offset, piece->length );
+		}
+		int stars[2] = { 0, 0 };
+		for( int j = 0; j < piece->stars; j ++ ) {
+			memcpy( &stars[j], args, sizeof( int ) );
+			args += sizeof( int );
+		}
+		switch( piece->type ) {
+			case XLOG_ARG_INT: { __DEFERRED_GET( int, value ); __DEFERRED_APPEND( value ); } break;
+			case XLOG_ARG_LONG: { __DEFERRED_GET( long, value ); __DEFERRED_APPEND( value ); } break;
+			case XLOG_ARG_LLONG: { __DEFERRED_GET( long long, value ); __DEFERRED_APPEND( value ); } break;
+			case XLOG_ARG_INTMAX: { __DEFERRED_GET( intmax_t, value ); __DEFERRED_APPEND( value ); } break;
+			case XLOG_ARG_SIZE: { __DEFERRED_GET( size_t, value ); __DEFERRED_APPEND( value ); } break;
+			case XLOG_ARG_PTRDIFF: { __DEFERRED_GET( ptrdiff_t, value ); __DEFERRED_APPEND( value ); } break;
+			case XLOG_ARG_DOUBLE: { __DEFERRED_GET( double, value ); __DEFERRED_APPEND( value ); } break;
+			case XLOG_ARG_LDOUBLE: { __DEFERRED_GET( long double, value ); __DEFERRED_APPEND( value ); } break;
+			case XLOG_ARG_PTR: { __DEFERRED_GET( void *, value ); __DEFERRED_APPEND( value ); } break;
+			case XLOG_ARG_STR: {
+				__DEFERRED_GET( unsigned int, length );
+				const char *value = args;
+				args += length + 1;
+				__DEFERRED_APPEND( value );
+			} break;
+		}
+	}
+	#undef __DEFERRED_GET
+	#undef __DEFERRED_APPEND
+}
+
+/** record being formatted, input of segment emitters */
+typedef struct {
+	const xlog_module_t *module;
+	const xlog_callsite_t *callsite;		/* source location pre-rendered if NOT NULL */
+	const char *file, *func;
+	long int line;
+	const char *format;
+	va_list *ap;
+	const struct timespec *ts;				/* NULL for current time */
+	const char *task;						/* NULL for task of current thread */
+	int task_length;
+	const xlog_deferred_record_t *deferred;	/* body from raw arguments if NOT NULL */
+} xlog_record_t;
+
+typedef struct xlog_segment_tag xlog_segment_t;
+typedef void ( *xlog_segment_emit_t )( autobuf_t **autobuf, const xlog_segment_t *segment, const xlog_record_t *record );
+
+struct xlog_segment_tag {
+	xlog_segment_emit_t emit;
+	const char *text;
+	size_t length;
+};
+
+/** format plan, compiled per-(level, color, anonymous) and immutable once published */
+typedef struct xlog_format_plan_tag {
+	struct xlog_format_plan_tag *retired;	/* next retired plan, released once no reader */
+	int options;
+	int format;
+	unsigned int generation;
+	int count;
+	xlog_segment_t segments[XLOG_LIMIT_PLAN_SEGMENTS];
+	size_t used;
+	char text[XLOG_LIMIT_PLAN_TEXT];		/* merged constant text */
+} xlog_format_plan_t;
+
+static void __xlog_emit_text( autobuf_t **autobuf, const xlog_segment_t *segment, const xlog_record_t *record )
+{
+	( void )record;
+	autobuf_append_text_n( autobuf, segment->text, segment->length );
+}
+
+static void __xlog_emit_time( autobuf_t **autobuf, const xlog_segment_t *segment, const xlog_record_t *record )
+{
+	( void )segment;
+	char buffer[24];
+	int len = xlog_format_time( buffer, sizeof( buffer ), record->ts );
+	autobuf_append_text_n( autobuf, buffer, len );
+}
+
+static void __xlog_emit_task( autobuf_t **autobuf, const xlog_segment_t *segment, const xlog_record_t *record )
+{
+	( void )segment;
+	if( record->task ) {
+		autobuf_append_text_n( autobuf, record->task, record->task_length );
+	} else {
+		int len = 0;
+		const char *task = __xlog_task_descriptor( &len );
+		autobuf_append_text_n( autobuf, task, len );
+	}
+}
+
+static void __xlog_emit_module( autobuf_t **autobuf, const xlog_segment_t *segment, const xlog_record_t *record )
+{
+	( void )segment;
+	if( record->module && record->module->path ) {
+		autobuf_append_text_n( autobuf, record->module->path, record->module->path_length );
+	}
+}
+
+static void __xlog_emit_file( autobuf_t **autobuf, const xlog_segment_t *segment, const xlog_record_t *record )
+{
+	( void )segment;
+	if( record->callsite ) {
+		autobuf_append_text_n( autobuf, record->callsite->file, record->callsite->file_length );
+	} else if( record->file ) {
+		autobuf_append_text( autobuf, record->file );
+	}
+}
+
+static void __xlog_emit_func( autobuf_t **autobuf, const xlog_segment_t *segment, const xlog_record_t *record )
+{
+	( void )segment;
+	if( record->callsite ) {
+		autobuf_append_text_n( autobuf, record->callsite->func, record->callsite->func_length );
+	} else if( record->func ) {
+		autobuf_append_text( autobuf, record->func );
+	}
+}
+
+static void __xlog_emit_line( autobuf_t **autobuf, const xlog_segment_t *segment, const xlog_record_t *record )
+{
+	( void )segment;
+	if( record->callsite ) {
+		autobuf_append_text_n( autobuf, record->callsite->line_text, record->callsite->line_length );
+	} else {
+		char buff[12];
+		int len = snprintf( buff, sizeof( buff ), "%ld", record->line );
+		autobuf_append_text_n( autobuf, buff, len );
+	}
+}
+
+static void __xlog_emit_body( autobuf_t **autobuf, const xlog_segment_t *segment, const xlog_record_t *record )
+{
+	( void )segment;
+	if( record->deferred ) {
+		__xlog_deferred_render_body( autobuf, record->deferred );
+	} else {
+		autobuf_append_text_va_list( autobuf, record->format, *record->ap );
+	}
+}
+
+/** add segment to plan */
+static void __xlog_plan_add( xlog_format_plan_t *plan, xlog_segment_emit_t emit, const char *text, size_t length )
+{
+	if( plan->count >= XLOG_LIMIT_PLAN_SEGMENTS ) {
+		XLOG_TRACE( "Too many segments, ignored." );
+		return;
+	}
+	plan->segments[plan->count].emit = emit;
+	plan->segments[plan->count].text = text;
+	plan->segments[plan->count].length = length;
+	plan->count ++;
+}
+
+/** add constant text to plan, merged with the previous one if possible */
+static void __xlog_plan_add_text( xlog_format_plan_t *plan, const char *text )
+{
+	size_t len = text ? strlen( text ) : 0;
+	if( len == 0 ) {
+		return;
+	}
+	if( plan->used + len > sizeof( plan->text ) ) {
+		XLOG_TRACE( "No space to merge text, refer to it directly." );
+		__xlog_plan_add( plan, __xlog_emit_text, text, len );
+		return;
+	}
+	
+	char *ptr = plan->text + plan->used;
+	memcpy( ptr, text, len );
+	plan->used += len;
+	
+	xlog_segment_t *last = plan->count ? &plan->segments[plan->count - 1] : NULL;
+	if( last && last->emit == __xlog_emit_text && last->text + last->length == ptr ) {
+		last->length += len;
+	} else {
+		__xlog_plan_add( plan, __xlog_emit_text, ptr, len );
+	}
+}
+
+/** compile format plan from attributes/options of context */
+static xlog_format_plan_t *__xlog_plan_compile( const xlog_t *context, int level, bool color, bool anonymous )
+{
+	xlog_format_plan_t *plan = ( xlog_format_plan_t * )XLOG_MALLOC( sizeof( xlog_format_plan_t ) );
+	if( plan == NULL ) {
+		XLOG_TRACE( "Failed to allocate memory for format plan." );
+		return NULL;
+	}
+	memset( plan, 0, sizeof( xlog_format_plan_t ) );
+	plan->options = context->options;
+	plan->format = context->attributes[level].format;
+	plan->generation = context->plan_generation;
+	
+	/* NOTE: all formats enabled for logging without module */
+	const xlog_level_attr_t *attr = color ? &context->attributes[level] : &_level_attributes_none[level];
+	int format = anonymous ? XLOG_FORMAT_OALL : plan->format;
+	
+	if( format & XLOG_FORMAT_OTIME ) {
+		__xlog_plan_add_text( plan, attr->time_prefix );
+		__xlog_plan_add( plan, __xlog_emit_time, NULL, 0 );
+		__xlog_plan_add_text( plan, attr->time_suffix );
+	}
+	if( format & XLOG_FORMAT_OTASK ) {
+		__xlog_plan_add( plan, __xlog_emit_task, NULL, 0 );
+	}
+	if( format & ( XLOG_FORMAT_OLEVEL | XLOG_FORMAT_OMODULE ) ) {
+		__xlog_plan_add_text( plan, attr->class_prefix );
+		if( !anonymous && ( format & XLOG_FORMAT_OMODULE ) ) {
+			__xlog_plan_add( plan, __xlog_emit_module, NULL, 0 );
+		}
+		__xlog_plan_add_text( plan, attr->class_suffix );
+	}
+	if( format & XLOG_FORMAT_OLOCATION ) {
+		__xlog_plan_add_text( plan, XLOG_PREFIX_LOG_POINT );
+		if( format & XLOG_FORMAT_OFILE ) {
+			__xlog_plan_add( plan, __xlog_emit_file, NULL, 0 );
+		}
+		if( format & XLOG_FORMAT_OFUNC ) {
+			if( format & XLOG_FORMAT_OFILE ) {
+				__xlog_plan_add_text( plan, " " );
+			}
+			__xlog_plan_add( plan, __xlog_emit_func, NULL, 0 );
+		}
+		if( format & XLOG_FORMAT_OLINE ) {
+			if( format & ( XLOG_FORMAT_OFILE | XLOG_FORMAT_OFUNC ) ) {
+				__xlog_plan_add_text( plan, ":" );
+			}
+			__xlog_plan_add( plan, __xlog_emit_line, NULL, 0 );
+		}
+		__xlog_plan_add_text( plan, XLOG_SUFFIX_LOG_POINT );
+	}
+	if( context->options & XLOG_CONTEXT_OCOLOR_BODY ) {
+		__xlog_plan_add_text( plan, attr->body_prefix );
+	}
+	__xlog_plan_add( plan, __xlog_emit_body, NULL, 0 );
+	if( context->options & XLOG_CONTEXT_OCOLOR_BODY ) {
+		__xlog_plan_add_text( plan, attr->body_suffix );
+	}
+	__xlog_plan_add_text( plan, XLOG_STYLE_NEWLINE );
+	
+	return plan;
+}
+
+/** check if plan is compiled from current attributes/options of context */
+static inline bool __xlog_plan_fresh( const xlog_t *context, const xlog_format_plan_t *plan, int level )
+{
+	return plan
+		&& plan->options == context->options
+		&& plan->format == context->attributes[level].format
+		&& plan->generation == __atomic_load_n( &context->plan_generation, __ATOMIC_ACQUIRE );
+}
+
+/** release retired plans if readers are `self` only, lock of context held */
+static void __xlog_plan_reclaim( xlog_t *context, unsigned int self )
+{
+	/* NOTE: readers counted before loading plans, those came later never see the retired ones */
+	if( __atomic_load_n( &context->plan_readers, __ATOMIC_SEQ_CST ) != self ) {
+		return;
+	}
+	while( context->retired_plans ) {
+		xlog_format_plan_t *plan = context->retired_plans;
+		__atomic_store_n( &context->retired_plans, plan->retired, __ATOMIC_RELAXED );
+		XLOG_FREE( plan );
+	}
+}
+
+/** get format plan, recompile it if attributes/options of context changed; put it once done */
+static const xlog_format_plan_t *__xlog_plan_get( xlog_t *context, int level, bool color, bool anonymous )
+{
+	int index = ( color ? 1 : 0 ) | ( anonymous ? 2 : 0 );
+	__atomic_add_fetch( &context->plan_readers, 1, __ATOMIC_SEQ_CST );
+	xlog_format_plan_t *plan = __atomic_load_n( &context->plans[level][index], __ATOMIC_SEQ_CST );
+	if( __xlog_plan_fresh( context, plan, level ) ) {
+		return plan;
+	}
+	
+	pthread_mutex_lock( &context->lock );
+	/* NOTE: compiled by another thread while waiting for lock */
+	plan = context->plans[level][index];
+	if( !__xlog_plan_fresh( context, plan, level ) ) {
+		XLOG_TRACE( "Format plan outdated, compile it." );
+		xlog_format_plan_t *fresh = __xlog_plan_compile( context, level, color, anonymous );
+		if( fresh ) {
+			/* NOTE: plans may be still in use by other threads, released once no reader */
+			if( plan ) {
+				plan->retired = context->retired_plans;
+				__atomic_store_n( &context->retired_plans, plan, __ATOMIC_RELAXED );
+			}
+			__atomic_store_n( &context->plans[level][index], fresh, __ATOMIC_SEQ_CST );
+			plan = fresh;
+		}
+	}
+	__xlog_plan_reclaim( context, 1 );
+	pthread_mutex_unlock( &context->lock );
+	if( plan == NULL ) {
+		__atomic_sub_fetch( &context->plan_readers, 1, __ATOMIC_SEQ_CST );
+	}
+	
+	return plan;
+}
+
+/** put format plan got, the last reader releases retired plans */
+static void __xlog_plan_put( xlog_t *context )
+{
+	if(
+		__atomic_sub_fetch( &context->plan_readers, 1, __ATOMIC_SEQ_CST ) == 0
+		&& __atomic_load_n( &context->retired_plans, __ATOMIC_RELAXED )
+		&& pthread_mutex_trylock( &context->lock ) == 0
+	) {
+		__xlog_plan_reclaim( context, 0 );
+		pthread_mutex_unlock( &context->lock );
+	}
+}
+
+/** release all plans of context */
+static void __xlog_plan_release( xlog_t *context )
+{
+	for( int i = 0; i < XLOG_LIMIT_LEVEL_NUMBER; i ++ ) {
+		for( int j = 0; j < XLOG_ARRAY_SIZE( context->plans[i] ); j ++ ) {
+			XLOG_FREE( context->plans[i][j] );
+			context->plans[i][j] = NULL;
+		}
+	}
+	while( context->retired_plans ) {
+		xlog_format_plan_t *plan = context->retired_plans;
+		context->retired_plans = plan->retired;
+		XLOG_FREE( plan );
+	}
+}
+
+/** format deferred record(header + task + raw arguments) to text */
+int xlog_deferred_render( const xlog_deferred_record_t *record, int abiclr, autobuf_t **autobuf )
+{
+	XLOG_ASSERT( record && autobuf && *autobuf );
+	size_t offset = ( *autobuf )->offset;
+	if( record->flags & XLOG_DEFERRED_ORAW ) {
+		autobuf_append_text_n( autobuf, ( const char * )( record + 1 ), record->size - sizeof( xlog_deferred_record_t ) );
+	} else {
+		const xlog_format_plan_t *plan = __xlog_plan_get( record->context, record->level, abiclr, record->module == NULL );
+		if( plan == NULL ) {
+			XLOG_TRACE( "Failed to get format plan." );
+			return 0;
+		}
+		xlog_record_t rendering = {
+			.module = record->module,
+			.callsite = xlog_callsite_lookup( record->site ),
+			.file = record->file,
+			.func = record->func,
+			.line = record->line,
+			.ts = &record->ts,
+			.task = ( const char * )( record + 1 ),
+			.task_length = record->task_length,
+			.deferred = record,
+		};
+		for( int i = 0; i < plan->count; i ++ ) {
+			plan->segments[i].emit( autobuf, &plan->segments[i], &rendering );
+		}
+		__xlog_plan_put( record->context );
+	}
+	
+	return ( *autobuf )->offset - offset;
+}
+
+/** capture time, task and raw arguments, formatted later by consumer; -1 if NOT able to defer */
+static int __xlog_output_deferred(
+	xlog_printer_t *printer, xlog_t *context,
+	xlog_module_t *module, int level, xlog_callsite_t *callsite,
+	const char *file, const char *func, long int line,
+	const char *format, va_list ap
+)
+{
+	/* NOTE: format of call-site may be a variable or buffer reused, check content before using the parsed one */
+	const xlog_deferred_format_t *parsed = callsite ? __atomic_load_n( ( const xlog_deferred_format_t ** )&callsite->deferred, __ATOMIC_ACQUIRE ) : NULL;
+	if( parsed == NULL || strcmp( parsed->format, format ) != 0 ) {
+		parsed = __xlog_deferred_lookup( format );
+		if( callsite && parsed ) {
+			__atomic_store_n( &callsite->deferred, parsed, __ATOMIC_RELEASE );
+		}
+	}
+	if( parsed == NULL || !parsed->supported ) {
+		return -1;
+	}
+	
+	union {
+		xlog_deferred_record_t header;
+		char data[XLOG_LIMIT_DEFERRED_RECORD];
+	} record;
+	record.header.flags = 0;
+	record.header.level = level;
+	record.header.task_length = 0;
+	record.header.format = parsed;
+	record.header.site = callsite ? callsite->id : XLOG_CALLSITE_ID_NONE;
+	record.header.context = context;
+	record.header.module = module;
+	record.header.file = file;
+	record.header.func = func;
+	record.header.line = line;
+	clock_gettime( XLOG_CLOCK_LOG_TIME, &record.header.ts );
+	
+	char *ptr = record.data + sizeof( xlog_deferred_record_t );
+	const char *end = record.data + sizeof( record );
+	
+	/* NOTE: task descriptor belongs to current thread, capture it now */
+	if( module == NULL || ( context->attributes[level].format & XLOG_FORMAT_OTASK ) ) {
+		int length = 0;
+		const char *task = __xlog_task_descriptor( &length );
+		if( length > end - ptr ) {
+			return -1;
+		}
+		memcpy( ptr, task, length );
+		ptr += length;
+		record.header.task_length = length;
+	}
+	
+	#define __DEFERRED_PUT(type)	do { \
+		type value = va_arg( ap, type ); \
+		if( ( ptrdiff_t )sizeof( type ) > end - ptr ) { return -1; } \
+		memcpy( ptr, &value, sizeof( type ) ); \
+		ptr += sizeof( type ); \
+	} while( 0 )
+	for( int i = 0; i < parsed->count; i ++ ) {
+		const xlog_deferred_piece_t *piece = &parsed->pieces[i];
+		int star = -1;
+		for( int j = 0; j < piece->stars; j ++ ) {
+			star = va_arg( ap, int );
+			if( ( ptrdiff_t )sizeof( int ) > end - ptr ) {
+				return -1;
+			}
+			memcpy( ptr, &star, sizeof( int ) );
+			ptr += sizeof( int );
+		}
+		switch( piece->type ) {
+			case XLOG_ARG_INT: __DEFERRED_PUT( int ); break;
+			case XLOG_ARG_LONG: __DEFERRED_PUT( long ); break;
+			case XLOG_ARG_LLONG: __DEFERRED_PUT( long long ); break;
+			case XLOG_ARG_INTMAX: __DEFERRED_PUT( intmax_t ); break;
+			case XLOG_ARG_SIZE: __DEFERRED_PUT( size_t ); break;
+			case XLOG_ARG_PTRDIFF: __DEFERRED_PUT( ptrdiff_t ); break;
+			case XLOG_ARG_DOUBLE: __DEFERRED_PUT( double ); break;
+			case XLOG_ARG_LDOUBLE: __DEFERRED_PUT( long double ); break;
+			case XLOG_ARG_PTR: __DEFERRED_PUT( void * ); break;
+			case XLOG_ARG_STR: {
+				/* NOTE: string may be gone before formatted, copy it */
+				const char *value = va_arg( ap, const char * );
+				if( value == NULL ) {
+					value = "(null)";
+				}
+				int precision = piece->precision == -2 ? star : piece->precision;
+				unsigned int length = precision >= 0 ? strnlen( value, precision ) : strlen( value );
+				if( ( ptrdiff_t )( sizeof( unsigned int ) + length + 1 ) > end - ptr ) {
+					return -1;
+				}
+				memcpy( ptr, &length, sizeof( unsigned int ) );
+				ptr += sizeof( unsigned int );
+				memcpy( ptr, value, length );
+				ptr[length] = '\0';
+				ptr += length + 1;
+			} break;
+		}
+	}
+	#undef __DEFERRED_PUT
+	record.header.size = ptr - record.data;
+	
+	int error = xlog_printer_append_deferred( printer, &record.header );
+	if( error == EINVAL ) {
+		XLOG_TRACE( "Failed to append deferred record." );
+		return -1;
+	} else if( error != 0 ) {
+		XLOG_TRACE( "Deferred record dropped by overflow policy." );
+		return 0;
+	}
+	if( module ) {
+		XLOG_STATS_UPDATE( &module->stats, BYTE, INPUT, record.header.size );
+	}
+	
+	return record.header.size;
+}
+
+/** format record into ring-buffer of printer in place, return -1 if it should be formatted as usual */
+static int __xlog_output_inplace(
+	xlog_printer_t *printer, const xlog_format_plan_t *plan,
+	const xlog_module_t *module, int level, const xlog_callsite_t *callsite,
+	const char *file, const char *func, long int line,
+	const char *format, va_list ap
+)
+{
+	char *text = NULL;
+	int error = xlog_printer_reserve_text( printer, XLOG_LIMIT_INPLACE_RECORD, &text );
+	if( error == EAGAIN || error == ETIMEDOUT ) {
+		XLOG_TRACE( "Dropped by overflow policy." );
+		return 0;
+	} else if( error != 0 ) {
+		XLOG_TRACE( "Unable to reserve in ring-buffer, error = %d.", error );
+		return -1;
+	}
+	
+	union {
+		autobuf_t autobuf;
+		char storage[AUTOBUF_ATTACHED_SIZE];
+	} fixed;
+	autobuf_t *autobuf = autobuf_attach( &fixed, XLOG_PAYLOAD_ID_AUTO, "Log", AUTOBUF_OTEXT, text, XLOG_LIMIT_INPLACE_RECORD );
+	*text = '\0';
+	
+	va_list args;
+	va_copy( args, ap );
+	xlog_record_t record = {
+		.module = module,
+		.callsite = callsite,
+		.file = file,
+		.func = func,
+		.line = line,
+		.format = format,
+		.ap = &args,
+	};
+	for( int i = 0; i < plan->count; i ++ ) {
+		plan->segments[i].emit( &autobuf, &plan->segments[i], &record );
+	}
+	va_end( args );
+	
+	if( autobuf->offset >= autobuf->length ) {
+		XLOG_TRACE( "Too long to format in place, cancelled." );
+		xlog_printer_commit_text( printer, text, 0, level );
+		return -1;
+	}
+	int length = autobuf->offset;
+	if( module ) {
+		XLOG_STATS_UPDATE( &module->stats, BYTE, INPUT, length );
+	}
+	xlog_printer_commit_text( printer, text, length, level );
+	
+	return length;
+}
+
+
+/**
+ * @brief  create xlog context
+ *
+ * @param  savepath, path to save configurations
+ *         option, open option
+ * @return pointer to `xlog_t`, NULL if failed to create context.
+ *
+ */
+XLOG_PUBLIC( xlog_t * ) xlog_open( const char *savepath, int option )
+{
+	xlog_t *context = NULL;
+	context = ( xlog_t * )XLOG_MALLOC( sizeof( xlog_t ) );
+	if( context ) {
+		memset( context, 0, sizeof( xlog_t ) );
+		
+		/** NOTE: initialize lock */
+		if( pthread_mutex_init( &context->lock, NULL ) != 0 ) {
+			XLOG_FREE( context );
+			context = NULL;
+		} else {
+			context->module = __xlog_module_open( NULL, XLOG_LEVEL_VERBOSE, NULL );
+			if( NULL == context->module ) {
+				pthread_mutex_destroy( &context->lock );
+				XLOG_FREE( context );
+				context = NULL;
+				
+				return context;
+			}
+			context->module->context = context;
+			context->options = XLOG_CONTEXT_OALIVE | XLOG_CONTEXT_OCOLOR;
+			if( savepath ) {
+				XLOG_TRACE( "Auto dump enabled 'cause savepath is NOT NULL." );
+				context->options |= XLOG_CONTEXT_OAUTO_DUMP;
+			}
+			memcpy( context->attributes, &_level_attributes_default, sizeof( context->attributes ) );
+			
+			/** NOTE: create files to save configurations */
+			if( savepath ) {
+				char *_dir = XLOG_STRDUP( savepath ), *_ptr = _dir;
+				if( _dir ) {
+					_ptr = _dir + strlen( _dir ) - 1;
+					while( _ptr > _dir && ( '\\' == *_ptr || '/' == *_ptr ) ) {
+						XLOG_TRACE( "Strip ending \"/\" and \"\\\"." );
+						*_ptr -- = '\0';
+					}
+					context->savepath = _dir;
+					__mkdir_p( context->savepath, 0777 );
+					
+					if( option & XLOG_OPEN_LOAD ) {
+						XLOG_TRACE( "Loading configuration from files." );
+						__xlog_load_modules( context );
+					}
+				}
+			} else {
+				XLOG_TRACE( "Set savepath to NULL." );
+				context->savepath = NULL;
+			}
+			
+			/** NOTE: voting to initial-size of autobuf */
+			context->initial_size = XLOG_DEFAULT_PAYLOAD_SIZE;
+			#if (defined XLOG_FEATURE_ENABLE_DYNAMIC_DEFAULT_AUTOBUF_SIZE)
+			context->size_votes = XLOG_MALLOC( sizeof( size_t ) * XLOG_ARRAY_SIZE( vote_thresholds ) );
+			if( context->size_votes == NULL ) {
+				XLOG_TRACE( "Failed to allocate memory for voting." );
+			}
+			#endif
+			
+			/** NOTE: initialize stats */
+			XLOG_STATS_INIT( &context->stats, XLOG_STATS_CONTEXT_OPTION );
+			
+			#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
+			context->magic = XLOG_MAGIC_CONTEXT;
+			#endif
+		}
+	}
+	
+	return context;
+}
+
+/**
+ * @brief  destory xlog context
+ *
+ * @param  context, pointer to `xlog_t`
+ *         option, close option
+ * @return error code.
+ *
+ */
+XLOG_PUBLIC( int ) xlog_close( xlog_t *context, int option )
+{
+	#if (defined XLOG_FEATURE_ENABLE_DEFAULT_CONTEXT)
+	if( context == NULL ) {
+		XLOG_TRACE( "Redirect to default context." );
+		context = __default_context;
+	}
+	#endif
+	if( context ) {
+		#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
+		if( context->magic != XLOG_MAGIC_CONTEXT ) {
+			XLOG_TRACE( "Runtime error: may be context has been closed." );
+			return EINVAL;
+		}
+		context->magic = XLOG_MAGIC_CONTEXT;
+		#endif
+		pthread_mutex_lock( &context->lock );
+		xlog_module_close( context->module );
+		if( context->savepath ) {
+			if( option & XLOG_CLOSE_CLEAR ) {
+				XLOG_TRACE( "CLEAR ON CLOSE is enabled, and savepath is NOT NULL, remove directories." );
+				__rmdir_r( context->savepath );
+			}
+			XLOG_FREE( context->savepath );
+		}
+		#if (defined XLOG_FEATURE_ENABLE_DYNAMIC_DEFAULT_AUTOBUF_SIZE)
+		XLOG_FREE( context->size_votes );
+		#endif
+		XLOG_STATS_FINI( &context->stats );
+		__xlog_plan_release( context );
+		pthread_mutex_unlock( &context->lock );
+		pthread_mutex_destroy( &context->lock );
+		#if (defined XLOG_FEATURE_ENABLE_DEFAULT_CONTEXT)
+		if( context == __default_context ) {
+			XLOG_TRACE( "Destory default context." );
+			__default_context = NULL;
+		}
+		#endif
+		XLOG_FREE( context );
+	}
+	
+	return 0;
+}
+
+/**
+ * @brief  set attributes of logging level
+ *
+ * @param  context, pointer to `xlog_t`
+ *         level, logging level
+ *         attributes, format and prefix/suffix of segments
+ * @return error code.
+ *
+ */
+XLOG_PUBLIC( int ) xlog_set_level_attributes( xlog_t *context, int level, const xlog_level_attr_t *attributes )
+{
+	#if (defined XLOG_FEATURE_ENABLE_DEFAULT_CONTEXT)
+	if( context == NULL ) {
+		XLOG_TRACE( "Redirect to default context." );
+		context = __default_context;
+	}
+	#endif
+	if( context == NULL || attributes == NULL || !XLOG_IF_NOT_SILENT_LEVEL( level ) ) {
+		XLOG_TRACE( "Invalid parameters." );
+		return EINVAL;
+	}
+	#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
+	if( context->magic != XLOG_MAGIC_CONTEXT ) {
+		XLOG_TRACE( "Runtime error: may be context has been closed." );
+		return EINVAL;
+	}
+	#endif
+	
+	pthread_mutex_lock( &context->lock );
+	memcpy( &context->attributes[level], attributes, sizeof( xlog_level_attr_t ) );
+	__atomic_add_fetch( &context->plan_generation, 1, __ATOMIC_RELEASE );
+	pthread_mutex_unlock( &context->lock );
+	
+	return 0;
+}
+
+/**
+ * @brief  list all modules under xlog context
+ *
+ * @param  context, pointer to `xlog_t`
+ *         options, print options
+ *
+ */
+XLOG_PUBLIC( void ) xlog_list_modules( const xlog_t *context, int options )
+{
+	#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
+	if( context && context->magic != XLOG_MAGIC_CONTEXT ) {
+		XLOG_TRACE( "Runtime error: may be context has been closed." );
+		return;
+	}
+	#endif
+	#if (defined XLOG_FEATURE_ENABLE_DEFAULT_CONTEXT)
+	if( context == NULL ) {
+		if( __default_context == NULL ) {
+			XLOG_TRACE( "Create default context." );
+			__default_context = xlog_open( NULL, 0 );
+			if( __default_context == NULL ) {
+				XLOG_TRACE( "Failed to create default context." );
+				return;
+			}
+		}
+		XLOG_TRACE( "Redirected to default context." );
+		context = __default_context;
+	}
+	#else
+	XLOG_ASSERT( context && context->module );
+	#endif
+	
+	xlog_module_list_submodules( context->module, options );
+}
+
+/**
+ * @brief  get xlog version
+ *
+ * @param  buffer/size, buffer to save version description
+ * @return version code[MSB...8 major, 7...4 minor, 3...0 revision]
+ *
+ */
+XLOG_PUBLIC( int ) xlog_version( char *buffer, int size )
+{
+	#if (defined XLOG_VERSION_WITH_BUILDDATE)
 	#define DATE_YEAR ( ( ( ( __DATE__[7] - '0' ) * 10 + ( __DATE__[8] - '0' ) ) *10 \
 		+ ( __DATE__[9] - '0' ) ) * 10 + ( __DATE__[10] - '0' ) \
 	)
@@ -1204,7 +2362,7 @@ XLOG_PUBLIC( int ) xlog_version( char *buffer, int size )
 		+ ( __DATE__[5] - '0' ) \
 	)
 	#endif
-
+	
 	if( buffer != NULL ) {
 		snprintf(
 			buffer, size, "V%d.%d.%d"
@@ -1222,6 +2380,59 @@ XLOG_PUBLIC( int ) xlog_version( char *buffer, int size )
 	return XLOG_VERSION_MAJOR << 8 | XLOG_VERSION_MINOR << 4 | XLOG_VERSION_PATCH << 0;
 }
 
+/**
+ * @brief  format log-time as "MM/DD HH:MM:SS.mmm"
+ *
+ * @param  buffer/size, buffer to save formatted time
+ *         ts, time to format; NULL to read current time via XLOG_CLOCK_LOG_TIME
+ * @return length of formatted time, 0 if buffer is too small.
+ *
+ * @note   "MM/DD HH:MM:SS" is cached per thread and re-rendered once per second.
+ *
+ */
+XLOG_PUBLIC( int ) xlog_format_time( char *buffer, int size, const struct timespec *ts )
+{
+	#if ((defined __linux__) || (defined __FreeBSD__) || (defined __APPLE__) || (defined __unix__))
+	struct timespec now;
+	if( ts == NULL ) {
+		clock_gettime( XLOG_CLOCK_LOG_TIME, &now );
+		ts = &now;
+	}
+	
+	xlog_time_cache_t *cache = &__time_cache;
+	if( cache->second != ts->tv_sec ) {
+		XLOG_TRACE( "Second changed, render time again." );
+		struct tm tm;
+		localtime_r( &ts->tv_sec, &tm );
+		cache->length = snprintf(
+			cache->text, sizeof( cache->text ),
+			"%02d/%02d %02d:%02d:%02d",
+			tm.tm_mon + 1, tm.tm_mday,
+			tm.tm_hour, tm.tm_min, tm.tm_sec
+		);
+		cache->second = ts->tv_sec;
+	}
+	#else
+	#error No implementation for this system.
+	#endif
+	
+	/* patch milliseconds to cached text */
+	if( buffer == NULL || size < cache->length + 5 ) {
+		XLOG_TRACE( "Buffer is too small." );
+		return 0;
+	}
+	int msec = ( int )( ts->tv_nsec / 1000000 );
+	char *ptr = buffer + cache->length;
+	memcpy( buffer, cache->text, cache->length );
+	ptr[0] = '.';
+	ptr[1] = ( char )( '0' + msec / 100 );
+	ptr[2] = ( char )( '0' + msec / 10 % 10 );
+	ptr[3] = ( char )( '0' + msec % 10 );
+	ptr[4] = '\0';
+	
+	return cache->length + 4;
+}
+
 /**
  * @brief  output raw log
  *
@@ -1256,7 +2467,13 @@ XLOG_PUBLIC( int ) xlog_output_rawlog(
 		return 0;
 	}
 	
-	autobuf_t *autobuf = autobuf_create( XLOG_PAYLOAD_ID_AUTO, "Log Text", AUTOBUF_ODYNAMIC | AUTOBUF_OALIGN, context ? context->initial_size : 240, 64 );
+	size_t initial_size = context ? context->initial_size : 240;
+	bool scratch = XLOG_PRINTER_BUFF_GET( printer->options ) != XLOG_PRINTER_BUFF_NCPYRBUF;
+	autobuf_t *autobuf = scratch ? __xlog_scratch_acquire( initial_size ) : NULL;
+	if( autobuf == NULL ) {
+		scratch = false;
+		autobuf = autobuf_create( XLOG_PAYLOAD_ID_AUTO, "Log Text", AUTOBUF_ODYNAMIC | AUTOBUF_OALIGN, initial_size, 64 );
+	}
 	if( autobuf ) {
 		if( prefix ) {
 			autobuf_append_text( &autobuf, prefix );
@@ -1269,6 +2486,11 @@ XLOG_PUBLIC( int ) xlog_output_rawlog(
 			autobuf_append_text( &autobuf, suffix );
 		}
 		
+		if( scratch ) {
+			int length = xlog_printer_print_autobuf( printer, &autobuf );
+			__xlog_scratch_release( autobuf );
+			return length;
+		}
 		return xlog_printer_take_over_autobuf( printer, &autobuf );
 	} else {
 		__XLOG_TRACE( "Failed to create autobuf." );
@@ -1277,21 +2499,12 @@ XLOG_PUBLIC( int ) xlog_output_rawlog(
 	return 0;
 }
 
-/**
- * @brief  output formated log
- *
- * @param  printer, printer to output log
- *         module, logging module
- *         level, logging level
- *         file/func/line, source location
- * @return length of logging.
- *
- */
-XLOG_PUBLIC( int ) xlog_output_fmtlog(
+/** output formated log, callsite is optional */
+static int __xlog_output_fmtlog(
 	xlog_printer_t *printer,
-	xlog_module_t *module, int level,
+	xlog_module_t *module, int level, xlog_callsite_t *callsite,
 	const char *file, const char *func, long int line,
-	const char *format, ...
+	const char *format, va_list ap
 )
 {
 	xlog_t *context = xlog_module_context( module );
@@ -1344,127 +2557,80 @@ XLOG_PUBLIC( int ) xlog_output_fmtlog(
 		return 0;
 	}
 	
-	/** module based limit */
-	if( module && XLOG_IF_DROP_LEVEL( level, xlog_module_level_limit( module ) ) ) {
+	/** module based limit, ignored by call-site switched on */
+	if(
+		module && XLOG_IF_DROP_LEVEL( level, xlog_module_level_limit( module ) )
+		&& !( callsite && __atomic_load_n( &callsite->control, __ATOMIC_ACQUIRE ) == XLOG_CALLSITE_CTRL_ON )
+	) {
 		XLOG_STATS_UPDATE( &module->stats, REQUEST, DROPPED, 1 );
 		XLOG_TRACE( "Dropped by module." );
 		return 0;
 	}
 	
-	const xlog_level_attr_t *level_attributes = _level_attributes_none;
-	if( printer->optctl ) {
-		int optval;
-		if(
-		   printer->optctl( printer, XLOG_PRINTER_CTRL_GABICLR, &optval, sizeof( int ) ) == 0
-		   && optval
-		) {
-			level_attributes = context->attributes;
+	/* capture arguments only, formatted by consumer of deferred printer */
+	if( XLOG_PRINTER_BUFF_GET( printer->options ) == XLOG_PRINTER_BUFF_DEFERRED ) {
+		va_list args;
+		va_copy( args, ap );
+		int length = __xlog_output_deferred( printer, context, module, level, callsite, file, func, line, format, args );
+		va_end( args );
+		if( length >= 0 ) {
+			return length;
 		}
+		XLOG_TRACE( "Unable to defer, format it now." );
 	}
 	
-	autobuf_t *autobuf = autobuf_create(
-		XLOG_PAYLOAD_ID_AUTO, "Log",
-		AUTOBUF_ODYNAMIC | AUTOBUF_OALIGN | AUTOBUF_OTEXT, context->initial_size, 64
-	);
-	if( autobuf == NULL ) {
-		XLOG_TRACE( "Failed to create autobuf." );
+	const xlog_format_plan_t *plan = __xlog_plan_get( context, level, xlog_printer_abiclr( printer ), module == NULL );
+	if( plan == NULL ) {
+		XLOG_TRACE( "Failed to get format plan." );
 		return 0;
 	}
 	
-	/* package time */
-	if( __xlog_format_been_enabled( module, level, XLOG_FORMAT_OTIME ) ) {
-		XLOG_TRACE( "Package time to autobuf." );
-		#if ((defined __linux__) || (defined __FreeBSD__) || (defined __APPLE__) || (defined __unix__))
-		char buffer[48];
-		struct timeval tv;
-		gettimeofday( &tv, NULL );
-		struct tm tm;
-		localtime_r( &tv.tv_sec, &tm );
-		snprintf(
-			buffer, sizeof( buffer ),
-			"%s%02d/%02d %02d:%02d:%02d.%03d%s"
-			, level_attributes[level].time_prefix
-			, tm.tm_mon + 1, tm.tm_mday
-			, tm.tm_hour, tm.tm_min, tm.tm_sec, ( int )( ( ( tv.tv_usec + 500 ) / 1000 ) % 1000 )
-			, level_attributes[level].time_suffix
-		);
-		autobuf_append_text( &autobuf, buffer );
-		#else
-		#error No implementation for this system.
-		#endif
-	}
-	
-	/* package task info */
-	if( __xlog_format_been_enabled( module, level, XLOG_FORMAT_OTASK ) ) {
-		XLOG_TRACE( "Package task info to autobuf." );
-		char taskname[XLOG_LIMIT_THREAD_NAME];
-		XLOG_GET_THREAD_NAME( taskname );
-		if( taskname[0] == '\0' ) {
-			snprintf( taskname, sizeof( taskname ), "%s", XLOG_THREAD_UNNAMED );
+	/* format into lock-free ring-buffer of printer directly, no copying */
+	if( XLOG_PRINTER_BUFF_GET( printer->options ) == XLOG_PRINTER_BUFF_RINGBUF ) {
+		int length = __xlog_output_inplace( printer, plan, module, level, callsite, file, func, line, format, ap );
+		if( length >= 0 ) {
+			__xlog_plan_put( context );
+			return length;
 		}
-		autobuf_append_text_va(
-			&autobuf, XLOG_PREFIX_LOG_TASK "%d/%d %s" XLOG_SUFFIX_LOG_TASK,
-			getppid(), getpid(), taskname
-		);
+		XLOG_TRACE( "Unable to format in place, format it now." );
 	}
 	
-	/* package class(level and module path) */
-	if( __xlog_format_been_enabled( module, level, XLOG_FORMAT_OLEVEL | XLOG_FORMAT_OMODULE ) ) {
-		XLOG_TRACE( "Package class info to autobuf." );
-		char modulename[XLOG_LIMIT_MODULE_PATH] = { 0 };
-		autobuf_append_text( &autobuf, level_attributes[level].class_prefix );
-		if( module && __xlog_format_been_enabled( module, level, XLOG_FORMAT_OMODULE ) ) {
-			autobuf_append_text( &autobuf, xlog_module_name( modulename, XLOG_LIMIT_MODULE_PATH, module ) );
-		}
-		autobuf_append_text( &autobuf, level_attributes[level].class_suffix );
+	/* NOTE: record never outlives the call unless printer takes it over */
+	bool scratch = XLOG_PRINTER_BUFF_GET( printer->options ) != XLOG_PRINTER_BUFF_NCPYRBUF;
+	autobuf_t *autobuf = scratch ? __xlog_scratch_acquire( context->initial_size ) : NULL;
+	if( autobuf == NULL ) {
+		scratch = false;
+		autobuf = autobuf_create(
+			XLOG_PAYLOAD_ID_AUTO, "Log",
+			AUTOBUF_ODYNAMIC | AUTOBUF_OALIGN | AUTOBUF_OTEXT, context->initial_size, 64
+		);
 	}
-	
-	/* package source location */
-	if( __xlog_format_been_enabled( module, level, XLOG_FORMAT_OLOCATION ) ) {
-		XLOG_TRACE( "Package source location to autobuf." );
-		const char *_file = __xlog_format_been_enabled( module, level, XLOG_FORMAT_OFILE ) ? file : NULL;
-		const char *_func = __xlog_format_been_enabled( module, level, XLOG_FORMAT_OFUNC ) ? func : NULL;
-		long _line = __xlog_format_been_enabled( module, level, XLOG_FORMAT_OLINE ) ? line : -1;
-		
-		autobuf_append_text( &autobuf, XLOG_PREFIX_LOG_POINT );
-		if( _file ) {
-			autobuf_append_text( &autobuf, _file );
-		}
-		if( _func ) {
-			if( _file ) {
-				autobuf_append_text( &autobuf, " " );
-			}
-			autobuf_append_text( &autobuf, _func );
-		}
-		if( _line != -1 ) {
-			if( _file || _func ) {
-				autobuf_append_text( &autobuf, ":" );
-			}
-			char buff[12];
-			snprintf( buff, sizeof( buff ), "%ld", _line );
-			autobuf_append_text( &autobuf, buff );
-		}
-		autobuf_append_text( &autobuf, XLOG_SUFFIX_LOG_POINT );
+	if( autobuf == NULL ) {
+		XLOG_TRACE( "Failed to create autobuf." );
+		__xlog_plan_put( context );
+		return 0;
 	}
 	
-	/* package log body */
-	va_list ap;
-	va_start( ap, format );
-	if(
-	   ( context->options & XLOG_CONTEXT_OCOLOR_BODY )
-	   && level_attributes[level].body_prefix
-	) {
-		autobuf_append_text( &autobuf, level_attributes[level].body_prefix );
-	}
-	autobuf_append_text_va_list( &autobuf, format, ap );
-	if(
-	   ( context->options & XLOG_CONTEXT_OCOLOR_BODY )
-	   && level_attributes[level].body_suffix
-	) {
-		autobuf_append_text( &autobuf, level_attributes[level].body_suffix );
+	/* package log by running format plan, time read once for both formatting and printer */
+	struct timespec now;
+	clock_gettime( XLOG_CLOCK_LOG_TIME, &now );
+	va_list args;
+	va_copy( args, ap );
+	xlog_record_t record = {
+		.module = module,
+		.callsite = callsite,
+		.file = file,
+		.func = func,
+		.line = line,
+		.format = format,
+		.ap = &args,
+		.ts = &now,
+	};
+	for( int i = 0; i < plan->count; i ++ ) {
+		plan->segments[i].emit( &autobuf, &plan->segments[i], &record );
 	}
-	va_end( ap );
-	autobuf_append_text( &autobuf, XLOG_STYLE_NEWLINE );
+	va_end( args );
+	__xlog_plan_put( context );
 	#if (defined XLOG_FEATURE_ENABLE_DYNAMIC_DEFAULT_AUTOBUF_SIZE)
 	if( context->size_votes ) {
 		weighted_voting_vote( autobuf->offset, context->size_votes, vote_thresholds, XLOG_ARRAY_SIZE( vote_thresholds ) );
@@ -1475,8 +2641,80 @@ XLOG_PUBLIC( int ) xlog_output_fmtlog(
 		XLOG_STATS_UPDATE( &module->stats, BYTE, INPUT, autobuf->offset );
 	}
 	
-	int length = xlog_printer_take_over_autobuf( printer, &autobuf );
-	XLOG_ASSERT( autobuf == NULL );
+	int length = 0;
+	if( XLOG_PRINTER_BUFF_GET( printer->options ) != XLOG_PRINTER_BUFF_NCPYRBUF ) {
+		/* NOTE: length of text is known by autobuf, NOT counted again by printer */
+		length = xlog_printer_append( printer, autobuf_data_vptr( autobuf ), autobuf->offset, level, &now );
+		if( scratch ) {
+			__xlog_scratch_release( autobuf );
+		} else {
+			autobuf_destory( &autobuf );
+		}
+	} else {
+		length = xlog_printer_take_over_autobuf( printer, &autobuf );
+		XLOG_ASSERT( autobuf == NULL );
+	}
+	
+	return length;
+}
+
+/**
+ * @brief  output formated log
+ *
+ * @param  printer, printer to output log
+ *         module, logging module
+ *         level, logging level
+ *         file/func/line, source location
+ * @return length of logging.
+ *
+ */
+XLOG_PUBLIC( int ) xlog_output_fmtlog(
+	xlog_printer_t *printer,
+	xlog_module_t *module, int level,
+	const char *file, const char *func, long int line,
+	const char *format, ...
+)
+{
+	va_list ap;
+	va_start( ap, format );
+	int length = __xlog_output_fmtlog( printer, module, level, NULL, file, func, line, format, ap );
+	va_end( ap );
+	
+	return length;
+}
+
+/**
+ * @brief  output formated log of call-site, register call-site at the first time
+ *
+ * @param  printer, printer to output log
+ *         module, logging module
+ *         callsite, static descriptor of call-site(level and source location)
+ * @return length of logging.
+ *
+ */
+XLOG_PUBLIC( int ) xlog_output_sitelog(
+	xlog_printer_t *printer,
+	xlog_module_t *module, xlog_callsite_t *callsite,
+	const char *format, ...
+)
+{
+	XLOG_ASSERT( callsite );
+	if( __atomic_load_n( &callsite->id, __ATOMIC_ACQUIRE ) == XLOG_CALLSITE_ID_NONE ) {
+		XLOG_TRACE( "Register call-site at the first time." );
+		xlog_callsite_register( callsite, module, format );
+	}
+	if( __atomic_load_n( &callsite->control, __ATOMIC_ACQUIRE ) == XLOG_CALLSITE_CTRL_OFF ) {
+		XLOG_TRACE( "Dropped by call-site." );
+		return 0;
+	}
+	
+	va_list ap;
+	va_start( ap, format );
+	int length = __xlog_output_fmtlog(
+		printer, module, callsite->level, callsite,
+		callsite->file, callsite->func, callsite->line, format, ap
+	);
+	va_end( ap );
 	
 	return length;
 }
@@ -64,34 +64,520 @@ XLOG_PUBLIC( xlog_printer_t * ) xlog_printer_set_default( xlog_printer_t *printe
 }
 
 
+/** ring-buffer of a producer thread, XLOG_PRINTER_OPERTHREAD */
+struct __printer_thread_ring {
+	ringbuf_t *rbuff;
+	bool exited;	/* producer thread exited, reclaimed by consumer after drained */
+	struct __printer_thread_ring *next;
+};
+
 struct __printer_ringbuf_context {
 	bool force_exit;
+	int buff_type;
 	pthread_t thread_consumer;
-	ringbuf_t *rbuff;
+	ringbuf_t *rbuff;	/* shared by producers, NULL if XLOG_PRINTER_OPERTHREAD */
 	xlog_printer_t *printer;
+	
+	/* XLOG_PRINTER_OVERFLOW_OVERWRITE, records are retained until flushing */
+	bool overwrite;
+	bool flushing;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	
+	/* XLOG_PRINTER_OPERTHREAD, rings of producers created on first use, registered under mutex */
+	bool perthread;
+	bool ordered;			/* XLOG_PRINTER_OORDERED, merged by timestamp */
+	int parked;				/* consumer sleeping on cond, producers signal only if set */
+	size_t capacity;
+	int rb_options;
+	unsigned int timeout_ms;
+	pthread_key_t thread_key;
+	struct __printer_thread_ring *thread_rings;
+	uint64_t reclaimed_dropped_records;	/* dropped by rings reclaimed */
+	uint64_t reclaimed_dropped_bytes;
+	#if (defined XLOG_FEATURE_ENABLE_STATS) && (defined XLOG_FEATURE_ENABLE_STATS_PRINTER)
+	xlog_stats_t stats;
+	#endif
 };
 
+/** write all of iovecs, shared by printers of files and stdio */
+ssize_t xlog_printer_writev( int fd, const struct iovec *iov, int iovcnt )
+{
+	struct iovec vector[XLOG_LIMIT_PRINTER_BATCH];
+	XLOG_ASSERT( iovcnt <= XLOG_LIMIT_PRINTER_BATCH );
+	memcpy( vector, iov, sizeof( struct iovec ) * iovcnt );
+	
+	ssize_t total = 0;
+	struct iovec *cursor = vector;
+	while( iovcnt > 0 ) {
+		ssize_t length = writev( fd, cursor, iovcnt );
+		if( length < 0 ) {
+			if( errno == EINTR ) {
+				continue;
+			}
+			__XLOG_TRACE( "Failed to write, 'cause %s.", strerror( errno ) );
+			return total > 0 ? total : -1;
+		}
+		total += length;
+		/* NOTE: partial writing, skip what have been written */
+		while( iovcnt > 0 && ( size_t )length >= cursor->iov_len ) {
+			length -= cursor->iov_len;
+			cursor ++;
+			iovcnt --;
+		}
+		if( iovcnt > 0 ) {
+			cursor->iov_base = ( char * )cursor->iov_base + length;
+			cursor->iov_len -= length;
+		}
+	}
+	
+	return total;
+}
+
+/** write out bytes buffered, under mutex of coalescing buffer */
+static ssize_t __wbuf_flush( xlog_printer_wbuf_t *wbuf )
+{
+	ssize_t total = 0;
+	while( total < wbuf->length ) {
+		#ifndef XLOG_BENCH_NO_OUTPUT
+		ssize_t length = write( wbuf->fd, wbuf->data + total, wbuf->length - total );
+		#else
+		ssize_t length = wbuf->length - total;
+		#endif
+		if( length < 0 ) {
+			if( errno == EINTR ) {
+				continue;
+			}
+			__XLOG_TRACE( "Failed to flush, 'cause %s.", strerror( errno ) );
+			break;
+		}
+		total += length;
+	}
+	/* NOTE: bytes failed to write are dropped, as unbuffered printers do */
+	wbuf->length = 0;
+	
+	return total;
+}
+
+/** flush bytes buffered longer than latency_ms, sleeping while buffer is empty */
+static void *__wbuf_flusher( void *arg )
+{
+	xlog_printer_wbuf_t *wbuf = ( xlog_printer_wbuf_t * )arg;
+	pthread_mutex_lock( &wbuf->mutex );
+	while( !wbuf->exiting ) {
+		if( wbuf->length == 0 ) {
+			wbuf->idle = true;
+			pthread_cond_wait( &wbuf->cond, &wbuf->mutex );
+			wbuf->idle = false;
+			continue;
+		}
+		/* NOTE: buffer may be flushed and refilled while waiting, deadline checked again */
+		pthread_cond_timedwait( &wbuf->cond, &wbuf->mutex, &wbuf->deadline );
+		struct timespec now;
+		clock_gettime( CLOCK_REALTIME, &now );
+		if(
+			wbuf->length > 0
+			&& ( now.tv_sec > wbuf->deadline.tv_sec || ( now.tv_sec == wbuf->deadline.tv_sec && now.tv_nsec >= wbuf->deadline.tv_nsec ) )
+		) {
+			__wbuf_flush( wbuf );
+		}
+	}
+	pthread_mutex_unlock( &wbuf->mutex );
+	
+	return NULL;
+}
+
+xlog_printer_wbuf_t *xlog_printer_wbuf_create( size_t size, unsigned int latency_ms )
+{
+	xlog_printer_wbuf_t *wbuf = ( xlog_printer_wbuf_t * )XLOG_MALLOC( sizeof( xlog_printer_wbuf_t ) );
+	if( wbuf == NULL ) {
+		return NULL;
+	}
+	memset( wbuf, 0, sizeof( xlog_printer_wbuf_t ) );
+	wbuf->size = size;
+	wbuf->latency_ms = latency_ms;
+	wbuf->fd = -1;
+	wbuf->data = ( char * )XLOG_MALLOC( wbuf->size );
+	if( wbuf->data == NULL ) {
+		XLOG_FREE( wbuf );
+		return NULL;
+	}
+	pthread_mutex_init( &wbuf->mutex, NULL );
+	pthread_cond_init( &wbuf->cond, NULL );
+	if( latency_ms && pthread_create( &wbuf->flusher, NULL, __wbuf_flusher, wbuf ) != 0 ) {
+		__XLOG_TRACE( "Failed to create flusher, 'cause %s.", strerror( errno ) );
+		pthread_cond_destroy( &wbuf->cond );
+		pthread_mutex_destroy( &wbuf->mutex );
+		XLOG_FREE( wbuf->data );
+		XLOG_FREE( wbuf );
+		return NULL;
+	}
+	
+	return wbuf;
+}
+
+void xlog_printer_wbuf_destory( xlog_printer_wbuf_t *wbuf )
+{
+	if( wbuf == NULL ) {
+		return;
+	}
+	if( wbuf->latency_ms ) {
+		pthread_mutex_lock( &wbuf->mutex );
+		wbuf->exiting = true;
+		pthread_cond_signal( &wbuf->cond );
+		pthread_mutex_unlock( &wbuf->mutex );
+		pthread_join( wbuf->flusher, NULL );
+	}
+	__wbuf_flush( wbuf );
+	pthread_cond_destroy( &wbuf->cond );
+	pthread_mutex_destroy( &wbuf->mutex );
+	XLOG_FREE( wbuf->data );
+	XLOG_FREE( wbuf );
+}
+
+ssize_t xlog_printer_wbuf_appendv( xlog_printer_wbuf_t *wbuf, int fd, const struct iovec *iov, int iovcnt )
+{
+	size_t total = 0;
+	for( int i = 0; i < iovcnt; i ++ ) {
+		total += iov[i].iov_len;
+	}
+	
+	pthread_mutex_lock( &wbuf->mutex );
+	if( wbuf->length > 0 && ( wbuf->fd != fd || wbuf->length + total > wbuf->size ) ) {
+		__wbuf_flush( wbuf );
+	}
+	wbuf->fd = fd;
+	ssize_t written = total;
+	if( total >= wbuf->size ) {
+		/* NOTE: NOT fit in buffer, written through without copying */
+		#ifndef XLOG_BENCH_NO_OUTPUT
+		written = xlog_printer_writev( fd, iov, iovcnt );
+		#endif
+	} else if( total > 0 ) {
+		if( wbuf->length == 0 && wbuf->latency_ms ) {
+			clock_gettime( CLOCK_REALTIME, &wbuf->deadline );
+			wbuf->deadline.tv_sec += wbuf->latency_ms / 1000;
+			wbuf->deadline.tv_nsec += ( wbuf->latency_ms % 1000 ) * 1000000L;
+			if( wbuf->deadline.tv_nsec >= 1000000000L ) {
+				wbuf->deadline.tv_sec ++;
+				wbuf->deadline.tv_nsec -= 1000000000L;
+			}
+			if( wbuf->idle ) {
+				pthread_cond_signal( &wbuf->cond );
+			}
+		}
+		for( int i = 0; i < iovcnt; i ++ ) {
+			memcpy( wbuf->data + wbuf->length, iov[i].iov_base, iov[i].iov_len );
+			wbuf->length += iov[i].iov_len;
+		}
+	}
+	pthread_mutex_unlock( &wbuf->mutex );
+	
+	return written;
+}
+
+ssize_t xlog_printer_wbuf_append( xlog_printer_wbuf_t *wbuf, int fd, const char *text, size_t length )
+{
+	struct iovec iov = {
+		.iov_base = ( void * )text,
+		.iov_len = length,
+	};
+	
+	return xlog_printer_wbuf_appendv( wbuf, fd, &iov, 1 );
+}
+
+int xlog_printer_wbuf_flush( xlog_printer_wbuf_t *wbuf )
+{
+	pthread_mutex_lock( &wbuf->mutex );
+	__wbuf_flush( wbuf );
+	pthread_mutex_unlock( &wbuf->mutex );
+	
+	return 0;
+}
+
+/** producer thread exited, its ring is reclaimed by consumer after drained */
+static void __printer_thread_ring_exit( void *arg )
+{
+	struct __printer_thread_ring *ring = ( struct __printer_thread_ring * )arg;
+	__atomic_store_n( &ring->exited, true, __ATOMIC_RELEASE );
+}
+
+/** ring-buffer of calling thread, created and registered on first use if XLOG_PRINTER_OPERTHREAD */
+static ringbuf_t *__printer_ringbuf_acquire( struct __printer_ringbuf_context *bufctx )
+{
+	if( !bufctx->perthread ) {
+		return bufctx->rbuff;
+	}
+	struct __printer_thread_ring *ring = ( struct __printer_thread_ring * )pthread_getspecific( bufctx->thread_key );
+	if( ring ) {
+		return ring->rbuff;
+	}
+	ring = ( struct __printer_thread_ring * )XLOG_MALLOC( sizeof( struct __printer_thread_ring ) );
+	if( ring == NULL ) {
+		__XLOG_TRACE( "Failed to create ring of thread." );
+		return NULL;
+	}
+	ring->rbuff = ringbuf_create_ex( bufctx->capacity, bufctx->rb_options );
+	if( ring->rbuff == NULL ) {
+		__XLOG_TRACE( "Failed to create ring-buffer of thread." );
+		XLOG_FREE( ring );
+		return NULL;
+	}
+	ringbuf_set_timeout( ring->rbuff, bufctx->timeout_ms );
+	
+	/* NOTE: consumer walks the list without lock, ring is published completely */
+	pthread_mutex_lock( &bufctx->mutex );
+	ring->next = bufctx->thread_rings;
+	__atomic_store_n( &bufctx->thread_rings, ring, __ATOMIC_RELEASE );
+	pthread_mutex_unlock( &bufctx->mutex );
+	pthread_setspecific( bufctx->thread_key, ring );
+	
+	return ring->rbuff;
+}
+
+/** wake up consumer parked for rings of producer threads */
+static void __printer_ringbuf_notify( struct __printer_ringbuf_context *bufctx )
+{
+	if( !bufctx->perthread ) {
+		return;
+	}
+	/* NOTE: pairs with the fence in __printer_ringbuf_wait, either consumer sees the record or producer sees it parked */
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+	if( __atomic_load_n( &bufctx->parked, __ATOMIC_RELAXED ) ) {
+		pthread_mutex_lock( &bufctx->mutex );
+		pthread_cond_broadcast( &bufctx->cond );
+		pthread_mutex_unlock( &bufctx->mutex );
+	}
+}
+
+/** check if there is any record in rings of producer threads */
+static bool __printer_ringbuf_has_data( struct __printer_ringbuf_context *context )
+{
+	ringbuf_record_t header;
+	for( struct __printer_thread_ring *ring = __atomic_load_n( &context->thread_rings, __ATOMIC_ACQUIRE ); ring; ring = ring->next ) {
+		if( ringbuf_peek_record( ring->rbuff, &header ) == 0 ) {
+			return true;
+		}
+	}
+	
+	return false;
+}
+
+/** reclaim rings of producer threads exited and drained, called by consumer only */
+static void __printer_ringbuf_reclaim( struct __printer_ringbuf_context *context )
+{
+	pthread_mutex_lock( &context->mutex );
+	struct __printer_thread_ring **link = &context->thread_rings;
+	while( *link ) {
+		struct __printer_thread_ring *ring = *link;
+		ringbuf_record_t header;
+		if( __atomic_load_n( &ring->exited, __ATOMIC_ACQUIRE ) && ringbuf_peek_record( ring->rbuff, &header ) == EAGAIN ) {
+			__XLOG_TRACE( "Ring of thread exited is reclaimed." );
+			uint64_t records = 0, bytes = 0;
+			ringbuf_dropped( ring->rbuff, &records, &bytes );
+			context->reclaimed_dropped_records += records;
+			context->reclaimed_dropped_bytes += bytes;
+			__atomic_store_n( link, ring->next, __ATOMIC_RELEASE );
+			ringbuf_destory( ring->rbuff );
+			XLOG_FREE( ring );
+		} else {
+			link = &ring->next;
+		}
+	}
+	pthread_mutex_unlock( &context->mutex );
+}
+
+/** wait for records in ring-buffer shared, or in any ring of producer threads */
+static void __printer_ringbuf_wait( struct __printer_ringbuf_context *context )
+{
+	if( !context->perthread ) {
+		ringbuf_wait( context->rbuff, 0 );
+		return;
+	}
+	__printer_ringbuf_reclaim( context );
+	for( int i = 0; i < XLOG_LIMIT_PRINTER_WAIT_YIELDS; i ++ ) {
+		if( __printer_ringbuf_has_data( context ) ) {
+			return;
+		}
+		sched_yield();
+	}
+	pthread_mutex_lock( &context->mutex );
+	__atomic_store_n( &context->parked, 1, __ATOMIC_RELAXED );
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+	while( !__atomic_load_n( &context->force_exit, __ATOMIC_ACQUIRE ) && !__printer_ringbuf_has_data( context ) ) {
+		pthread_cond_wait( &context->cond, &context->mutex );
+	}
+	__atomic_store_n( &context->parked, 0, __ATOMIC_RELAXED );
+	pthread_mutex_unlock( &context->mutex );
+}
+
+/** drain whole records into buffer, the oldest first among rings if merged, return length of text */
+static int __printer_ringbuf_drain_text( struct __printer_ringbuf_context *context, ringbuf_t *rbuff, char *buffer, int size )
+{
+	int length = 0;
+	while( true ) {
+		ringbuf_record_t header;
+		ringbuf_t *oldest = NULL;
+		if( rbuff ) {
+			oldest = ringbuf_peek_record( rbuff, &header ) == 0 ? rbuff : NULL;
+		} else {
+			ringbuf_record_t candidate;
+			for( struct __printer_thread_ring *ring = __atomic_load_n( &context->thread_rings, __ATOMIC_ACQUIRE ); ring; ring = ring->next ) {
+				if( ringbuf_peek_record( ring->rbuff, &candidate ) == 0 && ( oldest == NULL || candidate.timestamp < header.timestamp ) ) {
+					oldest = ring->rbuff;
+					header = candidate;
+				}
+			}
+		}
+		if( oldest == NULL ) {
+			break;
+		}
+		if( length + header.length > size - 1 ) {
+			if( length == 0 ) {
+				/* NOTE: record larger than buffer, printed in chunks */
+				length = ringbuf_copy_from( oldest, buffer, size - 1, true );
+			}
+			break;
+		}
+		/* NOTE: record peeked may be evicted by producers meanwhile, length of the one read counted */
+		int room = size - 1 - length;
+		if( ringbuf_read_record( oldest, &header, buffer + length, room ) != 0 ) {
+			break;
+		}
+		length += header.length < ( unsigned int )room ? ( int )header.length : room;
+	}
+	buffer[length] = '\0';
+	
+	return length;
+}
+
+/** print batch of autobufs drained from ring-buffer, one writev if printer supports */
+static void __printer_ringbuf_print_batch( xlog_printer_t *printer, autobuf_t **batch, int count )
+{
+	if( printer->appendv ) {
+		struct iovec iov[XLOG_LIMIT_PRINTER_BATCH];
+		for( int i = 0; i < count; i ++ ) {
+			iov[i].iov_base = autobuf_data_vptr( batch[i] );
+			iov[i].iov_len = batch[i]->offset;
+		}
+		printer->appendv( printer, iov, count );
+	} else {
+		for( int i = 0; i < count; i ++ ) {
+			_xlog_printer_print_TEXT( batch[i], printer );
+		}
+	}
+	for( int i = 0; i < count; i ++ ) {
+		autobuf_destory( &batch[i] );
+	}
+}
+
 static void *__printer_ringbuf_consumer( void *arg )
 {
 	assert( arg );
 	struct __printer_ringbuf_context *context = ( struct __printer_ringbuf_context * )arg;
-	autobuf_t *autobuf = NULL;
+	autobuf_t *batch[XLOG_LIMIT_PRINTER_BATCH];
+	autobuf_t *text = NULL;
+	char buffer[2048];
+	union {
+		xlog_deferred_record_t header;
+		char data[XLOG_LIMIT_DEFERRED_RECORD];
+	} record;
 	bool idle_show = false;
 	while( true ) {
-		int length = ringbuf_copy_from( context->rbuff , &autobuf, sizeof( autobuf_t * ), true );
+		if( context->overwrite ) {
+			pthread_mutex_lock( &context->mutex );
+			while( !context->flushing && !__atomic_load_n( &context->force_exit, __ATOMIC_ACQUIRE ) ) {
+				pthread_cond_wait( &context->cond, &context->mutex );
+			}
+			pthread_mutex_unlock( &context->mutex );
+		}
+		/* NOTE: check exit flag before reading, or records appended right before exiting are lost */
+		bool force_exit = __atomic_load_n( &context->force_exit, __ATOMIC_ACQUIRE );
+		int length = 0;
+		if( context->buff_type == XLOG_PRINTER_BUFF_NCPYRBUF ) {
+			/* NOTE: drain all pointers available, printed in one batch */
+			length = ringbuf_copy_from( context->rbuff , batch, sizeof( batch ), true );
+			if( length > 0 ) {
+				XLOG_ASSERT( length % sizeof( autobuf_t * ) == 0 );
+				__printer_ringbuf_print_batch( context->printer, batch, length / sizeof( autobuf_t * ) );
+			}
+		} else if( context->buff_type == XLOG_PRINTER_BUFF_DEFERRED ) {
+			/* NOTE: records are copied into ring-buffer as a whole, read header and then the rest */
+			length = ringbuf_copy_from( context->rbuff , &record.header, sizeof( xlog_deferred_record_t ), true );
+			if( length > 0 ) {
+				XLOG_ASSERT( length == sizeof( xlog_deferred_record_t ) );
+				XLOG_ASSERT( record.header.size >= length && record.header.size <= sizeof( record ) );
+				if( record.header.size > length ) {
+					length += ringbuf_copy_from( context->rbuff , record.data + length, record.header.size - length, false );
+				}
+				if( text == NULL ) {
+					text = autobuf_create(
+						XLOG_PAYLOAD_ID_AUTO, "Deferred",
+						AUTOBUF_ODYNAMIC | AUTOBUF_OALIGN | AUTOBUF_OTEXT, 240, 64
+					);
+				}
+				if( text ) {
+					text->offset = 0;
+					*( char * )autobuf_data_vptr( text ) = '\0';
+					xlog_deferred_render( &record.header, xlog_printer_abiclr( context->printer ), &text );
+					/* NOTE: time of raw records is zero if unknown */
+					bool known = !( record.header.flags & XLOG_DEFERRED_ORAW ) || record.header.ts.tv_sec || record.header.ts.tv_nsec;
+					xlog_printer_append(
+						context->printer, autobuf_data_vptr( text ), text->offset,
+						record.header.level, known ? &record.header.ts : NULL
+					);
+				} else {
+					__XLOG_TRACE( "Failed to create autobuf, record dropped." );
+				}
+			}
+		} else if( context->perthread && context->ordered ) {
+			/* NOTE: records of all threads merged by timestamp */
+			length = __printer_ringbuf_drain_text( context, NULL, buffer, sizeof( buffer ) );
+			if( length > 0 ) {
+				xlog_printer_append( context->printer, buffer, length, XLOG_LEVEL_SILENT, NULL );
+			}
+		} else if( context->perthread ) {
+			/* NOTE: rings of threads drained round-robin, one buffer each */
+			for( struct __printer_thread_ring *ring = __atomic_load_n( &context->thread_rings, __ATOMIC_ACQUIRE ); ring; ring = ring->next ) {
+				int drained = __printer_ringbuf_drain_text( context, ring->rbuff, buffer, sizeof( buffer ) );
+				if( drained > 0 ) {
+					xlog_printer_append( context->printer, buffer, drained, XLOG_LEVEL_SILENT, NULL );
+					length += drained;
+				}
+			}
+		} else if( context->rbuff->options & ( RINGBUF_OLOCKFREE | RINGBUF_OFRAMED ) ) {
+			/* NOTE: whole records drained into buffer, never split between appending unless larger than buffer */
+			length = __printer_ringbuf_drain_text( context, context->rbuff, buffer, sizeof( buffer ) );
+			if( length > 0 ) {
+				xlog_printer_append( context->printer, buffer, length, XLOG_LEVEL_SILENT, NULL );
+			}
+		} else {
+			/* NOTE: records are copied as text, print it in chunks */
+			length = ringbuf_copy_from( context->rbuff , buffer, sizeof( buffer ) - 1, true );
+			if( length > 0 ) {
+				buffer[length] = '\0';
+				xlog_printer_append( context->printer, buffer, length, XLOG_LEVEL_SILENT, NULL );
+			}
+		}
 		if( length > 0 ) {
 			__XLOG_TRACE( "consumer-READ: length = %d\n", length );
-			_xlog_printer_print_TEXT( autobuf, context->printer );
-			autobuf_destory( &autobuf );
 			idle_show = true;
-		} else if( context->force_exit ) {
+		} else if( force_exit ) {
 			__XLOG_TRACE( "Force exit." );
+			autobuf_destory( &text );
 			return NULL;
+		} else if( context->overwrite ) {
+			__XLOG_TRACE( "Flushed, wait for next flushing." );
+			pthread_mutex_lock( &context->mutex );
+			context->flushing = false;
+			pthread_cond_broadcast( &context->cond );
+			pthread_mutex_unlock( &context->mutex );
 		} else {
 			if( idle_show ) {
 				__XLOG_TRACE( "Consumer IDLE." );
 				idle_show = false;
 			}
+			__printer_ringbuf_wait( context );
 		}
 	}
 	
@@ -99,26 +585,57 @@ static void *__printer_ringbuf_consumer( void *arg )
 	return NULL;
 }
 
-static struct __printer_ringbuf_context *__buffering_context_create_ringbuf( size_t capacity, xlog_printer_t *printer )
+static struct __printer_ringbuf_context *__buffering_context_create_ringbuf(
+	int buff_type, int options, size_t capacity, int rb_options, unsigned int timeout_ms, bool overwrite, xlog_printer_t *printer
+)
 {
 	XLOG_ASSERT( printer );
 	XLOG_ASSERT( capacity > 0 );
 	struct __printer_ringbuf_context *bufctx = ( struct __printer_ringbuf_context * )XLOG_MALLOC( sizeof( struct __printer_ringbuf_context ) );
 	if( bufctx ) {
-		bufctx->rbuff = ringbuf_create( capacity );
-		if( bufctx->rbuff == NULL ) {
-			XLOG_FREE( bufctx );
-			__XLOG_TRACE( "Failed to create ring-bufffer" );
-			return NULL;
+		bufctx->force_exit = false;
+		bufctx->buff_type = buff_type;
+		bufctx->printer = printer;
+		bufctx->overwrite = overwrite;
+		bufctx->flushing = false;
+		bufctx->perthread = buff_type == XLOG_PRINTER_BUFF_RINGBUF && ( options & ( XLOG_PRINTER_OPERTHREAD | XLOG_PRINTER_OORDERED ) );
+		bufctx->ordered = bufctx->perthread && ( options & XLOG_PRINTER_OORDERED );
+		bufctx->capacity = capacity;
+		bufctx->rb_options = rb_options;
+		bufctx->timeout_ms = timeout_ms;
+		if( bufctx->perthread ) {
+			/* NOTE: a single producer per ring, reserved by CAS without contention */
+			bufctx->rb_options |= RINGBUF_OLOCKFREE | ( bufctx->ordered ? RINGBUF_OFRAMED : 0 );
+			if( pthread_key_create( &bufctx->thread_key, __printer_thread_ring_exit ) != 0 ) {
+				XLOG_FREE( bufctx );
+				__XLOG_TRACE( "Failed to create key of thread rings." );
+				return NULL;
+			}
+		} else {
+			bufctx->rbuff = ringbuf_create_ex( capacity, rb_options );
+			if( bufctx->rbuff == NULL ) {
+				XLOG_FREE( bufctx );
+				__XLOG_TRACE( "Failed to create ring-bufffer" );
+				return NULL;
+			}
+			ringbuf_set_timeout( bufctx->rbuff, timeout_ms );
 		}
+		pthread_mutex_init( &bufctx->mutex, NULL );
+		pthread_cond_init( &bufctx->cond, NULL );
+		XLOG_STATS_INIT( &bufctx->stats, XLOG_STATS_PRINTER_OPTION );
 		if( pthread_create( &bufctx->thread_consumer, NULL, __printer_ringbuf_consumer, bufctx ) != 0 ) {
 			__XLOG_TRACE( "Failed to start ringbuf consumer thread." );
+			XLOG_STATS_FINI( &bufctx->stats );
+			pthread_cond_destroy( &bufctx->cond );
+			pthread_mutex_destroy( &bufctx->mutex );
+			if( bufctx->perthread ) {
+				pthread_key_delete( bufctx->thread_key );
+			}
 			ringbuf_destory( bufctx->rbuff );
 			XLOG_FREE( bufctx );
 			
 			return NULL;
 		}
-		bufctx->printer = printer;
 	}
 	
 	return bufctx;
@@ -127,10 +644,27 @@ static struct __printer_ringbuf_context *__buffering_context_create_ringbuf( siz
 static int __buffering_context_destory_ringbuf( struct __printer_ringbuf_context *bufctx )
 {
 	assert( bufctx );
-	pthread_mutex_lock( &bufctx->rbuff->mutex );
-	bufctx->force_exit = true;
-	pthread_mutex_unlock( &bufctx->rbuff->mutex );
+	__atomic_store_n( &bufctx->force_exit, true, __ATOMIC_RELEASE );
+	pthread_mutex_lock( &bufctx->mutex );
+	pthread_cond_broadcast( &bufctx->cond );
+	pthread_mutex_unlock( &bufctx->mutex );
+	if( bufctx->rbuff ) {
+		ringbuf_wakeup( bufctx->rbuff );
+	}
 	pthread_join( bufctx->thread_consumer, NULL );
+	if( bufctx->perthread ) {
+		/* NOTE: destructors are NOT called after deleting key, rings of threads alive are released here */
+		pthread_key_delete( bufctx->thread_key );
+		while( bufctx->thread_rings ) {
+			struct __printer_thread_ring *ring = bufctx->thread_rings;
+			bufctx->thread_rings = ring->next;
+			ringbuf_destory( ring->rbuff );
+			XLOG_FREE( ring );
+		}
+	}
+	XLOG_STATS_FINI( &bufctx->stats );
+	pthread_cond_destroy( &bufctx->cond );
+	pthread_mutex_destroy( &bufctx->mutex );
 	ringbuf_destory( bufctx->rbuff );
 	bufctx->rbuff = NULL;
 	XLOG_FREE( bufctx );
@@ -138,6 +672,76 @@ static int __buffering_context_destory_ringbuf( struct __printer_ringbuf_context
 	return 0;
 }
 
+static int __buffering_printer_append( xlog_printer_t *printer, void *data );
+
+static int __buffering_printer_appendl( xlog_printer_t *printer, const void *data, size_t length, int level, const struct timespec *ts )
+{
+	int buff_type = XLOG_PRINTER_BUFF_GET( printer->options );
+	switch( buff_type ) {
+		case XLOG_PRINTER_BUFF_NCPYRBUF: {
+			__XLOG_TRACE( "No-Copy ring-buffer appending, copied into payload" );
+			autobuf_t *payload = autobuf_create( XLOG_PAYLOAD_ID_AUTO, "Log", AUTOBUF_ODYNAMIC | AUTOBUF_OALIGN | AUTOBUF_OTEXT, length + 1, 64 );
+			if( payload == NULL || autobuf_append_text_n( &payload, ( const char * )data, length ) != 0 ) {
+				autobuf_destory( &payload );
+				return 0;
+			}
+			int _len = __buffering_printer_append( printer, &payload );
+			autobuf_destory( &payload );
+			return _len;
+		} break;
+		case XLOG_PRINTER_BUFF_RINGBUF: {
+			__XLOG_TRACE( "Ring-buffer appending" );
+			struct __printer_ringbuf_context *bufctx = ( struct __printer_ringbuf_context * )printer->context;
+			XLOG_STATS_UPDATE( &bufctx->stats, REQUEST, INPUT, 1 );
+			XLOG_STATS_UPDATE( &bufctx->stats, BYTE, INPUT, length );
+			ringbuf_t *rbuff = __printer_ringbuf_acquire( bufctx );
+			if( rbuff == NULL || ringbuf_copy_into( rbuff, data, length ) != 0 ) {
+				__XLOG_TRACE( "Dropped by overflow policy." );
+				return 0;
+			}
+			__printer_ringbuf_notify( bufctx );
+			
+			return length;
+		} break;
+		case XLOG_PRINTER_BUFF_DEFERRED: {
+			__XLOG_TRACE( "Deferred ring-buffer appending, wrapped as raw records" );
+			struct __printer_ringbuf_context *bufctx = ( struct __printer_ringbuf_context * )printer->context;
+			const char *_ptr = ( const char * )data;
+			union {
+				xlog_deferred_record_t header;
+				char data[XLOG_LIMIT_DEFERRED_RECORD];
+			} record;
+			memset( &record.header, 0, sizeof( xlog_deferred_record_t ) );
+			record.header.flags = XLOG_DEFERRED_ORAW;
+			record.header.level = level;
+			if( ts ) {
+				record.header.ts = *ts;
+			}
+			XLOG_STATS_UPDATE( &bufctx->stats, REQUEST, INPUT, 1 );
+			XLOG_STATS_UPDATE( &bufctx->stats, BYTE, INPUT, length );
+			if( length > sizeof( record ) - sizeof( xlog_deferred_record_t ) ) {
+				/* NOTE: too large to be read back as a whole, written through so it's never split or interleaved */
+				__XLOG_TRACE( "Raw record too large, written through." );
+				return xlog_printer_append( bufctx->printer, _ptr, length, level, ts );
+			}
+			memcpy( record.data + sizeof( xlog_deferred_record_t ), _ptr, length );
+			record.header.size = sizeof( xlog_deferred_record_t ) + length;
+			/* NOTE: one reservation if lock-free, or one holding of mutex, for the whole record */
+			if( ringbuf_copy_into( bufctx->rbuff, &record, record.header.size ) != 0 ) {
+				__XLOG_TRACE( "Dropped by overflow policy." );
+				return 0;
+			}
+			
+			return length;
+		} break;
+		default: {
+			XLOG_ASSERT( 0 );
+		} break;
+	}
+	
+	return 0;
+}
+
 static int __buffering_printer_append( xlog_printer_t *printer, void *data )
 {
 	int buff_type = XLOG_PRINTER_BUFF_GET( printer->options );
@@ -151,19 +755,19 @@ static int __buffering_printer_append( xlog_printer_t *printer, void *data )
 		case XLOG_PRINTER_BUFF_NCPYRBUF: {
 			__XLOG_TRACE( "No-Copy ring-buffer appending" );
 			struct __printer_ringbuf_context *bufctx = ( struct __printer_ringbuf_context * )printer->context;
-			ringbuf_copy_into( bufctx->rbuff, payload, sizeof( autobuf_t * ) );
 			int length = (*payload)->offset;
+			XLOG_STATS_UPDATE( &bufctx->stats, REQUEST, INPUT, 1 );
+			XLOG_STATS_UPDATE( &bufctx->stats, BYTE, INPUT, length );
+			if( ringbuf_copy_into( bufctx->rbuff, payload, sizeof( autobuf_t * ) ) != 0 ) {
+				__XLOG_TRACE( "Dropped by overflow policy, payload released by caller." );
+				return 0;
+			}
 			*payload = NULL;
 			return length;
 		} break;
-		case XLOG_PRINTER_BUFF_RINGBUF: {
-			__XLOG_TRACE( "Ring-buffer appending" );
-			struct __printer_ringbuf_context *bufctx = ( struct __printer_ringbuf_context * )printer->context;
-			void *_ptr = autobuf_data_vptr( *payload );
-			size_t _len = (*payload)->offset;
-			ringbuf_copy_into( bufctx->rbuff, _ptr, _len );
-			
-			return _len;
+		case XLOG_PRINTER_BUFF_RINGBUF:
+		case XLOG_PRINTER_BUFF_DEFERRED: {
+			return __buffering_printer_appendl( printer, autobuf_data_vptr( *payload ), (*payload)->offset, XLOG_LEVEL_SILENT, NULL );
 		} break;
 		default: {
 			XLOG_ASSERT( 0 );
@@ -173,22 +777,131 @@ static int __buffering_printer_append( xlog_printer_t *printer, void *data )
 	return 0;
 }
 
+/** ability of colorful output, queried on first use if NOT cached, e.g. printers defined by user */
+int xlog_printer_abiclr( xlog_printer_t *printer )
+{
+	int abiclr = __atomic_load_n( &printer->abiclr, __ATOMIC_RELAXED );
+	if( !( abiclr & XLOG_PRINTER_ABICLR_KNOWN ) ) {
+		int optval = 0;
+		if(
+			printer->optctl == NULL
+			|| printer->optctl( printer, XLOG_PRINTER_CTRL_GABICLR, &optval, sizeof( int ) ) != 0
+		) {
+			optval = 0;
+		}
+		/* NOTE: racing queries store the same answer */
+		abiclr = XLOG_PRINTER_ABICLR_KNOWN | ( optval ? XLOG_PRINTER_ABICLR_YES : 0 );
+		__atomic_store_n( &printer->abiclr, abiclr, __ATOMIC_RELAXED );
+	}
+	
+	return abiclr & XLOG_PRINTER_ABICLR_YES;
+}
+
+/** append deferred record, formatted by consumer */
+int xlog_printer_append_deferred( xlog_printer_t *printer, const xlog_deferred_record_t *record )
+{
+	XLOG_ASSERT( XLOG_PRINTER_BUFF_GET( printer->options ) == XLOG_PRINTER_BUFF_DEFERRED );
+	struct __printer_ringbuf_context *bufctx = ( struct __printer_ringbuf_context * )printer->context;
+	XLOG_STATS_UPDATE( &bufctx->stats, REQUEST, INPUT, 1 );
+	XLOG_STATS_UPDATE( &bufctx->stats, BYTE, INPUT, record->size );
+	
+	return ringbuf_copy_into( bufctx->rbuff, record, record->size );
+}
+
+/** reserve text in ring-buffer, only if lock-free, or producers are serialized while formatting */
+int xlog_printer_reserve_text( xlog_printer_t *printer, size_t size, char **text )
+{
+	XLOG_ASSERT( printer && text );
+	*text = NULL;
+	if( XLOG_PRINTER_BUFF_GET( printer->options ) != XLOG_PRINTER_BUFF_RINGBUF ) {
+		return ENOTSUP;
+	}
+	struct __printer_ringbuf_context *bufctx = ( struct __printer_ringbuf_context * )printer->context;
+	ringbuf_t *rbuff = __printer_ringbuf_acquire( bufctx );
+	if( rbuff == NULL || !( rbuff->options & RINGBUF_OLOCKFREE ) ) {
+		return ENOTSUP;
+	}
+	int error = ringbuf_reserve( rbuff, size, ( void ** )text );
+	if( error == EAGAIN || error == ETIMEDOUT ) {
+		XLOG_STATS_UPDATE( &bufctx->stats, REQUEST, INPUT, 1 );
+	}
+	
+	return error;
+}
+
+/** commit text formatted in place */
+int xlog_printer_commit_text( xlog_printer_t *printer, char *text, size_t length, int level )
+{
+	XLOG_ASSERT( XLOG_PRINTER_BUFF_GET( printer->options ) == XLOG_PRINTER_BUFF_RINGBUF );
+	struct __printer_ringbuf_context *bufctx = ( struct __printer_ringbuf_context * )printer->context;
+	if( length > 0 ) {
+		XLOG_STATS_UPDATE( &bufctx->stats, REQUEST, INPUT, 1 );
+		XLOG_STATS_UPDATE( &bufctx->stats, BYTE, INPUT, length );
+	}
+	
+	ringbuf_commit_record( __printer_ringbuf_acquire( bufctx ), text, length, level );
+	__printer_ringbuf_notify( bufctx );
+	
+	return 0;
+}
+
 static int __buffering_printer_optctl( xlog_printer_t *printer, int option, void *vptr, size_t size )
 {
 	XLOG_ASSERT( printer );
 	struct __printer_ringbuf_context *bufctx = ( struct __printer_ringbuf_context * )printer->context;
+	if( bufctx && option == XLOG_PRINTER_CTRL_GSTATS ) {
+		#if (defined XLOG_FEATURE_ENABLE_STATS) && (defined XLOG_FEATURE_ENABLE_STATS_PRINTER)
+		if( vptr == NULL || size != sizeof( xlog_stats_t * ) ) {
+			return EINVAL;
+		}
+		uint64_t records = 0, bytes = 0;
+		if( bufctx->perthread ) {
+			pthread_mutex_lock( &bufctx->mutex );
+			records = bufctx->reclaimed_dropped_records;
+			bytes = bufctx->reclaimed_dropped_bytes;
+			for( struct __printer_thread_ring *ring = bufctx->thread_rings; ring; ring = ring->next ) {
+				uint64_t ring_records = 0, ring_bytes = 0;
+				ringbuf_dropped( ring->rbuff, &ring_records, &ring_bytes );
+				records += ring_records;
+				bytes += ring_bytes;
+			}
+			pthread_mutex_unlock( &bufctx->mutex );
+		} else {
+			ringbuf_dropped( bufctx->rbuff, &records, &bytes );
+		}
+		XLOG_STATS_CLEAR_FILED( &bufctx->stats, REQUEST, DROPPED, records );
+		XLOG_STATS_CLEAR_FILED( &bufctx->stats, BYTE, DROPPED, bytes );
+		*( xlog_stats_t ** )vptr = &bufctx->stats;
+		
+		return 0;
+		#else
+		return ENOTSUP;
+		#endif
+	}
+	if( bufctx && bufctx->overwrite && option == XLOG_PRINTER_CTRL_FLUSH ) {
+		__XLOG_TRACE( "Write out records of flight recorder." );
+		pthread_mutex_lock( &bufctx->mutex );
+		bufctx->flushing = true;
+		pthread_cond_broadcast( &bufctx->cond );
+		while( bufctx->flushing ) {
+			pthread_cond_wait( &bufctx->cond, &bufctx->mutex );
+		}
+		pthread_mutex_unlock( &bufctx->mutex );
+	}
 	if( bufctx && bufctx->printer && bufctx->printer->optctl ) {
-		return bufctx->printer->optctl( printer, option, vptr, size );
+		return bufctx->printer->optctl( bufctx->printer, option, vptr, size );
 	}
 	
 	return -1;
 }
 
-static xlog_printer_t *__buffering_printer_create( size_t capacity, xlog_printer_t *printer )
+static xlog_printer_t *__buffering_printer_create(
+	int buff_type, int options, size_t capacity, int rb_options, unsigned int timeout_ms, bool overwrite, xlog_printer_t *printer
+)
 {
 	xlog_printer_t *printer_ringbuf = XLOG_MALLOC( sizeof( xlog_printer_t ) );
 	if( printer_ringbuf ) {
-		struct __printer_ringbuf_context *bufctx = __buffering_context_create_ringbuf( capacity, printer );
+		struct __printer_ringbuf_context *bufctx = __buffering_context_create_ringbuf( buff_type, options, capacity, rb_options, timeout_ms, overwrite, printer );
 		if( bufctx == NULL ) {
 			__XLOG_TRACE( "Failed to create buffering context." );
 			XLOG_FREE( printer_ringbuf );
@@ -198,6 +911,8 @@ static xlog_printer_t *__buffering_printer_create( size_t capacity, xlog_printer
 		
 		printer_ringbuf->context = bufctx;
 		printer_ringbuf->append = __buffering_printer_append;
+		printer_ringbuf->appendv = NULL;
+		printer_ringbuf->appendl = __buffering_printer_appendl;
 		printer_ringbuf->optctl = __buffering_printer_optctl;
 		#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
 		printer_ringbuf->magic = XLOG_MAGIC_PRINTER;
@@ -220,6 +935,12 @@ XLOG_PUBLIC( xlog_printer_t * ) xlog_printer_create( int options, ... )
 	xlog_printer_t *printer = NULL;
 	int type = XLOG_PRINTER_TYPE_GET( options );
 	int buff_type = XLOG_PRINTER_BUFF_GET( options );
+	int rb_options = ( options & XLOG_PRINTER_OLOCKFREE ) ? RINGBUF_OLOCKFREE : 0;
+	rb_options |= ( options & XLOG_PRINTER_OHUGEPAGE ) ? RINGBUF_OHUGEPAGE : 0;
+	rb_options |= ( options & XLOG_PRINTER_OMLOCK ) ? RINGBUF_OMLOCK : 0;
+	/* NOTE: XLOG_PRINTER_OCOALESCE of file printers, default size if zero */
+	size_t coalesce_size = 0;
+	unsigned int latency_ms = 0;
 	__XLOG_TRACE( "options = 0x%X, type = %d, buffering = %d", options, type, buff_type );
 	
 	va_list ap;
@@ -233,21 +954,61 @@ XLOG_PUBLIC( xlog_printer_t * ) xlog_printer_create( int options, ... )
 		} break;
 		case XLOG_PRINTER_FILES_BASIC: {
 			const char *file = va_arg( ap, const char * );
-			printer = xlog_printer_create_basic_file( file );
+			if( options & XLOG_PRINTER_OCOALESCE ) {
+				coalesce_size = va_arg( ap, size_t );
+				latency_ms = va_arg( ap, unsigned int );
+				coalesce_size = coalesce_size ? coalesce_size : XLOG_LIMIT_PRINTER_COALESCE;
+			}
+			printer = xlog_printer_create_basic_file( file, coalesce_size, latency_ms );
 		} break;
 		case XLOG_PRINTER_FILES_ROTATING: {
 			const char *file = va_arg( ap, const char * );
 			size_t max_size_per_file = va_arg( ap, size_t );
 			size_t max_file_to_ratating = va_arg( ap, size_t );
-			printer = xlog_printer_create_rotating_file( file, max_size_per_file, max_file_to_ratating );
+			if( options & XLOG_PRINTER_OCOALESCE ) {
+				coalesce_size = va_arg( ap, size_t );
+				latency_ms = va_arg( ap, unsigned int );
+				coalesce_size = coalesce_size ? coalesce_size : XLOG_LIMIT_PRINTER_COALESCE;
+			}
+			printer = xlog_printer_create_rotating_file( file, max_size_per_file, max_file_to_ratating, coalesce_size, latency_ms );
 		} break;
 		case XLOG_PRINTER_FILES_DAILY: {
 			const char *file = va_arg( ap, const char * );
-			printer = xlog_printer_create_daily_file( file );
+			unsigned int rollover_sec = ( options & XLOG_PRINTER_OROLLOVER ) ? va_arg( ap, unsigned int ) : XLOG_PRINTER_ROLLOVER_DAILY;
+			if( options & XLOG_PRINTER_OCOALESCE ) {
+				coalesce_size = va_arg( ap, size_t );
+				latency_ms = va_arg( ap, unsigned int );
+				coalesce_size = coalesce_size ? coalesce_size : XLOG_LIMIT_PRINTER_COALESCE;
+			}
+			printer = xlog_printer_create_daily_file( file, rollover_sec, coalesce_size, latency_ms );
 		} break;
 		case XLOG_PRINTER_RINGBUF: {
 			size_t capacity = va_arg( ap, size_t );
-			printer = xlog_printer_create_ringbuf( capacity );
+			printer = xlog_printer_create_ringbuf( capacity, rb_options );
+		} break;
+		case XLOG_PRINTER_SHMRING: {
+			const char *name = va_arg( ap, const char * );
+			size_t capacity = va_arg( ap, size_t );
+			unsigned int timeout_ms = 0;
+			int shm_options = RINGBUF_OLOCKFREE;
+			switch( XLOG_PRINTER_OVERFLOW_GET( options ) ) {
+				case XLOG_PRINTER_OVERFLOW_TIMEOUT: {
+					timeout_ms = va_arg( ap, unsigned int );
+					shm_options |= RINGBUF_OTIMEOUT;
+				} break;
+				case XLOG_PRINTER_OVERFLOW_DROP_NEW:
+				case XLOG_PRINTER_OVERFLOW_DROP_OLD:
+				case XLOG_PRINTER_OVERFLOW_OVERWRITE: {
+					/* NOTE: evicting is NOT lock-free, records of other processes are NOT evicted */
+					shm_options |= RINGBUF_ODROP_NEW;
+				} break;
+			}
+			printer = xlog_printer_create_shmring( name, capacity, shm_options, timeout_ms );
+		} break;
+		case XLOG_PRINTER_FILES_MAPPED: {
+			const char *file = va_arg( ap, const char * );
+			size_t capacity = va_arg( ap, size_t );
+			printer = xlog_printer_create_mapped_file( file, capacity );
 		} break;
 		default: {
 			printer = NULL;
@@ -259,16 +1020,38 @@ XLOG_PUBLIC( xlog_printer_t * ) xlog_printer_create( int options, ... )
 		__XLOG_TRACE( "Magic after created is 0x%X.", printer->magic );
 		printer->magic = XLOG_MAGIC_PRINTER;
 		#endif
+		printer->abiclr = 0;
+		xlog_printer_abiclr( printer );
 		switch( buff_type ) {
 			case XLOG_PRINTER_BUFF_NCPYRBUF:
-			case XLOG_PRINTER_BUFF_RINGBUF: {
+			case XLOG_PRINTER_BUFF_RINGBUF:
+			case XLOG_PRINTER_BUFF_DEFERRED: {
 				size_t rb_capacity = va_arg( ap, size_t );
-				xlog_printer_t *buffprinter = __buffering_printer_create( rb_capacity, printer );
+				if( buff_type == XLOG_PRINTER_BUFF_DEFERRED && rb_capacity < 2 * XLOG_LIMIT_DEFERRED_RECORD ) {
+					__XLOG_TRACE( "Capacity too small for deferred records, enlarged." );
+					rb_capacity = 2 * XLOG_LIMIT_DEFERRED_RECORD;
+				}
+				int overflow = XLOG_PRINTER_OVERFLOW_GET( options );
+				unsigned int timeout_ms = overflow == XLOG_PRINTER_OVERFLOW_TIMEOUT ? va_arg( ap, unsigned int ) : 0;
+				if( buff_type == XLOG_PRINTER_BUFF_NCPYRBUF && ( overflow == XLOG_PRINTER_OVERFLOW_DROP_OLD || overflow == XLOG_PRINTER_OVERFLOW_OVERWRITE ) ) {
+					__XLOG_TRACE( "Evicting pointers leaks payloads, drop the newest instead." );
+					overflow = XLOG_PRINTER_OVERFLOW_DROP_NEW;
+				}
+				switch( overflow ) {
+					case XLOG_PRINTER_OVERFLOW_TIMEOUT: rb_options |= RINGBUF_OTIMEOUT; break;
+					case XLOG_PRINTER_OVERFLOW_DROP_NEW: rb_options |= RINGBUF_ODROP_NEW; break;
+					case XLOG_PRINTER_OVERFLOW_DROP_OLD:
+					case XLOG_PRINTER_OVERFLOW_OVERWRITE: rb_options |= RINGBUF_ODROP_OLD; break;
+				}
+				xlog_printer_t *buffprinter = __buffering_printer_create(
+					buff_type, options, rb_capacity, rb_options, timeout_ms, overflow == XLOG_PRINTER_OVERFLOW_OVERWRITE, printer
+				);
 				if( buffprinter ) {
 					#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
 					buffprinter->magic = XLOG_MAGIC_PRINTER;
 					#endif
-					buffprinter->options = XLOG_PRINTER_BUFF_NCPYRBUF;
+					buffprinter->options = buff_type;
+					buffprinter->abiclr = printer->abiclr;
 					printer = buffprinter;
 				} else {
 					__XLOG_TRACE( "Failed to create buffering-printer." );
@@ -302,12 +1085,16 @@ XLOG_PUBLIC( int ) xlog_printer_destory( xlog_printer_t *printer )
 	__XLOG_TRACE( "buffering = %d.", buff_type );
 	switch( buff_type ) {
 		case XLOG_PRINTER_BUFF_NCPYRBUF:
-		case XLOG_PRINTER_BUFF_RINGBUF: {
+		case XLOG_PRINTER_BUFF_RINGBUF:
+		case XLOG_PRINTER_BUFF_DEFERRED: {
 			__XLOG_TRACE( "Destory buffering context." );
 			struct __printer_ringbuf_context *bufctx = (struct __printer_ringbuf_context *)printer->context;
+			#if (defined XLOG_POLICY_ENABLE_RUNTIME_SAFE)
+			printer->magic = 0;
+			#endif
+			XLOG_FREE( printer );
 			printer = bufctx->printer;
 			__buffering_context_destory_ringbuf( bufctx );
-			bufctx->printer = NULL;
 		} break;
 	}
 	
@@ -330,6 +1117,10 @@ XLOG_PUBLIC( int ) xlog_printer_destory( xlog_printer_t *printer )
 		case XLOG_PRINTER_RINGBUF: {
 			xlog_printer_destory_ringbuf( printer );
 		} break;
+		case XLOG_PRINTER_SHMRING:
+		case XLOG_PRINTER_FILES_MAPPED: {
+			xlog_printer_destory_mapped_ringbuf( printer );
+		} break;
 		default: {
 			__XLOG_TRACE( "unkown printer type(0x%X).", type );
 			return EINVAL;
@@ -339,6 +1130,30 @@ XLOG_PUBLIC( int ) xlog_printer_destory( xlog_printer_t *printer )
 	return 0;
 }
 
+/**
+ * @brief  append data of known length to printer
+ *
+ * @param  printer, printer to append
+ *         data/length, data to append
+ *         level, level of record, XLOG_LEVEL_SILENT if unknown
+ *         ts, time of record, NULL if unknown
+ * @return length appended, or result of printer.
+ *
+ */
+XLOG_PUBLIC( int ) xlog_printer_append(
+	xlog_printer_t *printer, const void *data, size_t length, int level, const struct timespec *ts
+)
+{
+	XLOG_ASSERT( printer );
+	if( printer->appendl ) {
+		return printer->appendl( printer, data, length, level, ts );
+	}
+	/* NOTE: length unknown to printer, text terminated as before */
+	XLOG_ASSERT( XLOG_PRINTER_BUFF_GET( printer->options ) == XLOG_PRINTER_BUFF_NONE );
+	
+	return printer->append( printer, ( void * )data );
+}
+
 /**
  * @brief  print TEXT compatible autobuf
  *
@@ -354,7 +1169,7 @@ XLOG_PUBLIC( int ) _xlog_printer_print_TEXT(
 	XLOG_ASSERT( autobuf );
 	XLOG_ASSERT( AUTOBUF_TEXT_COMPATIBLE( autobuf->options ) );
 	
-	return printer->append( printer, ( void * )autobuf_data_vptr( autobuf ) );
+	return xlog_printer_append( printer, autobuf_data_vptr( autobuf ), autobuf->offset, XLOG_LEVEL_SILENT, NULL );
 }
 
 static void hexdump_printline( uintmax_t cursor, const char *dumpline, void *arg )
@@ -362,11 +1177,11 @@ static void hexdump_printline( uintmax_t cursor, const char *dumpline, void *arg
 	xlog_printer_t *printer = ( xlog_printer_t * )arg;
 	
 	char buffer[128];
-	snprintf(
+	int length = snprintf(
 		buffer, sizeof( buffer ),
 		"%5jx%03jx  %s\n", cursor >> 12, cursor & 0xFFF, dumpline
 	);
-	printer->append( printer, buffer );
+	xlog_printer_append( printer, buffer, length < sizeof( buffer ) ? length : sizeof( buffer ) - 1, XLOG_LEVEL_SILENT, NULL );
 }
 
 static int hexdump_memory_readline( const void *addr, off_t offset, void *buffer, size_t size )
@@ -410,6 +1225,29 @@ XLOG_PUBLIC( int ) _xlog_printer_print_BINARY(
 	return length;
 }
 
+/**
+ * @brief  output autobuf to printer, autobuf is still owned by caller
+ *
+ * @param  printer, printer to print the autobuf
+ *         autobuf, autobuf object to print
+ * @return length of printed autobuf data
+ *
+ * @note   NOT for no-copy-buffering printer, use xlog_printer_take_over_autobuf instead
+ *
+ */
+XLOG_PUBLIC( int ) xlog_printer_print_autobuf(
+	xlog_printer_t *printer, autobuf_t **autobuf
+)
+{
+	int buff_type = XLOG_PRINTER_BUFF_GET( printer->options );
+	XLOG_ASSERT( buff_type != XLOG_PRINTER_BUFF_NCPYRBUF );
+	if( buff_type == XLOG_PRINTER_BUFF_NONE ) {
+		return xlog_printer_append( printer, autobuf_data_vptr( *autobuf ), ( *autobuf )->offset, XLOG_LEVEL_SILENT, NULL );
+	} else {
+		return printer->append( printer, autobuf );
+	}
+}
+
 /**
  * @brief  output and destory autobuf to printer
  *
@@ -426,7 +1264,7 @@ XLOG_PUBLIC( int ) xlog_printer_take_over_autobuf(
 {
 	int buff_type = XLOG_PRINTER_BUFF_GET( printer->options );
 	if( buff_type == XLOG_PRINTER_BUFF_NONE ) {
-		int length = printer->append( printer, autobuf_data_vptr( *autobuf ) );
+		int length = xlog_printer_append( printer, autobuf_data_vptr( *autobuf ), ( *autobuf )->offset, XLOG_LEVEL_SILENT, NULL );
 		autobuf_destory( autobuf );
 		return length;
 	} else {
@@ -29,6 +29,12 @@ typedef struct {
 	int f_list;
 	int f_list_options;
 	
+	int f_callsite;
+	int f_sites;
+	int control;
+	xlog_callsite_match_t match;
+	char file[256];
+	
 	int exit_code;
 	jmp_buf exit_jmp;
 } xlog_shell_globals_t;
@@ -37,6 +43,13 @@ typedef struct {
 #define LOG_CLI_OPT_ONLY		(LOG_CLI_OPT_BASE + 1)
 #define LOG_CLI_OPT_WITH_TAG	(LOG_CLI_OPT_BASE + 2)
 #define LOG_CLI_OPT_WITHOUT_TAG	(LOG_CLI_OPT_BASE + 3)
+#define LOG_CLI_OPT_FILE		(LOG_CLI_OPT_BASE + 4)
+#define LOG_CLI_OPT_FUNC		(LOG_CLI_OPT_BASE + 5)
+#define LOG_CLI_OPT_FORMAT		(LOG_CLI_OPT_BASE + 6)
+#define LOG_CLI_OPT_ON			(LOG_CLI_OPT_BASE + 7)
+#define LOG_CLI_OPT_OFF			(LOG_CLI_OPT_BASE + 8)
+#define LOG_CLI_OPT_RESET		(LOG_CLI_OPT_BASE + 9)
+#define LOG_CLI_OPT_SITES		(LOG_CLI_OPT_BASE + 10)
 
 static const struct option debug_options[] = {
 	{ "force"			, no_argument		, NULL	, 'f'						},
@@ -47,6 +60,13 @@ static const struct option debug_options[] = {
 	{ "only"			, no_argument		, NULL	, LOG_CLI_OPT_ONLY			},
 	{ "tag"				, no_argument		, NULL	, LOG_CLI_OPT_WITH_TAG		},
 	{ "no-tag"			, no_argument		, NULL	, LOG_CLI_OPT_WITHOUT_TAG	},
+	{ "file"			, required_argument	, NULL	, LOG_CLI_OPT_FILE			},
+	{ "func"			, required_argument	, NULL	, LOG_CLI_OPT_FUNC			},
+	{ "format"			, required_argument	, NULL	, LOG_CLI_OPT_FORMAT		},
+	{ "on"				, no_argument		, NULL	, LOG_CLI_OPT_ON			},
+	{ "off"				, no_argument		, NULL	, LOG_CLI_OPT_OFF			},
+	{ "reset"			, no_argument		, NULL	, LOG_CLI_OPT_RESET			},
+	{ "sites"			, no_argument		, NULL	, LOG_CLI_OPT_SITES			},
 	{ "version"			, no_argument		, NULL	, 'v'						},
 	{ "help"			, no_argument		, NULL	, 'h'						},
 	{ NULL				, 0					, NULL	, '\0'						}
@@ -64,7 +84,7 @@ static void usage( xlog_shell_globals_t *globals )
 {
 	( void )fprintf(
 		stderr,
-		"Usage: debug [OPTIONS] MODULE[/SUB-MODULE/...]\n"
+		"Usage: debug [OPTIONS] [MODULE[/SUB-MODULE/...]]\n"
 		"\n"
 		"Mandatory arguments to long options are mandatory for short options too.\n"
 		"  -f, --force        Update module's paramters forcibly,\n"
@@ -76,6 +96,13 @@ static void usage( xlog_shell_globals_t *globals )
 		"  -l, --list         List modules in your application.\n"
 		"  -a, --all          Show all modules, include the hidden.\n"
 		"      --only         Only enable output of specified modules(disabling will be applied to other modules).\n"
+		"      --file=FILE[:LINE]  Select call-sites by source file(path suffix) and line.\n"
+		"      --func=FUNC    Select call-sites by function.\n"
+		"      --format=TEXT  Select call-sites by substring of format.\n"
+		"      --on           Enable call-sites selected regardless of module's level(default).\n"
+		"      --off          Disable call-sites selected.\n"
+		"      --reset        Make call-sites selected(all if no selector) follow module's level again.\n"
+		"      --sites        List call-sites selected.\n"
 		"  -v, --version      Show version of logger.\n"
 		"  -h, --help         Display this help and exit.\n"
 		"\n"
@@ -93,6 +120,7 @@ static int main_debug( xlog_shell_globals_t *globals, int argc, char **argv )
 	globals->level = XLOG_LEVEL_DEBUG;
 	globals->f_force = 1;
 	globals->f_list_options = XLOG_LIST_OWITH_TAG;
+	globals->control = XLOG_CALLSITE_CTRL_ON;
 	
 	while( (
 		ch = getopt_long_r(
@@ -161,6 +189,39 @@ static int main_debug( xlog_shell_globals_t *globals, int argc, char **argv )
 			case LOG_CLI_OPT_ONLY:
 				globals->f_only = 1;
 				break;
+			case LOG_CLI_OPT_FILE: {
+				snprintf( globals->file, sizeof( globals->file ), "%s", getopt_reent.optarg );
+				char *colon = strrchr( globals->file, ':' );
+				if( colon ) {
+					*colon = '\0';
+					globals->match.line = atol( colon + 1 );
+				}
+				globals->match.file = globals->file;
+				globals->f_callsite = 1;
+			} break;
+			case LOG_CLI_OPT_FUNC:
+				globals->match.func = getopt_reent.optarg;
+				globals->f_callsite = 1;
+				break;
+			case LOG_CLI_OPT_FORMAT:
+				globals->match.format = getopt_reent.optarg;
+				globals->f_callsite = 1;
+				break;
+			case LOG_CLI_OPT_ON:
+				globals->control = XLOG_CALLSITE_CTRL_ON;
+				globals->f_callsite = 1;
+				break;
+			case LOG_CLI_OPT_OFF:
+				globals->control = XLOG_CALLSITE_CTRL_OFF;
+				globals->f_callsite = 1;
+				break;
+			case LOG_CLI_OPT_RESET:
+				globals->control = XLOG_CALLSITE_CTRL_DEFAULT;
+				globals->f_callsite = 1;
+				break;
+			case LOG_CLI_OPT_SITES:
+				globals->f_sites = 1;
+				break;
 			default:
 				exit( EXIT_FAILURE );
 				break;
@@ -176,6 +237,17 @@ static int main_debug( xlog_shell_globals_t *globals, int argc, char **argv )
 		exit( EXIT_SUCCESS );
 	}
 	
+	if( globals->f_sites ) {
+		log_r( "Call-sites in your application:\n" );
+		xlog_callsite_list( &globals->match );
+		log_r( "\n" );
+		exit( EXIT_SUCCESS );
+	}
+	
+	if( globals->f_callsite ) {
+		exit( xlog_callsite_control( &globals->match, globals->control ) );
+	}
+	
 	int flags = 0;
 	if( globals->f_recursive ) {
 		flags |= XLOG_LEVEL_ORECURSIVE;
@@ -208,7 +280,7 @@ static int main_debug( xlog_shell_globals_t *globals, int argc, char **argv )
 }
 
 /*
- * Usage: debug [OPTIONS] MODULE[/SUB-MODULE/...]
+ * Usage: debug [OPTIONS] [MODULE[/SUB-MODULE/...]]
  *
  * Mandatory arguments to long options are mandatory for short options too.
  *   -f, --force        Update module's paramters forcibly,
@@ -220,6 +292,13 @@ static int main_debug( xlog_shell_globals_t *globals, int argc, char **argv )
  *   -l, --list         List modules in your application.
  *   -a, --all          Show all modules, include the hidden.
  *       --only         Only enable output of specified modules(disabling will be applied to other modules).
+ *       --file=FILE[:LINE]  Select call-sites by source file(path suffix) and line.
+ *       --func=FUNC    Select call-sites by function.
+ *       --format=TEXT  Select call-sites by substring of format.
+ *       --on           Enable call-sites selected regardless of module's level(default).
+ *       --off          Disable call-sites selected.
+ *       --reset        Make call-sites selected(all if no selector) follow module's level again.
+ *       --sites        List call-sites selected.
  *   -v, --version      Show version of logger.
  *   -h, --help         Display this help and exit.
  */